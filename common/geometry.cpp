@@ -161,6 +161,49 @@ carve::mesh::MeshSet<3>* makeDoubleCube(const carve::math::Matrix& transform) {
   return data.createMesh(carve::input::opts());
 }
 
+void makeSphereData(carve::input::PolyhedronData& data, int slices,
+                    int stacks, bool triangles,
+                    const carve::math::Matrix& transform) {
+  data.reserveVertices((stacks - 1) * slices + 2);
+
+  data.addVertex(transform * carve::geom::VECTOR(0.0, 0.0, +1.0));
+  for (int i = 1; i < stacks; ++i) {
+    double phi = M_PI * i / stacks;
+    for (int j = 0; j < slices; ++j) {
+      double theta = 2.0 * M_PI * j / slices;
+      data.addVertex(transform * carve::geom::VECTOR(sin(phi) * cos(theta),
+                                                     sin(phi) * sin(theta),
+                                                     cos(phi)));
+    }
+  }
+  data.addVertex(transform * carve::geom::VECTOR(0.0, 0.0, -1.0));
+
+  const int bottom = 1 + (stacks - 1) * slices;
+  for (int j = 0; j < slices; ++j) {
+    int j1 = (j + 1) % slices;
+    data.addFace(0, 1 + j, 1 + j1);
+    for (int i = 1; i < stacks - 1; ++i) {
+      int a = 1 + (i - 1) * slices;
+      int b = 1 + i * slices;
+      if (triangles) {
+        data.addFace(a + j, b + j, b + j1);
+        data.addFace(a + j, b + j1, a + j1);
+      } else {
+        data.addFace(a + j, b + j, b + j1, a + j1);
+      }
+    }
+    int a = 1 + (stacks - 2) * slices;
+    data.addFace(a + j, bottom, a + j1);
+  }
+}
+
+carve::mesh::MeshSet<3>* makeSphere(int slices, int stacks, bool triangles,
+                                    const carve::math::Matrix& transform) {
+  carve::input::PolyhedronData data;
+  makeSphereData(data, slices, stacks, triangles, transform);
+  return data.createMesh(carve::input::opts());
+}
+
 carve::mesh::MeshSet<3>* makeTorus(int slices, int rings, double rad1,
                                    double rad2,
                                    const carve::math::Matrix& transform) {
@@ -250,3 +293,11 @@ carve::mesh::MeshSet<3>* makeCone(int slices, double rad, double height,
 
   return data.createMesh(carve::input::opts());
 }
+
+double volume(const carve::mesh::MeshSet<3>* poly) {
+  double vol = 0.0;
+  for (size_t i = 0; i < poly->meshes.size(); ++i) {
+    vol += poly->meshes[i]->volume();
+  }
+  return vol;
+}
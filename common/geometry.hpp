@@ -25,6 +25,7 @@
 #pragma once
 
 #include <carve/carve.hpp>
+#include <carve/input.hpp>
 
 #include <carve/matrix.hpp>
 #include <carve/poly.hpp>
@@ -45,6 +46,18 @@ carve::mesh::MeshSet<3>* makeSubdividedCube(
 carve::mesh::MeshSet<3>* makeDoubleCube(
     const carve::math::Matrix& transform = carve::math::Matrix());
 
+// A unit UV sphere with slices x stacks cells. The cells at the
+// poles are triangles, and the others are quads, or pairs of
+// triangles if triangles is set.
+void makeSphereData(carve::input::PolyhedronData& data, int slices,
+                    int stacks, bool triangles = false,
+                    const carve::math::Matrix& transform =
+                        carve::math::Matrix());
+
+carve::mesh::MeshSet<3>* makeSphere(
+    int slices, int stacks, bool triangles = false,
+    const carve::math::Matrix& transform = carve::math::Matrix());
+
 carve::mesh::MeshSet<3>* makeTorus(
     int slices, int rings, double rad1, double rad2,
     const carve::math::Matrix& transform = carve::math::Matrix());
@@ -56,3 +69,6 @@ carve::mesh::MeshSet<3>* makeCylinder(
 carve::mesh::MeshSet<3>* makeCone(
     int slices, double rad, double height,
     const carve::math::Matrix& transform = carve::math::Matrix());
+
+// The total volume of the meshes of poly.
+double volume(const carve::mesh::MeshSet<3>* poly);
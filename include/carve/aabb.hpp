@@ -134,6 +134,44 @@ double distance2(const aabb<3>& a, const vector<ndim>& v);
 template <unsigned ndim>
 double distance(const aabb<3>& a, const vector<ndim>& v);
 
+template <unsigned ndim>
+double distance2(const aabb<ndim>& a, const aabb<ndim>& b);
+
+template <unsigned ndim>
+double distance(const aabb<ndim>& a, const aabb<ndim>& b);
+
+// A set of AABBs stored as structure of arrays, so that one box can
+// be tested against many at once.
+template <unsigned ndim>
+struct aabb_packet {
+  std::vector<double> pos[ndim];
+  std::vector<double> extent[ndim];
+
+  size_t size() const { return pos[0].size(); }
+  bool empty() const { return pos[0].empty(); }
+
+  void clear();
+  void reserve(size_t n);
+  void push_back(const aabb<ndim>& a);
+  aabb<ndim> get(size_t i) const;
+};
+
+// result[i] = packet.get(i).maxAxisSeparation(a).
+template <unsigned ndim>
+void maxAxisSeparation(const aabb<ndim>& a, const aabb_packet<ndim>& packet,
+                       double* result);
+
+// result[i] = packet.get(i).maxAxisSeparation(a) <= tolerance. Returns
+// the number of boxes that intersect a.
+template <unsigned ndim>
+size_t intersects(const aabb<ndim>& a, const aabb_packet<ndim>& packet,
+                  bool* result, double tolerance = 0.0);
+
+// result[i] = boxes[i].intersects(a).
+template <unsigned ndim>
+size_t intersects(const aabb<ndim>& a, const aabb<ndim>* boxes, size_t n,
+                  bool* result);
+
 template <unsigned ndim, typename obj_t>
 struct get_aabb {
   aabb<ndim> operator()(const obj_t& obj) const { return obj.getAABB(); }
@@ -33,6 +33,13 @@
 
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 namespace carve {
 namespace geom {
 
@@ -372,6 +379,23 @@ double distance(const aabb<3>& a, const vector<ndim>& v) {
   return ::sqrt(distance2(a, v));
 }
 
+template <unsigned ndim>
+double distance2(const aabb<ndim>& a, const aabb<ndim>& b) {
+  double d2 = 0.0;
+  for (unsigned i = 0; i < ndim; ++i) {
+    double d = a.axisSeparation(b, i);
+    if (d > 0.0) {
+      d2 += d * d;
+    }
+  }
+  return d2;
+}
+
+template <unsigned ndim>
+double distance(const aabb<ndim>& a, const aabb<ndim>& b) {
+  return ::sqrt(distance2(a, b));
+}
+
 template <>
 inline bool aabb<3>::intersects(const ray<3>& ray) const {
   vector<3> t = pos - ray.v;
@@ -522,5 +546,189 @@ inline bool aabb<3>::intersects(tri<3> tri) const {
 
   return true;
 }
+
+#if defined(__SSE2__)
+// SSE2 versions of the aabb<3> operations used in R-tree
+// construction. The x and y components are handled as a pair, z on
+// its own. Operand order follows std::min/std::max so that the
+// results are identical to the generic versions. (intersects() is
+// left generic: the scalar version compiles to branch-free code that
+// is faster than the equivalent vector test.)
+static inline __m128d aabb3_xy(const vector<3>& v) {
+  return _mm_loadu_pd(v.v);
+}
+
+static inline __m128d aabb3_z(const vector<3>& v) {
+  return _mm_load_sd(v.v + 2);
+}
+
+static inline void aabb3_set(aabb<3>& a, __m128d min_xy, __m128d min_z,
+                             __m128d max_xy, __m128d max_z) {
+  const __m128d half = _mm_set1_pd(0.5);
+  const __m128d pos_xy = _mm_mul_pd(_mm_add_pd(min_xy, max_xy), half);
+  const __m128d pos_z = _mm_mul_sd(_mm_add_sd(min_z, max_z), half);
+  const __m128d ext_xy =
+      _mm_max_pd(_mm_sub_pd(pos_xy, min_xy), _mm_sub_pd(max_xy, pos_xy));
+  const __m128d ext_z =
+      _mm_max_sd(_mm_sub_sd(pos_z, min_z), _mm_sub_sd(max_z, pos_z));
+  _mm_storeu_pd(a.pos.v, pos_xy);
+  _mm_store_sd(a.pos.v + 2, pos_z);
+  _mm_storeu_pd(a.extent.v, ext_xy);
+  _mm_store_sd(a.extent.v + 2, ext_z);
+}
+
+template <>
+inline void aabb<3>::fit(const vector_t& v1, const vector_t& v2) {
+  const __m128d a_xy = aabb3_xy(v1), a_z = aabb3_z(v1);
+  const __m128d b_xy = aabb3_xy(v2), b_z = aabb3_z(v2);
+  aabb3_set(*this, _mm_min_pd(b_xy, a_xy), _mm_min_sd(b_z, a_z),
+            _mm_max_pd(b_xy, a_xy), _mm_max_sd(b_z, a_z));
+}
+
+template <>
+inline void aabb<3>::fit(const vector_t& v1, const vector_t& v2,
+                         const vector_t& v3) {
+  const __m128d a_xy = aabb3_xy(v1), a_z = aabb3_z(v1);
+  const __m128d b_xy = aabb3_xy(v2), b_z = aabb3_z(v2);
+  const __m128d c_xy = aabb3_xy(v3), c_z = aabb3_z(v3);
+  __m128d min_xy = _mm_min_pd(b_xy, a_xy), min_z = _mm_min_sd(b_z, a_z);
+  __m128d max_xy = _mm_max_pd(b_xy, a_xy), max_z = _mm_max_sd(b_z, a_z);
+  min_xy = _mm_min_pd(c_xy, min_xy);
+  min_z = _mm_min_sd(c_z, min_z);
+  max_xy = _mm_max_pd(c_xy, max_xy);
+  max_z = _mm_max_sd(c_z, max_z);
+  aabb3_set(*this, min_xy, min_z, max_xy, max_z);
+}
+
+template <>
+inline void aabb<3>::unionAABB(const aabb<3>& a) {
+  const __m128d p_xy = aabb3_xy(pos), p_z = aabb3_z(pos);
+  const __m128d e_xy = aabb3_xy(extent), e_z = aabb3_z(extent);
+  const __m128d ap_xy = aabb3_xy(a.pos), ap_z = aabb3_z(a.pos);
+  const __m128d ae_xy = aabb3_xy(a.extent), ae_z = aabb3_z(a.extent);
+  aabb3_set(*this,
+            _mm_min_pd(_mm_sub_pd(ap_xy, ae_xy), _mm_sub_pd(p_xy, e_xy)),
+            _mm_min_sd(_mm_sub_sd(ap_z, ae_z), _mm_sub_sd(p_z, e_z)),
+            _mm_max_pd(_mm_add_pd(ap_xy, ae_xy), _mm_add_pd(p_xy, e_xy)),
+            _mm_max_sd(_mm_add_sd(ap_z, ae_z), _mm_add_sd(p_z, e_z)));
+}
+#endif
+
+template <unsigned ndim>
+void aabb_packet<ndim>::clear() {
+  for (unsigned i = 0; i < ndim; ++i) {
+    pos[i].clear();
+    extent[i].clear();
+  }
+}
+
+template <unsigned ndim>
+void aabb_packet<ndim>::reserve(size_t n) {
+  for (unsigned i = 0; i < ndim; ++i) {
+    pos[i].reserve(n);
+    extent[i].reserve(n);
+  }
+}
+
+template <unsigned ndim>
+void aabb_packet<ndim>::push_back(const aabb<ndim>& a) {
+  for (unsigned i = 0; i < ndim; ++i) {
+    pos[i].push_back(a.pos.v[i]);
+    extent[i].push_back(a.extent.v[i]);
+  }
+}
+
+template <unsigned ndim>
+aabb<ndim> aabb_packet<ndim>::get(size_t i) const {
+  aabb<ndim> a;
+  for (unsigned j = 0; j < ndim; ++j) {
+    a.pos.v[j] = pos[j][i];
+    a.extent.v[j] = extent[j][i];
+  }
+  return a;
+}
+
+template <unsigned ndim>
+static inline double aabb_packet_separation(const aabb<ndim>& a,
+                                            const aabb_packet<ndim>& packet,
+                                            size_t i) {
+  double m = fabs(a.pos.v[0] - packet.pos[0][i]) - packet.extent[0][i] -
+             a.extent.v[0];
+  for (unsigned j = 1; j < ndim; ++j) {
+    m = std::max(m, fabs(a.pos.v[j] - packet.pos[j][i]) - packet.extent[j][i] -
+                        a.extent.v[j]);
+  }
+  return m;
+}
+
+#if defined(__AVX__)
+// Separations of a from packet boxes i..i+3.
+template <unsigned ndim>
+static inline __m256d aabb_packet_separation4(const aabb<ndim>& a,
+                                              const aabb_packet<ndim>& packet,
+                                              size_t i) {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d m = _mm256_setzero_pd();
+  for (unsigned j = 0; j < ndim; ++j) {
+    const __m256d d = _mm256_sub_pd(_mm256_set1_pd(a.pos.v[j]),
+                                    _mm256_loadu_pd(&packet.pos[j][i]));
+    const __m256d s = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_andnot_pd(sign, d),
+                      _mm256_loadu_pd(&packet.extent[j][i])),
+        _mm256_set1_pd(a.extent.v[j]));
+    m = j ? _mm256_max_pd(s, m) : s;
+  }
+  return m;
+}
+#endif
+
+template <unsigned ndim>
+void maxAxisSeparation(const aabb<ndim>& a, const aabb_packet<ndim>& packet,
+                       double* result) {
+  const size_t n = packet.size();
+  size_t i = 0;
+#if defined(__AVX__)
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(result + i, aabb_packet_separation4(a, packet, i));
+  }
+#endif
+  for (; i < n; ++i) {
+    result[i] = aabb_packet_separation(a, packet, i);
+  }
+}
+
+template <unsigned ndim>
+size_t intersects(const aabb<ndim>& a, const aabb_packet<ndim>& packet,
+                  bool* result, double tolerance) {
+  const size_t n = packet.size();
+  size_t i = 0, count = 0;
+#if defined(__AVX__)
+  const __m256d tol = _mm256_set1_pd(tolerance);
+  for (; i + 4 <= n; i += 4) {
+    const int mask = _mm256_movemask_pd(
+        _mm256_cmp_pd(aabb_packet_separation4(a, packet, i), tol, _CMP_LE_OQ));
+    for (int k = 0; k < 4; ++k) {
+      result[i + k] = (mask >> k) & 1;
+      count += result[i + k];
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    result[i] = aabb_packet_separation(a, packet, i) <= tolerance;
+    count += result[i];
+  }
+  return count;
+}
+
+template <unsigned ndim>
+size_t intersects(const aabb<ndim>& a, const aabb<ndim>* boxes, size_t n,
+                  bool* result) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = boxes[i].intersects(a);
+    count += result[i];
+  }
+  return count;
+}
 }  // namespace geom
 }  // namespace carve
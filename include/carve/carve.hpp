@@ -40,6 +40,7 @@
 
 #include <math.h>
 
+#include <exception>
 #include <iomanip>
 #include <list>
 #include <map>
@@ -171,6 +172,101 @@ static inline void setEpsilon(double ep) {
   EPSILON2 = ep * ep;
 }
 
+/**
+ * \brief How the orientation predicates carve::geom2d::orient2d() and
+ * carve::geom3d::orient3d() are evaluated.
+ */
+enum PredicateMode {
+  PREDICATES_FAST = 0,    /**< Plain floating point; fast, but the sign
+                             is unreliable for near-degenerate input. */
+  PREDICATES_FILTERED = 1, /**< Floating point with an error bound
+                              filter, falling back to Shewchuk's adaptive
+                              exact arithmetic when the filter fails. */
+  PREDICATES_INTEGER = 2   /**< Points that lie on the snapping grid
+                              (see GRID_BITS) are evaluated exactly in
+                              integer arithmetic; other points as for
+                              PREDICATES_FILTERED. */
+};
+
+/**
+ * \brief Resolution of the snapping grid used with PREDICATES_INTEGER:
+ * grid points are multiples of 2^-GRID_BITS in [-1, 1], which is the
+ * range that carve::rescale maps coordinates into.
+ */
+static const int GRID_BITS = 40;
+
+/**
+ * \brief The predicate mode of the calling thread.
+ *
+ * Each thread has its own mode, so that CSG operations running
+ * concurrently can install different modes. Work handed to other
+ * threads must install the caller's mode itself (see
+ * PredicateModeScope).
+ */
+extern thread_local PredicateMode predicate_mode;
+
+static inline void setPredicateMode(PredicateMode mode) {
+  predicate_mode = mode;
+}
+
+/**
+ * \brief Installs a predicate mode for the calling thread, restoring
+ * the previous one on scope exit.
+ */
+struct PredicateModeScope {
+  PredicateMode saved;
+
+  PredicateModeScope(PredicateMode mode) : saved(predicate_mode) {
+    setPredicateMode(mode);
+  }
+  ~PredicateModeScope() { setPredicateMode(saved); }
+
+ private:
+  PredicateModeScope(const PredicateModeScope&);
+  PredicateModeScope& operator=(const PredicateModeScope&);
+};
+
+/**
+ * \brief Carries an exception out of an OpenMP parallel loop.
+ *
+ * An exception that escapes a parallel region terminates the process,
+ * and CARVE_ASSERT and CARVE_FAIL throw. The body of such a loop
+ * catches everything and calls capture(), which keeps the first
+ * exception thrown on any thread; once the loop has finished,
+ * rethrow() throws it again on the calling thread.
+ */
+class ParallelExceptionCapture {
+  std::exception_ptr error;
+
+  ParallelExceptionCapture(const ParallelExceptionCapture&);
+  ParallelExceptionCapture& operator=(const ParallelExceptionCapture&);
+
+ public:
+  ParallelExceptionCapture() : error() {}
+
+  /**
+   * \brief Keeps the exception being handled, unless one has already
+   * been kept. Call from within a catch block.
+   */
+  void capture() {
+#if defined(_OPENMP)
+#pragma omp critical(carve_parallel_exception)
+#endif
+    if (!error) {
+      error = std::current_exception();
+    }
+  }
+
+  /**
+   * \brief Throws the kept exception, if there is one.
+   */
+  void rethrow() const {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
 template <typename T>
 struct identity_t {
   typedef T argument_type;
@@ -0,0 +1,116 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <carve/aabb.hpp>
+#include <carve/geom.hpp>
+#include <carve/mesh.hpp>
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace carve {
+namespace mesh {
+
+// Compact, read-mostly storage for very large polygonal meshes.
+//
+// Vertex coordinates are held as float32 and faces as a flat index
+// list, so a triangle mesh costs roughly 6 bytes per triangle for
+// its vertices and 16 for its faces, against ~250 bytes per triangle
+// for a MeshSet<3> with its half-edge structure and cached planes.
+//
+// Coordinates are promoted to double on access: bounds, face planes
+// and the MeshSet<3> produced by toMeshSet() are computed in double
+// precision, so predicates, constructions and any intersection
+// vertices created by a CSG operation on the result are unaffected
+// by the compact storage. Only the input vertex positions themselves
+// are rounded, once, when they are stored.
+class CompactMeshSet {
+ public:
+  typedef carve::geom::vector<3> vector_t;
+
+  // xyz triples.
+  std::vector<float> coords;
+  // face f has vertices face_verts[face_start[f] .. face_start[f + 1]).
+  std::vector<uint32_t> face_start;
+  std::vector<uint32_t> face_verts;
+
+  CompactMeshSet();
+
+  // From points and face indices in the format accepted by the
+  // MeshSet<3> constructor.
+  CompactMeshSet(const std::vector<vector_t>& points, size_t n_faces,
+                 const std::vector<int>& face_indices);
+
+  explicit CompactMeshSet(const MeshSet<3>* mesh);
+
+  size_t vertexCount() const { return coords.size() / 3; }
+  size_t faceCount() const { return face_start.size() - 1; }
+
+  vector_t vertex(size_t i) const {
+    return carve::geom::VECTOR(coords[i * 3], coords[i * 3 + 1],
+                               coords[i * 3 + 2]);
+  }
+
+  size_t faceSize(size_t f) const {
+    return face_start[f + 1] - face_start[f];
+  }
+  const uint32_t* faceBegin(size_t f) const {
+    return face_verts.data() + face_start[f];
+  }
+  const uint32_t* faceEnd(size_t f) const {
+    return face_verts.data() + face_start[f + 1];
+  }
+
+  size_t addVertex(const vector_t& v);
+
+  template <typename iter_t>
+  void addFace(iter_t begin, iter_t end) {
+    for (; begin != end; ++begin) {
+      face_verts.push_back((uint32_t)*begin);
+    }
+    face_start.push_back((uint32_t)face_verts.size());
+  }
+
+  // The plane of face f, oriented by its winding as Face<3>::recalc()
+  // would orient it.
+  carve::geom::plane<3> facePlane(size_t f) const;
+
+  carve::geom::aabb<3> faceAABB(size_t f) const;
+
+  carve::geom::aabb<3> getAABB() const;
+
+  // Approximate heap usage in bytes.
+  size_t memoryUsage() const;
+
+  // Expand to a MeshSet<3> with double precision vertices. The
+  // caller owns the result.
+  MeshSet<3>* toMeshSet(const MeshOptions& opts = MeshOptions()) const;
+};
+}  // namespace mesh
+}  // namespace carve
@@ -31,6 +31,7 @@
 #include <carve/carve.hpp>
 
 #include <carve/geom3d.hpp>
+#include <carve/implicit_point.hpp>
 
 #include <carve/mesh.hpp>
 
@@ -94,6 +95,10 @@ class CSG {
                               const meshset_t::vertex_t* /* v1 */,
                               const meshset_t::vertex_t* /* v2 */) {}
 
+    /// Return true if processOutputFace() may be called concurrently
+    /// for different original faces.
+    virtual bool isThreadSafe() const { return false; }
+
     virtual ~Hook() {}
   };
 
@@ -121,6 +126,8 @@ class CSG {
 
     bool hasHook(unsigned hook_num);
 
+    bool isThreadSafe(unsigned hook_num);
+
     void intersectionVertex(const meshset_t::vertex_t* vertex,
                             const IObjPairSet& intersections);
 
@@ -179,6 +186,13 @@ class CSG {
   /// provides testing for pool membership.
   VertexPool vertex_pool;
 
+  /// The implicit forms of edge-face and edge-edge intersection
+  /// vertices, one for each edge the vertex was constructed on.
+  /// Populated only if implicit_intersections is set.
+  std::unordered_map<meshset_t::vertex_t*,
+                     std::vector<carve::geom3d::ImplicitPoint> >
+      implicit_vertices;
+
   void init();
 
   void makeVertexIntersections();
@@ -210,10 +224,27 @@ class CSG {
   void generateEdgeFaceIntersections(meshset_t::face_t* a,
                                      const std::vector<meshset_t::face_t*>& b);
 
+  /**
+   * \brief Generate candidate intersecting face pairs by dual traversal
+   * of the face R-trees of \a a and \a b. \a b_boxes is scratch space
+   * for the face boxes of a leaf of \a b, shared by the whole traversal.
+   */
   void generateIntersectionCandidates(meshset_t* a, const face_rtree_t* a_node,
                                       meshset_t* b, const face_rtree_t* b_node,
                                       face_pairs_t& face_pairs,
+                                      carve::geom::aabb_packet<3>& b_boxes,
                                       bool descend_a = true);
+
+  /**
+   * \brief Generate candidate intersecting face pairs by binning the
+   * faces of \a a and \a b into a uniform grid.
+   *
+   * @return false if the face sizes of the inputs are too varied
+   *         for a uniform grid to be effective, in which case \a
+   *         face_pairs is left untouched.
+   */
+  bool generateGridIntersectionCandidates(meshset_t* a, meshset_t* b,
+                                          face_pairs_t& face_pairs);
   /**
    * \brief Compute all points of intersection between poly \a a and poly \a b
    *
@@ -415,6 +446,53 @@ class CSG {
 
   CSG::Hooks hooks; /**< The manager for calculation hooks. */
 
+  /**
+   * \enum BROADPHASE_TYPE
+   * \brief The method used to find candidate pairs of intersecting faces.
+   */
+  enum BROADPHASE_TYPE {
+    BROADPHASE_RTREE, /**< Dual traversal of the face R-trees. */
+    BROADPHASE_GRID   /**< Uniform grid, sized from the edge length of
+                         the inputs. Falls back to BROADPHASE_RTREE
+                         if face sizes vary too much. */
+  };
+
+  BROADPHASE_TYPE broadphase; /**< Defaults to BROADPHASE_RTREE. */
+
+  /**
+   * \brief The predicate mode installed (as carve::predicate_mode)
+   * for the duration of compute(), slice() and sliceAndClassify().
+   * Initialised from the constructing thread's carve::predicate_mode.
+   */
+  carve::PredicateMode predicate_mode;
+
+  /**
+   * \brief If true, intersection vertices that coincide to within
+   * EPSILON are welded together after intersection, so that nearly
+   * coincident intersections split faces at a single vertex. Off by
+   * default.
+   */
+  bool weld_intersections;
+
+  /**
+   * \brief If true, edge-face and edge-edge intersection vertices
+   * also keep an implicit form (an edge and a plane). Their
+   * coordinates are rounded once from the implicit form, and the
+   * intersection vertices along each edge are ordered by exact
+   * predicates on it, rather than by their rounded coordinates. Off
+   * by default.
+   */
+  bool implicit_intersections;
+
+  /**
+   * \brief If true, the face loops that each triangular face of the
+   * inputs is divided into are triangulated as they are generated,
+   * constrained to the intersection edges that split the face. The
+   * result of an operation on triangle meshes is then a triangle
+   * mesh, without a triangulating output face hook. Off by default.
+   */
+  bool triangulate_face_loops;
+
   CSG();
   ~CSG();
 
@@ -34,11 +34,17 @@ namespace csg {
 namespace detail {
 template <bool with_improvement>
 class CarveTriangulator : public csg::CSG::Hook {
+  triangulate::TriangulationMethod method;
+
  public:
-  CarveTriangulator() {}
+  CarveTriangulator(
+      triangulate::TriangulationMethod _method = triangulate::EAR_CLIPPING)
+      : method(_method) {}
 
   ~CarveTriangulator() override {}
 
+  bool isThreadSafe() const override { return true; }
+
   void processOutputFace(std::vector<carve::mesh::MeshSet<3>::face_t*>& faces,
                          const carve::mesh::MeshSet<3>::face_t* orig,
                          bool flipped) override {
@@ -52,6 +58,12 @@ class CarveTriangulator : public csg::CSG::Hook {
 
     out_faces.reserve(n_tris);
 
+    // output faces may be processed concurrently, so each thread keeps
+    // its own triangulator, and reuses its storage from face to face.
+    static thread_local triangulate::Triangulator triangulator;
+    std::vector<triangulate::tri_idx> result;
+    std::vector<carve::mesh::MeshSet<3>::vertex_t*> vloop;
+
     for (size_t f = 0; f < faces.size(); ++f) {
       carve::mesh::MeshSet<3>::face_t* face = faces[f];
 
@@ -60,19 +72,13 @@ class CarveTriangulator : public csg::CSG::Hook {
         continue;
       }
 
-      std::vector<triangulate::tri_idx> result;
-
-      std::vector<carve::mesh::MeshSet<3>::vertex_t*> vloop;
       face->getVertices(vloop);
 
-      triangulate::triangulate(
-          carve::mesh::MeshSet<3>::face_t::projection_mapping(face->project),
-          vloop, result);
+      triangulator.triangulate(face->projector(), vloop, result, method);
 
       if (with_improvement) {
-        triangulate::improve(
-            carve::mesh::MeshSet<3>::face_t::projection_mapping(face->project),
-            vloop, carve::mesh::vertex_distance(), result);
+        triangulate::improve(face->projector(), vloop,
+                             carve::mesh::vertex_distance(), result);
       }
 
       std::vector<carve::mesh::MeshSet<3>::vertex_t*> fv;
@@ -99,6 +105,8 @@ class CarveTriangulationImprover : public csg::CSG::Hook {
 
   ~CarveTriangulationImprover() override {}
 
+  bool isThreadSafe() const override { return true; }
+
   void processOutputFace(std::vector<carve::mesh::MeshSet<3>::face_t*>& faces,
                          const carve::mesh::MeshSet<3>::face_t* orig,
                          bool flipped) override {
@@ -115,8 +123,8 @@ class CarveTriangulationImprover : public csg::CSG::Hook {
 
     out_faces.reserve(faces.size());
 
-    carve::mesh::MeshSet<3>::face_t::projection_mapping projector(
-        faces[0]->project);
+    carve::mesh::MeshSet<3>::face_t::projection_mapping projector =
+        faces[0]->projector();
 
     std::vector<triangulate::tri_idx> result;
 
@@ -208,8 +216,6 @@ class CarveTriangulationQuadMerger : public csg::CSG::Hook {
 
     out_faces.reserve(faces.size());
 
-    poly::p2_adapt_project<3> projector(faces[0]->project);
-
     for (size_t f = 0; f < faces.size(); ++f) {
       carve::mesh::MeshSet<3>::face_t* face = faces[f];
       if (face->nVertices() != 3) {
@@ -276,6 +282,8 @@ class CarveHoleResolver : public csg::CSG::Hook {
 
   ~CarveHoleResolver() override {}
 
+  bool isThreadSafe() const override { return true; }
+
   bool findRepeatedEdges(
       const std::vector<carve::mesh::MeshSet<3>::vertex_t*>& vertices,
       std::list<std::pair<size_t, size_t> >& edge_pos) {
@@ -387,9 +395,7 @@ class CarveHoleResolver : public csg::CSG::Hook {
       }
 
       std::vector<triangulate::tri_idx> result;
-      triangulate::triangulate(
-          carve::mesh::MeshSet<3>::face_t::projection_mapping(face->project),
-          vloop, result);
+      triangulate::triangulate(face->projector(), vloop, result);
 
       std::map<std::pair<size_t, size_t>, size_t> tri_edge;
       for (size_t i = 0; i < result.size(); ++i) {
@@ -25,105 +25,130 @@
 #pragma once
 
 #include <carve/carve.hpp>
+#include <carve/small_vector.hpp>
 
+#include <cassert>
+#include <limits>
 #include <numeric>
+#include <ostream>
+#include <utility>
 #include <vector>
 
 namespace carve {
 namespace exact {
 
-class exact_t : public std::vector<double> {
-  typedef std::vector<double> super;
+/**
+ * \brief An expansion: a sum of non-overlapping doubles, stored in
+ * increasing order of magnitude. storage_t is the container used to
+ * hold the components.
+ */
+template <typename storage_t>
+class basic_exact_t : public storage_t {
+  typedef storage_t super;
 
  public:
-  exact_t() : super() {}
+  basic_exact_t() : super() {}
 
-  exact_t(double v, size_t sz = 1) : super(sz, v) {}
+  basic_exact_t(double v, size_t sz = 1) : super(sz, v) {}
 
   template <typename iter_t>
-  exact_t(iter_t a, iter_t b) : super(a, b) {}
+  basic_exact_t(iter_t a, iter_t b) : super(a, b) {}
 
-  exact_t(double a, double b) : super() {
-    reserve(2);
-    push_back(a);
-    push_back(b);
+  basic_exact_t(double a, double b) : super() {
+    this->reserve(2);
+    this->push_back(a);
+    this->push_back(b);
   }
 
-  exact_t(double a, double b, double c) : super() {
-    reserve(3);
-    push_back(a);
-    push_back(b);
-    push_back(c);
+  basic_exact_t(double a, double b, double c) : super() {
+    this->reserve(3);
+    this->push_back(a);
+    this->push_back(b);
+    this->push_back(c);
   }
 
-  exact_t(double a, double b, double c, double d) : super() {
-    reserve(4);
-    push_back(a);
-    push_back(b);
-    push_back(c);
-    push_back(d);
+  basic_exact_t(double a, double b, double c, double d) : super() {
+    this->reserve(4);
+    this->push_back(a);
+    this->push_back(b);
+    this->push_back(c);
+    this->push_back(d);
   }
 
-  exact_t(double a, double b, double c, double d, double e) : super() {
-    reserve(5);
-    push_back(a);
-    push_back(b);
-    push_back(c);
-    push_back(d);
-    push_back(e);
+  basic_exact_t(double a, double b, double c, double d, double e) : super() {
+    this->reserve(5);
+    this->push_back(a);
+    this->push_back(b);
+    this->push_back(c);
+    this->push_back(d);
+    this->push_back(e);
   }
 
-  exact_t(double a, double b, double c, double d, double e, double f)
+  basic_exact_t(double a, double b, double c, double d, double e, double f)
       : super() {
-    reserve(6);
-    push_back(a);
-    push_back(b);
-    push_back(c);
-    push_back(d);
-    push_back(e);
-    push_back(f);
+    this->reserve(6);
+    this->push_back(a);
+    this->push_back(b);
+    this->push_back(c);
+    this->push_back(d);
+    this->push_back(e);
+    this->push_back(f);
   }
 
-  exact_t(double a, double b, double c, double d, double e, double f, double g)
+  basic_exact_t(double a, double b, double c, double d, double e, double f,
+                double g)
       : super() {
-    reserve(7);
-    push_back(a);
-    push_back(b);
-    push_back(c);
-    push_back(d);
-    push_back(e);
-    push_back(f);
-    push_back(g);
-  }
-
-  exact_t(double a, double b, double c, double d, double e, double f, double g,
-          double h)
+    this->reserve(7);
+    this->push_back(a);
+    this->push_back(b);
+    this->push_back(c);
+    this->push_back(d);
+    this->push_back(e);
+    this->push_back(f);
+    this->push_back(g);
+  }
+
+  basic_exact_t(double a, double b, double c, double d, double e, double f,
+                double g, double h)
       : super() {
-    reserve(8);
-    push_back(a);
-    push_back(b);
-    push_back(c);
-    push_back(d);
-    push_back(e);
-    push_back(f);
-    push_back(g);
-    push_back(h);
+    this->reserve(8);
+    this->push_back(a);
+    this->push_back(b);
+    this->push_back(c);
+    this->push_back(d);
+    this->push_back(e);
+    this->push_back(f);
+    this->push_back(g);
+    this->push_back(h);
   }
 
   void compress();
 
-  exact_t compressed() const {
-    exact_t result(*this);
+  basic_exact_t compressed() const {
+    basic_exact_t result(*this);
     result.compress();
     return result;
   }
 
-  operator double() const { return std::accumulate(begin(), end(), 0.0); }
+  operator double() const {
+    return std::accumulate(this->begin(), this->end(), 0.0);
+  }
 
-  void removeZeroes() { erase(std::remove(begin(), end(), 0.0), end()); }
+  void removeZeroes() {
+    this->erase(std::remove(this->begin(), this->end(), 0.0), this->end());
+  }
 };
 
-inline std::ostream& operator<<(std::ostream& out, const exact_t& p) {
+// expansions on the heap; every expansion allocates.
+typedef basic_exact_t<std::vector<double> > exact_t;
+
+// expansions of up to 16 components are held inline, without
+// allocating.
+typedef basic_exact_t<carve::small_vector<double, 16> > small_exact_t;
+
+template <typename storage_t>
+inline std::ostream& operator<<(std::ostream& out,
+                                const basic_exact_t<storage_t>& p) {
   out << '{';
   out << p[0];
   for (size_t i = 1; i < p.size(); ++i) {
@@ -270,27 +295,31 @@ struct op<1, 1> {
   }
 };
 
-template <unsigned U, unsigned V>
-static exact_t add(const double* a, const double* b) {
-  exact_t result;
+// Sums and differences of fixed size expansions. The result type
+// defaults to exact_t, or follows the type of the expansion argument;
+// pass small_exact_t to avoid allocating.
+template <unsigned U, unsigned V, typename expansion_t = exact_t>
+static expansion_t add(const double* a, const double* b) {
+  expansion_t result;
   result.resize(U + V);
   op<U, V>::add(a, b, &result[0]);
   return result;
 }
 
-template <unsigned U, unsigned V>
-static exact_t sub(const double* a, const double* b) {
-  exact_t result;
+template <unsigned U, unsigned V, typename expansion_t = exact_t>
+static expansion_t sub(const double* a, const double* b) {
+  expansion_t result;
   result.resize(U + V);
   op<U, V>::sub(a, b, &result[0]);
   return result;
 }
 
-template <unsigned U, unsigned V>
-static exact_t add(const exact_t& a, const exact_t& b) {
+template <unsigned U, unsigned V, typename storage_t>
+static basic_exact_t<storage_t> add(const basic_exact_t<storage_t>& a,
+                                    const basic_exact_t<storage_t>& b) {
   assert(a.size() == U);
   assert(b.size() == V);
-  exact_t result;
+  basic_exact_t<storage_t> result;
   result.resize(U + V);
   std::fill(result.begin(), result.end(),
             std::numeric_limits<double>::quiet_NaN());
@@ -298,10 +327,11 @@ static exact_t add(const exact_t& a, const exact_t& b) {
   return result;
 }
 
-template <unsigned U, unsigned V>
-static exact_t add(const exact_t& a, const double* b) {
+template <unsigned U, unsigned V, typename storage_t>
+static basic_exact_t<storage_t> add(const basic_exact_t<storage_t>& a,
+                                    const double* b) {
   assert(a.size() == U);
-  exact_t result;
+  basic_exact_t<storage_t> result;
   result.resize(U + V);
   std::fill(result.begin(), result.end(),
             std::numeric_limits<double>::quiet_NaN());
@@ -309,11 +339,12 @@ static exact_t add(const exact_t& a, const double* b) {
   return result;
 }
 
-template <unsigned U, unsigned V>
-static exact_t sub(const exact_t& a, const exact_t& b) {
+template <unsigned U, unsigned V, typename storage_t>
+static basic_exact_t<storage_t> sub(const basic_exact_t<storage_t>& a,
+                                    const basic_exact_t<storage_t>& b) {
   assert(a.size() == U);
   assert(b.size() == V);
-  exact_t result;
+  basic_exact_t<storage_t> result;
   result.resize(U + V);
   std::fill(result.begin(), result.end(),
             std::numeric_limits<double>::quiet_NaN());
@@ -321,10 +352,11 @@ static exact_t sub(const exact_t& a, const exact_t& b) {
   return result;
 }
 
-template <unsigned U, unsigned V>
-static exact_t sub(const exact_t& a, const double* b) {
+template <unsigned U, unsigned V, typename storage_t>
+static basic_exact_t<storage_t> sub(const basic_exact_t<storage_t>& a,
+                                    const double* b) {
   assert(a.size() == U);
-  exact_t result;
+  basic_exact_t<storage_t> result;
   result.resize(U + V);
   std::fill(result.begin(), result.end(),
             std::numeric_limits<double>::quiet_NaN());
@@ -515,12 +547,13 @@ static inline void square_2(const double* a, double* r) {
 }
 }  // namespace detail
 
-void exact_t::compress() {
+template <typename storage_t>
+void basic_exact_t<storage_t>::compress() {
   double sum[2];
 
-  int j = size() - 1;
+  int j = this->size() - 1;
   double Q = (*this)[j];
-  for (int i = (int)size() - 2; i >= 0; --i) {
+  for (int i = (int)this->size() - 2; i >= 0; --i) {
     detail::op<1, 1>::add_fast(&Q, &(*this)[i], sum);
     if (sum[0] != 0) {
       (*this)[j--] = sum[1];
@@ -530,7 +563,7 @@ void exact_t::compress() {
     }
   }
   int j2 = 0;
-  for (int i = j + 1; i < (int)size(); ++i) {
+  for (int i = j + 1; i < (int)this->size(); ++i) {
     detail::op<1, 1>::add_fast(&(*this)[i], &Q, sum);
     if (sum[0] != 0) {
       (*this)[j2++] = sum[0];
@@ -539,7 +572,7 @@ void exact_t::compress() {
   }
   (*this)[j2++] = Q;
 
-  erase(begin() + j2, end());
+  this->erase(this->begin() + j2, this->end());
 }
 
 template <typename iter_t>
@@ -550,12 +583,14 @@ void negate(iter_t begin, iter_t end) {
   }
 }
 
-void negate(exact_t& e) {
-  negate(&e[0], &e[e.size()]);
+template <typename storage_t>
+void negate(basic_exact_t<storage_t>& e) {
+  negate(&e[0], &e[0] + e.size());
 }
 
-template <typename iter_t>
-void scale_zeroelim(iter_t ebegin, iter_t eend, double b, exact_t& h) {
+template <typename iter_t, typename storage_t>
+void scale_zeroelim(iter_t ebegin, iter_t eend, double b,
+                    basic_exact_t<storage_t>& h) {
   double Q;
 
   h.clear();
@@ -587,13 +622,15 @@ void scale_zeroelim(iter_t ebegin, iter_t eend, double b, exact_t& h) {
   }
 }
 
-void scale_zeroelim(const exact_t& e, double b, exact_t& h) {
-  scale_zeroelim(&e[0], &e[e.size()], b, h);
+template <typename storage_t>
+void scale_zeroelim(const basic_exact_t<storage_t>& e, double b,
+                    basic_exact_t<storage_t>& h) {
+  scale_zeroelim(&e[0], &e[0] + e.size(), b, h);
 }
 
-template <typename iter_t>
+template <typename iter_t, typename storage_t>
 void sum_zeroelim(iter_t ebegin, iter_t eend, iter_t fbegin, iter_t fend,
-                  exact_t& h) {
+                  basic_exact_t<storage_t>& h) {
   double Q;
   double enow, fnow;
 
@@ -661,28 +698,36 @@ void sum_zeroelim(iter_t ebegin, iter_t eend, iter_t fbegin, iter_t fend,
   }
 }
 
-void sum_zeroelim(const exact_t& e, const exact_t& f, exact_t& h) {
-  sum_zeroelim(&e[0], &e[e.size()], &f[0], &f[f.size()], h);
+template <typename storage_t>
+void sum_zeroelim(const basic_exact_t<storage_t>& e,
+                  const basic_exact_t<storage_t>& f,
+                  basic_exact_t<storage_t>& h) {
+  sum_zeroelim(&e[0], &e[0] + e.size(), &f[0], &f[0] + f.size(), h);
 }
 
-void sum_zeroelim(const double* ebegin, const double* eend, const exact_t& f,
-                  exact_t& h) {
-  sum_zeroelim(ebegin, eend, &f[0], &f[f.size()], h);
+template <typename storage_t>
+void sum_zeroelim(const double* ebegin, const double* eend,
+                  const basic_exact_t<storage_t>& f,
+                  basic_exact_t<storage_t>& h) {
+  sum_zeroelim(ebegin, eend, &f[0], &f[0] + f.size(), h);
 }
 
-void sum_zeroelim(const exact_t& e, const double* fbegin, const double* fend,
-                  exact_t& h) {
-  sum_zeroelim(&e[0], &e[e.size()], fbegin, fend, h);
+template <typename storage_t>
+void sum_zeroelim(const basic_exact_t<storage_t>& e, const double* fbegin,
+                  const double* fend, basic_exact_t<storage_t>& h) {
+  sum_zeroelim(&e[0], &e[0] + e.size(), fbegin, fend, h);
 }
 
-exact_t operator+(const exact_t& a, const exact_t& b) {
-  exact_t r;
+template <typename storage_t>
+basic_exact_t<storage_t> operator+(const basic_exact_t<storage_t>& a,
+                                   const basic_exact_t<storage_t>& b) {
+  basic_exact_t<storage_t> r;
   sum_zeroelim(a, b, r);
   return r;
 }
 
-void diffprod(const double a, const double b, const double c, const double d,
-              double* r) {
+inline void diffprod(const double a, const double b, const double c,
+                     const double d, double* r) {
   // return ab - cd;
   double ab[2], cd[2];
   detail::prod_1_1(&a, &b, ab);
@@ -690,8 +735,44 @@ void diffprod(const double a, const double b, const double c, const double d,
   detail::op<2, 2>::sub(ab, cd, r);
 }
 
-double orient3dexact(const double* pa, const double* pb, const double* pc,
-                     const double* pd) {
+// h = e * f.
+template <typename storage_t>
+void product_zeroelim(const basic_exact_t<storage_t>& e,
+                      const basic_exact_t<storage_t>& f,
+                      basic_exact_t<storage_t>& h) {
+  basic_exact_t<storage_t> term, sum;
+  scale_zeroelim(e, f[0], h);
+  for (size_t i = 1; i < f.size(); ++i) {
+    scale_zeroelim(e, f[i], term);
+    sum_zeroelim(h, term, sum);
+    h = std::move(sum);
+  }
+}
+
+// h = e - f.
+template <typename storage_t>
+void diff_zeroelim(const basic_exact_t<storage_t>& e,
+                   basic_exact_t<storage_t> f, basic_exact_t<storage_t>& h) {
+  negate(f);
+  sum_zeroelim(e, f, h);
+}
+
+// The sign of the value of an expansion: that of its largest
+// nonzero component.
+template <typename storage_t>
+int sign(const basic_exact_t<storage_t>& e) {
+  for (size_t i = e.size(); i != 0; --i) {
+    if (e[i - 1] != 0.0) {
+      return e[i - 1] < 0.0 ? -1 : +1;
+    }
+  }
+  return 0;
+}
+
+// orient3d, evaluated exactly as an expansion of type expansion_t.
+template <typename expansion_t>
+void orient3dexpansion(const double* pa, const double* pb, const double* pc,
+                       const double* pd, expansion_t& det) {
   using namespace detail;
 
   double ab[4];
@@ -707,9 +788,9 @@ double orient3dexact(const double* pa, const double* pb, const double* pc,
   double bd[4];
   diffprod(pb[0], pd[1], pd[0], pb[1], bd);
 
-  exact_t temp;
-  exact_t cda, dab, abc, bcd;
-  exact_t adet, bdet, cdet, ddet, abdet, cddet, det;
+  expansion_t temp;
+  expansion_t cda, dab, abc, bcd;
+  expansion_t adet, bdet, cdet, ddet, abdet, cddet;
 
   sum_zeroelim(cd, cd + 4, da, da + 4, temp);
   sum_zeroelim(temp, ac, ac + 4, cda);
@@ -718,7 +799,7 @@ double orient3dexact(const double* pa, const double* pb, const double* pc,
   sum_zeroelim(temp, bd, bd + 4, dab);
 
   negate(bd, bd + 4);
-  negate(ac, bd + 4);
+  negate(ac, ac + 4);
 
   sum_zeroelim(ab, ab + 4, bc, bc + 4, temp);
   sum_zeroelim(temp, ac, ac + 4, abc);
@@ -735,8 +816,20 @@ double orient3dexact(const double* pa, const double* pb, const double* pc,
   sum_zeroelim(cdet, ddet, cddet);
 
   sum_zeroelim(abdet, cddet, det);
+}
 
+// orient3d, evaluated exactly with expansions of type expansion_t.
+template <typename expansion_t>
+double orient3dexact(const double* pa, const double* pb, const double* pc,
+                     const double* pd) {
+  expansion_t det;
+  orient3dexpansion(pa, pb, pc, pd, det);
   return det[det.size() - 1];
 }
+
+inline double orient3dexact(const double* pa, const double* pb,
+                            const double* pc, const double* pd) {
+  return orient3dexact<small_exact_t>(pa, pb, pc, pd);
+}
 }  // namespace exact
 }  // namespace carve
@@ -338,6 +338,21 @@ double distance2(const linesegment<ndim>& l, const vector<ndim>& v);
 template <unsigned ndim>
 double distance(const linesegment<ndim>& l, const vector<ndim>& v);
 
+template <unsigned ndim>
+vector<ndim> closestPoint(const linesegment<ndim>& l, const vector<ndim>& v);
+
+// Compute the closest pair of points between two line segments. Returns
+// the squared distance between them.
+template <unsigned ndim>
+double closestPoints(const linesegment<ndim>& l1, const linesegment<ndim>& l2,
+                     vector<ndim>& c1, vector<ndim>& c2);
+
+template <unsigned ndim>
+double distance2(const linesegment<ndim>& l1, const linesegment<ndim>& l2);
+
+template <unsigned ndim>
+double distance(const linesegment<ndim>& l1, const linesegment<ndim>& l2);
+
 // ========================================================================
 template <unsigned ndim>
 struct plane {
@@ -39,9 +39,7 @@
 #include <iostream>
 #endif
 
-#if defined CARVE_USE_EXACT_PREDICATES
-#include <carve/shewchuk_predicates.hpp>
-#endif
+#include <carve/predicates.hpp>
 
 namespace carve {
 namespace geom2d {
@@ -70,19 +68,19 @@ typedef std::vector<P2> P2Vector;
  *         zero, if c is colinear with a->b.
  *         negative, if c to the right of a->b.
  */
-#if defined CARVE_USE_EXACT_PREDICATES
-inline double orient2d(const P2& a, const P2& b, const P2& c) {
-  return shewchuk::orient2d(a.v, b.v, c.v);
-}
-#else
 inline double orient2d(const P2& a, const P2& b, const P2& c) {
+  if (carve::predicate_mode == carve::PREDICATES_FILTERED) {
+    return carve::orient2d_filtered(a.v, b.v, c.v);
+  }
+  if (carve::predicate_mode == carve::PREDICATES_INTEGER) {
+    return carve::orient2d_integer(a.v, b.v, c.v);
+  }
   double acx = a.x - c.x;
   double bcx = b.x - c.x;
   double acy = a.y - c.y;
   double bcy = b.y - c.y;
   return acx * bcy - acy * bcx;
 }
-#endif
 
 /**
  * \brief Determine whether p is internal to the anticlockwise
@@ -38,9 +38,7 @@
 #include <iostream>
 #endif
 
-#if defined CARVE_USE_EXACT_PREDICATES
-#include <carve/shewchuk_predicates.hpp>
-#endif
+#include <carve/predicates.hpp>
 
 namespace carve {
 namespace geom3d {
@@ -128,17 +126,16 @@ RayIntersectionClass rayRayIntersection(const Ray& r1, const Ray& r2,
 // return: +ve = d is below a,b,c
 //         -ve = d is above a,b,c
 //           0 = d is on a,b,c
-#if defined CARVE_USE_EXACT_PREDICATES
-inline double orient3d(const Vector& a, const Vector& b, const Vector& c,
-                       const Vector& d) {
-  return shewchuk::orient3d(a.v, b.v, c.v, d.v);
-}
-#else
 inline double orient3d(const Vector& a, const Vector& b, const Vector& c,
                        const Vector& d) {
+  if (carve::predicate_mode == carve::PREDICATES_FILTERED) {
+    return carve::orient3d_filtered(a.v, b.v, c.v, d.v);
+  }
+  if (carve::predicate_mode == carve::PREDICATES_INTEGER) {
+    return carve::orient3d_integer(a.v, b.v, c.v, d.v);
+  }
   return dotcross((a - d), (b - d), (c - d));
 }
-#endif
 
 // Volume of a tetrahedron described by 4 points. Will be
 // positive if the anticlockwise normal of a,b,c is oriented out
@@ -209,21 +206,20 @@ inline int compareAngles(const Vector& direction, const Vector& base,
 // double d3 = carve::geom3d::orient3d(carve::geom::VECTOR(0,0,0), direction,
 // base, b);
 
-#if defined(CARVE_USE_EXACT_PREDICATES)
-  // which is equivalent to the following (which eliminates a
-  // vector subtraction):
-  double d1 =
-      carve::geom3d::orient3d(direction, b, a, carve::geom::VECTOR(0, 0, 0));
-  double d2 =
-      carve::geom3d::orient3d(direction, a, base, carve::geom::VECTOR(0, 0, 0));
-  double d3 =
-      carve::geom3d::orient3d(direction, b, base, carve::geom::VECTOR(0, 0, 0));
-#else
-  // dotcross = a . (b x c)
-  double d1 = carve::geom::dotcross(direction, b, a);
-  double d2 = carve::geom::dotcross(direction, a, base);
-  double d3 = carve::geom::dotcross(direction, b, base);
-#endif
+  double d1, d2, d3;
+  if (carve::predicate_mode != carve::PREDICATES_FAST) {
+    // which is equivalent to the following (which eliminates a
+    // vector subtraction):
+    const carve::geom::vector<3> o = carve::geom::VECTOR(0, 0, 0);
+    d1 = carve::geom3d::orient3d(direction, b, a, o);
+    d2 = carve::geom3d::orient3d(direction, a, base, o);
+    d3 = carve::geom3d::orient3d(direction, b, base, o);
+  } else {
+    // dotcross = a . (b x c)
+    d1 = carve::geom::dotcross(direction, b, a);
+    d2 = carve::geom::dotcross(direction, a, base);
+    d3 = carve::geom::dotcross(direction, b, base);
+  }
 
   // CASE: a and b are coplanar wrt. direction.
   if (d1 == 0.0) {
@@ -674,6 +674,81 @@ double distance(const linesegment<ndim>& l, const vector<ndim>& v) {
   return sqrt(distance2(l, v));
 }
 
+template <unsigned ndim>
+vector<ndim> closestPoint(const linesegment<ndim>& l, const vector<ndim>& v) {
+  vector<ndim> D = l.v2 - l.v1;
+  double d2 = dot(D, D);
+  if (d2 == 0.0) {
+    return l.v1;
+  }
+  double t = dot(v - l.v1, D) / d2;
+  if (t <= 0.0) {
+    return l.v1;
+  }
+  if (t >= 1.0) {
+    return l.v2;
+  }
+  return D * t + l.v1;
+}
+
+template <unsigned ndim>
+double closestPoints(const linesegment<ndim>& l1, const linesegment<ndim>& l2,
+                     vector<ndim>& c1, vector<ndim>& c2) {
+  // see: Ericson, Real-Time Collision Detection, 5.1.9
+  const vector<ndim> d1 = l1.v2 - l1.v1;
+  const vector<ndim> d2 = l2.v2 - l2.v1;
+  const vector<ndim> r = l1.v1 - l2.v1;
+  const double a = dot(d1, d1);
+  const double e = dot(d2, d2);
+  const double f = dot(d2, r);
+
+  double s, t;
+
+  if (a == 0.0 && e == 0.0) {
+    c1 = l1.v1;
+    c2 = l2.v1;
+    return distance2(c1, c2);
+  }
+
+  if (a == 0.0) {
+    s = 0.0;
+    t = math::clamp(f / e, 0.0, 1.0);
+  } else {
+    const double c = dot(d1, r);
+    if (e == 0.0) {
+      t = 0.0;
+      s = math::clamp(-c / a, 0.0, 1.0);
+    } else {
+      const double b = dot(d1, d2);
+      const double denom = a * e - b * b;
+      s = denom != 0.0 ? math::clamp((b * f - c * e) / denom, 0.0, 1.0) : 0.0;
+      t = (b * s + f) / e;
+      if (t < 0.0) {
+        t = 0.0;
+        s = math::clamp(-c / a, 0.0, 1.0);
+      } else if (t > 1.0) {
+        t = 1.0;
+        s = math::clamp((b - c) / a, 0.0, 1.0);
+      }
+    }
+  }
+
+  c1 = l1.v1 + d1 * s;
+  c2 = l2.v1 + d2 * t;
+  return distance2(c1, c2);
+}
+
+template <unsigned ndim>
+double distance2(const linesegment<ndim>& l1, const linesegment<ndim>& l2) {
+  vector<ndim> c1, c2;
+  return closestPoints(l1, l2, c1, c2);
+}
+
+template <unsigned ndim>
+double distance(const linesegment<ndim>& l1, const linesegment<ndim>& l2) {
+  return sqrt(distance2(l1, l2));
+}
+
 template <unsigned ndim>
 void plane<ndim>::negate() {
   N.negate();
@@ -84,6 +84,19 @@ void _push_heap(random_access_iter_t begin, distance_t pos, value_t val,
   notify(begin[pos], pos);
 }
 
+// Place val, which replaces the element at pos, sifting it up if it
+// now has a higher priority than its parent, and otherwise down.
+template <typename random_access_iter_t, typename distance_t, typename value_t,
+          typename pred_t, typename pos_notifier_t>
+void _update_heap(random_access_iter_t begin, distance_t pos, distance_t len,
+                  value_t val, pred_t pred, pos_notifier_t notify) {
+  if (pos > 0 && pred(begin[(pos - 1) / 2], val)) {
+    _push_heap(begin, pos, val, pred, notify);
+  } else {
+    _adjust_heap(begin, pos, len, val, pred, notify);
+  }
+}
+
 template <typename random_access_iter_t, typename distance_t, typename pred_t,
           typename pos_notifier_t>
 void _remove_heap(random_access_iter_t begin, distance_t pos, distance_t len,
@@ -93,7 +106,7 @@ void _remove_heap(random_access_iter_t begin, distance_t pos, distance_t len,
     typedef
         typename std::iterator_traits<random_access_iter_t>::value_type value_t;
     value_t removed = begin[pos];
-    _adjust_heap(begin, pos, len, begin[len], pred, notify);
+    _update_heap(begin, pos, len, begin[len], pred, notify);
     begin[len] = removed;
     notify(begin[len], len);
   }
@@ -148,21 +161,22 @@ void adjust_heap(random_access_iter_t begin, random_access_iter_t end,
   typedef
       typename std::iterator_traits<random_access_iter_t>::value_type value_t;
 
-  detail::_adjust_heap(begin, pos - begin, end - begin, *pos,
-                       std::less<value_t>());
+  detail::_update_heap(begin, pos - begin, end - begin, *pos,
+                       std::less<value_t>(), detail::ignore_position_t());
 }
 
 template <typename random_access_iter_t, typename pred_t>
 void adjust_heap(random_access_iter_t begin, random_access_iter_t end,
                  random_access_iter_t pos, pred_t pred) {
-  detail::_adjust_heap(begin, pos - begin, end - begin, *pos, pred);
+  detail::_update_heap(begin, pos - begin, end - begin, *pos, pred,
+                       detail::ignore_position_t());
 }
 
 template <typename random_access_iter_t, typename pred_t,
           typename pos_notifier_t>
 void adjust_heap(random_access_iter_t begin, random_access_iter_t end,
                  random_access_iter_t pos, pred_t pred, pos_notifier_t notify) {
-  detail::_adjust_heap(begin, pos - begin, end - begin, *pos, pred, notify);
+  detail::_update_heap(begin, pos - begin, end - begin, *pos, pred, notify);
 }
 
 template <typename random_access_iter_t>
@@ -0,0 +1,109 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <carve/exact.hpp>
+#include <carve/geom3d.hpp>
+
+namespace carve {
+namespace geom3d {
+
+/**
+ * \brief A plane that can be evaluated exactly: either a Plane, whose
+ * N and d are taken to be exact, or the plane through three points.
+ */
+class ExactPlane {
+ public:
+  enum Kind { PLANE, POINTS };
+
+  Kind kind;
+  // PLANE: a = N, b.x = d. POINTS: the plane through a, b and c.
+  Vector a, b, c;
+
+  ExactPlane(const Plane& plane)
+      : kind(PLANE),
+        a(plane.N),
+        b(carve::geom::VECTOR(plane.d, 0.0, 0.0)),
+        c(carve::geom::VECTOR(0.0, 0.0, 0.0)) {}
+
+  ExactPlane(const Vector& _a, const Vector& _b, const Vector& _c)
+      : kind(POINTS), a(_a), b(_b), c(_c) {}
+};
+
+/**
+ * \brief The intersection of the line through \a p and \a q with a
+ * plane, held implicitly rather than as rounded coordinates.
+ *
+ * Predicates on an implicit point are evaluated exactly, in terms of
+ * the input points and plane, so two intersection points that are
+ * nearly coincident are still ordered consistently. approx() rounds
+ * the point to double coordinates, for output.
+ */
+class ImplicitPoint {
+ public:
+  Vector p, q;
+  ExactPlane plane;
+
+  ImplicitPoint(const Vector& _p, const Vector& _q, const ExactPlane& _plane)
+      : p(_p), q(_q), plane(_plane) {}
+
+  // The same point, on the line from q to p.
+  ImplicitPoint reversed() const { return ImplicitPoint(q, p, plane); }
+
+  // True if the line crosses the plane at a single point, which is
+  // required by everything below.
+  bool valid() const;
+
+  // The point, rounded to double coordinates.
+  Vector approx() const;
+};
+
+/**
+ * \brief The position of an ImplicitPoint along its line, with the
+ * plane's function evaluated once at each end, so that it can be
+ * compared repeatedly (e.g. when sorting) without re-evaluation.
+ */
+class ImplicitParameter {
+ public:
+  // the plane's function at p and q, exactly and rounded.
+  carve::exact::exact_t fp, fq;
+  double ep, eq;
+
+  explicit ImplicitParameter(const ImplicitPoint& pt);
+};
+
+/**
+ * \brief Compares the positions of \a a and \a b along the line from
+ * p to q, which they must share, exactly.
+ *
+ * @return -1, 0 or +1 as \a a is before, at or after \a b.
+ */
+int compareAlong(const ImplicitParameter& a, const ImplicitParameter& b);
+
+int compareAlong(const ImplicitPoint& a, const ImplicitPoint& b);
+}  // namespace geom3d
+}  // namespace carve
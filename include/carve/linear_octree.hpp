@@ -0,0 +1,324 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <carve/aabb.hpp>
+#include <carve/geom.hpp>
+#include <carve/morton.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace carve {
+namespace geom {
+
+// A loose octree, stored as a flat array of entries sorted by cell.
+//
+// Each object is assigned to a single cell: the cell containing the
+// centre of its bounding box, at the deepest level whose cell size
+// is no smaller than the largest dimension of the box. Because an
+// object can overhang its cell by at most half a cell in each
+// direction, a query need only visit, at each level, the cells
+// within half a cell of the query box.
+//
+// Cells are identified by a key combining the level and the Morton
+// code of the cell coordinates at that level, so that entries are
+// grouped by level, and then ordered along a Z-order curve. Building
+// the tree is a matter of computing keys and sorting; there is no
+// incremental insertion, and no per-node allocation.
+template <typename data_t, typename aabb_calc_t = get_aabb<3, data_t> >
+class LinearOctree {
+ public:
+  enum { MAX_DEPTH = 18, DEFAULT_DEPTH = 16 };
+
+  typedef aabb<3> aabb_t;
+  typedef vector<3> vector_t;
+
+  struct entry_t {
+    uint64_t key;
+    aabb_t bbox;
+    data_t data;
+  };
+
+ private:
+  vector_t base;
+  double side;
+  unsigned depth;
+  std::vector<entry_t> entries;
+  size_t level_begin[MAX_DEPTH + 2];
+
+  struct key_less {
+    bool operator()(const entry_t& a, uint64_t b) const { return a.key < b; }
+    bool operator()(uint64_t a, const entry_t& b) const { return a < b.key; }
+  };
+
+  static uint64_t makeKey(unsigned level, uint64_t code) {
+    return ((uint64_t)level << (3 * MAX_DEPTH)) | code;
+  }
+
+  static uint64_t codeOf(uint64_t key) {
+    return key & ((1ULL << (3 * MAX_DEPTH)) - 1);
+  }
+
+  uint32_t cellCoord(double v, unsigned axis, unsigned level) const {
+    const uint32_t m = (1U << level) - 1;
+    double c = (v - base.v[axis]) / side * (double)(1U << level);
+    if (!(c > 0.0)) {
+      return 0;
+    }
+    if (c >= (double)m) {
+      return m;
+    }
+    return (uint32_t)c;
+  }
+
+  unsigned levelFor(const aabb_t& bbox) const {
+    const double e =
+        2.0 * std::max(std::max(bbox.extent.x, bbox.extent.y), bbox.extent.z);
+    unsigned level = 0;
+    double cell = side;
+    while (level < depth && e <= cell * 0.5) {
+      cell *= 0.5;
+      ++level;
+    }
+    return level;
+  }
+
+  uint64_t keyFor(const aabb_t& bbox) const {
+    const unsigned level = levelFor(bbox);
+    uint32_t c[3];
+    for (unsigned i = 0; i < 3; ++i) {
+      c[i] = cellCoord(bbox.pos.v[i], i, level);
+    }
+    return makeKey(level, morton<3>::encode(c));
+  }
+
+  // lower_bound by exponential search forward from begin, which is
+  // cheap when the target is close to begin.
+  static typename std::vector<entry_t>::const_iterator gallop(
+      typename std::vector<entry_t>::const_iterator begin,
+      typename std::vector<entry_t>::const_iterator end, uint64_t key) {
+    size_t step = 1;
+    typename std::vector<entry_t>::const_iterator lo = begin;
+    while (lo != end && (*lo).key < key) {
+      begin = lo + 1;
+      if ((size_t)(end - lo) <= step) {
+        lo = end;
+        break;
+      }
+      lo += step;
+      step *= 2;
+    }
+    return std::lower_bound(begin, lo, key, key_less());
+  }
+
+  static bool hit(const aabb_t& bbox, const vector_t& v) {
+    return bbox.containsPoint(v);
+  }
+
+  template <typename obj_t>
+  static bool hit(const aabb_t& bbox, const obj_t& obj) {
+    return bbox.intersects(obj);
+  }
+
+  template <typename obj_t, typename out_iter_t>
+  void _search(const aabb_t& range, const obj_t& obj, out_iter_t out) const {
+    for (unsigned level = 0; level <= depth; ++level) {
+      const size_t b = level_begin[level];
+      const size_t e = level_begin[level + 1];
+      if (b == e) {
+        continue;
+      }
+
+      const double half = 0.5 * side / (double)(1U << level);
+      uint32_t lo[3], hi[3];
+      size_t n_cells = 1;
+      bool outside = false;
+      for (unsigned i = 0; i < 3; ++i) {
+        const double r_min = range.min(i) - half;
+        const double r_max = range.max(i) + half;
+        if (r_max < base.v[i] || r_min > base.v[i] + side) {
+          outside = true;
+          break;
+        }
+        lo[i] = cellCoord(r_min, i, level);
+        hi[i] = cellCoord(r_max, i, level);
+        n_cells *= hi[i] - lo[i] + 1;
+      }
+      if (outside) {
+        continue;
+      }
+
+      typename std::vector<entry_t>::const_iterator l_begin =
+          entries.begin() + b;
+      typename std::vector<entry_t>::const_iterator l_end = entries.begin() + e;
+
+      if (n_cells <= 64) {
+        // few cells; look each of them up, in key order, so that each
+        // search starts where the last one finished.
+        uint64_t keys[64];
+        size_t n_keys = 0;
+        uint32_t c[3];
+        for (c[2] = lo[2]; c[2] <= hi[2]; ++c[2]) {
+          for (c[1] = lo[1]; c[1] <= hi[1]; ++c[1]) {
+            for (c[0] = lo[0]; c[0] <= hi[0]; ++c[0]) {
+              keys[n_keys++] = makeKey(level, morton<3>::encode(c));
+            }
+          }
+        }
+        std::sort(keys, keys + n_keys);
+        typename std::vector<entry_t>::const_iterator i = l_begin;
+        for (size_t k = 0; k < n_keys && i != l_end; ++k) {
+          i = gallop(i, l_end, keys[k]);
+          for (; i != l_end && (*i).key == keys[k]; ++i) {
+            if (hit((*i).bbox, obj)) {
+              *out++ = (*i).data;
+            }
+          }
+        }
+      } else {
+        // scan the range of Morton codes spanned by the cells,
+        // skipping entries whose cells fall outside them.
+        typename std::vector<entry_t>::const_iterator i =
+            std::lower_bound(l_begin, l_end,
+                             makeKey(level, morton<3>::encode(lo)), key_less());
+        const uint64_t k_max = makeKey(level, morton<3>::encode(hi));
+        for (; i != l_end && (*i).key <= k_max; ++i) {
+          uint32_t c[3];
+          morton<3>::decode(codeOf((*i).key), c);
+          if (c[0] < lo[0] || c[0] > hi[0] || c[1] < lo[1] || c[1] > hi[1] ||
+              c[2] < lo[2] || c[2] > hi[2]) {
+            continue;
+          }
+          if (hit((*i).bbox, obj)) {
+            *out++ = (*i).data;
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  LinearOctree() : base(), side(0.0), depth(0), entries() {
+    std::fill(level_begin, level_begin + MAX_DEPTH + 2, 0);
+  }
+
+  template <typename iter_t>
+  LinearOctree(iter_t begin, iter_t end, unsigned max_depth = DEFAULT_DEPTH)
+      : base(), side(0.0), depth(0), entries() {
+    build(begin, end, max_depth);
+  }
+
+  void clear() {
+    entries.clear();
+    side = 0.0;
+    depth = 0;
+    std::fill(level_begin, level_begin + MAX_DEPTH + 2, 0);
+  }
+
+  size_t size() const { return entries.size(); }
+
+  bool empty() const { return entries.empty(); }
+
+  const std::vector<entry_t>& getEntries() const { return entries; }
+
+  // (Re)build the octree from a range of objects.
+  template <typename iter_t>
+  void build(iter_t begin, iter_t end, unsigned max_depth = DEFAULT_DEPTH) {
+    clear();
+
+    std::vector<entry_t> input;
+    for (iter_t i = begin; i != end; ++i) {
+      entry_t entry;
+      entry.key = 0;
+      entry.bbox = aabb_calc_t()(*i);
+      entry.data = *i;
+      input.push_back(entry);
+    }
+    if (input.empty()) {
+      return;
+    }
+
+    aabb_t bounds = input[0].bbox;
+    for (size_t i = 1; i < input.size(); ++i) {
+      bounds.unionAABB(input[i].bbox);
+    }
+    base = bounds.min();
+    side = 2.0 * std::max(std::max(bounds.extent.x, bounds.extent.y),
+                          bounds.extent.z);
+    if (!(side > 0.0)) {
+      side = 1.0;
+    }
+    depth = std::min(max_depth, (unsigned)MAX_DEPTH);
+
+    const int N = (int)input.size();
+    std::vector<std::pair<uint64_t, uint32_t> > keys(N);
+
+#pragma omp parallel for
+    for (int i = 0; i < N; ++i) {
+      keys[i] = std::make_pair(keyFor(input[i].bbox), (uint32_t)i);
+    }
+
+    radix_sort(keys, 3 * MAX_DEPTH + 5);
+
+    entries.resize(N);
+#pragma omp parallel for
+    for (int i = 0; i < N; ++i) {
+      entries[i] = input[keys[i].second];
+      entries[i].key = keys[i].first;
+    }
+
+    for (unsigned level = 0; level <= depth + 1; ++level) {
+      level_begin[level] =
+          std::lower_bound(entries.begin(), entries.end(),
+                           makeKey(level, 0), key_less()) -
+          entries.begin();
+    }
+  }
+
+  // Find objects whose bounding boxes intersect an aabb.
+  template <typename out_iter_t>
+  void search(const aabb_t& range, out_iter_t out) const {
+    _search(range, range, out);
+  }
+
+  // Find objects whose bounding boxes contain a point.
+  template <typename out_iter_t>
+  void search(const vector_t& v, out_iter_t out) const {
+    _search(aabb_t(v, vector_t::ZERO()), v, out);
+  }
+
+  // Find objects whose bounding boxes intersect a line segment.
+  template <typename out_iter_t>
+  void search(const linesegment<3>& l, out_iter_t out) const {
+    aabb_t range;
+    range.fit(l.v1, l.v2);
+    _search(range, l, out);
+  }
+};
+}  // namespace geom
+}  // namespace carve
@@ -276,6 +276,14 @@ static inline Matrix3 operator*(const Matrix3& A, const Matrix3& B) {
   return c;
 }
 
+// Applies A to n points, stored as xyz triples that are stride
+// doubles apart, in place.
+void transformPoints(const Matrix& A, double* xyz, size_t n, size_t stride);
+
+// True if A is a rotation followed by a translation: the upper 3x3
+// block is orthonormal with a positive determinant.
+bool isRigid(const Matrix& A);
+
 struct matrix_transformation {
   Matrix matrix;
 
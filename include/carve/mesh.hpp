@@ -30,6 +30,7 @@
 #include <carve/djset.hpp>
 #include <carve/geom.hpp>
 #include <carve/geom3d.hpp>
+#include <carve/matrix.hpp>
 #include <carve/rtree.hpp>
 #include <carve/tag.hpp>
 
@@ -238,6 +239,40 @@ class Edge : public tagable {
   ~Edge();
 };
 
+namespace detail {
+// The projections of a face to 2d, indexed by Face::projection: the
+// axis that is dropped, plus 3 if the face normal is positive along
+// it. The two remaining axes are ordered so that the projected face
+// is anticlockwise.
+const unsigned char projection_axes[6][2] = {{2, 1}, {0, 2}, {1, 0},
+                                             {1, 2}, {2, 0}, {0, 1}};
+
+inline unsigned char projectionFor(bool positive_facing, int axis) {
+  return (unsigned char)((positive_facing ? 3 : 0) + axis);
+}
+
+inline carve::geom::vector<2> project(unsigned char projection,
+                                      const carve::geom::vector<3>& v) {
+  const unsigned char* ax = projection_axes[projection];
+  return carve::geom::VECTOR(v.v[ax[0]], v.v[ax[1]]);
+}
+
+inline carve::geom::vector<3> unproject(unsigned char projection,
+                                        const carve::geom::vector<2>& p,
+                                        const carve::geom::plane<3>& plane) {
+  const unsigned char* ax = projection_axes[projection];
+  const int axis = projection % 3;
+  const int lo = axis == 0 ? 1 : 0, hi = axis == 2 ? 1 : 2;
+  carve::geom::vector<3> r;
+  r.v[ax[0]] = p.x;
+  r.v[ax[1]] = p.y;
+  r.v[axis] =
+      -(plane.d + plane.N.v[lo] * r.v[lo] + plane.N.v[hi] * r.v[hi]) /
+      plane.N.v[axis];
+  return r;
+}
+}  // namespace detail
+
 // A Face contains a pointer to the beginning of the half-edge
 // circular list that defines its boundary.
 template <unsigned ndim>
@@ -250,9 +285,6 @@ class Face : public tagable {
   typedef typename Vertex<ndim>::vector_t vector_t;
   typedef carve::geom::aabb<ndim> aabb_t;
   typedef carve::geom::plane<ndim> plane_t;
-  typedef carve::geom::vector<2> (*project_t)(const vector_t&);
-  typedef vector_t (*unproject_t)(const carve::geom::vector<2>&,
-                                  const plane_t&);
 
   struct vector_mapping {
     typedef typename vertex_t::vector_t value_type;
@@ -271,8 +303,11 @@ class Face : public tagable {
 
   struct projection_mapping {
     typedef carve::geom::vector<2> value_type;
-    project_t proj;
-    projection_mapping(project_t _proj) : proj(_proj) {}
+    unsigned char projection;
+    projection_mapping(unsigned char _projection) : projection(_projection) {}
+    value_type proj(const carve::geom::vector<ndim>& v) const {
+      return detail::project(projection, v);
+    }
     value_type operator()(const carve::geom::vector<ndim>& v) const {
       return proj(v);
     }
@@ -287,39 +322,41 @@ class Face : public tagable {
     value_type operator()(const Vertex<ndim>* v) const { return proj(v->v); }
   };
 
+  // Selects the projection to 2d used for the face; see project().
+  // Declared first, so that it packs alongside the tag.
+  unsigned char projection;
+
   edge_t* edge;
   size_t n_edges;
   mesh_t* mesh;
   size_t id;
 
   plane_t plane;
-  project_t project;
-  unproject_t unproject;
 
  private:
   Face& operator=(const Face& other);
 
  protected:
   Face()
-      : edge(nullptr),
+      : projection(0),
+        edge(nullptr),
         n_edges(0),
         mesh(nullptr),
         id(0),
-        plane(),
-        project(nullptr),
-        unproject(nullptr) {}
+        plane() {}
 
   Face(const Face& other)
-      : edge(nullptr),
+      : projection(other.projection),
+        edge(nullptr),
         n_edges(other.n_edges),
         mesh(nullptr),
         id(other.id),
-        plane(other.plane),
-        project(other.project),
-        unproject(other.unproject) {}
+        plane(other.plane) {}
 
-  project_t getProjector(bool positive_facing, int axis) const;
-  unproject_t getUnprojector(bool positive_facing, int axis) const;
+  void updateProjection() {
+    int da = carve::geom::largestAxis(plane.N);
+    projection = detail::projectionFor(plane.N.v[da] > 0, da);
+  }
 
  public:
   typedef detail::list_iter_t<Edge<ndim> > edge_iter_t;
@@ -342,6 +379,25 @@ class Face : public tagable {
 
   bool recalc();
 
+  // Replace the face plane without refitting it, for example after a
+  // rigid transformation of the face's vertices.
+  void setPlane(const plane_t& p) {
+    plane = p;
+    updateProjection();
+  }
+
+  // Projects a point to 2d, by dropping the largest axis of the face
+  // normal, such that the face is anticlockwise in projection.
+  carve::geom::vector<2> project(const vector_t& v) const {
+    return detail::project(projection, v);
+  }
+
+  // The inverse of project(), for points on the plane p.
+  vector_t unproject(const carve::geom::vector<2>& v,
+                     const plane_t& p) const {
+    return detail::unproject(projection, v, p);
+  }
+
   void clearEdges();
 
   // build an edge loop in forward orientation from an iterator pair
@@ -365,7 +421,9 @@ class Face : public tagable {
   void getVertices(std::vector<vertex_t*>& verts) const;
   void getProjectedVertices(std::vector<carve::geom::vector<2> >& verts) const;
 
-  projection_mapping projector() const { return projection_mapping(project); }
+  projection_mapping projector() const {
+    return projection_mapping(projection);
+  }
 
   std::pair<double, double> rangeInDirection(const vector_t& v,
                                              const vector_t& b) const {
@@ -389,7 +447,7 @@ class Face : public tagable {
 
   static Face* closeLoop(edge_t* open_edge);
 
-  Face(edge_t* e) : edge(e), n_edges(0), mesh(nullptr) {
+  Face(edge_t* e) : projection(0), edge(e), n_edges(0), mesh(nullptr) {
     do {
       e->face = this;
       n_edges++;
@@ -399,19 +457,20 @@ class Face : public tagable {
   }
 
   Face(vertex_t* a, vertex_t* b, vertex_t* c)
-      : edge(nullptr), n_edges(0), mesh(nullptr) {
+      : projection(0), edge(nullptr), n_edges(0), mesh(nullptr) {
     init(a, b, c);
     recalc();
   }
 
   Face(vertex_t* a, vertex_t* b, vertex_t* c, vertex_t* d)
-      : edge(nullptr), n_edges(0), mesh(nullptr) {
+      : projection(0), edge(nullptr), n_edges(0), mesh(nullptr) {
     init(a, b, c, d);
     recalc();
   }
 
   template <typename iter_t>
-  Face(iter_t begin, iter_t end) : edge(nullptr), n_edges(0), mesh(nullptr) {
+  Face(iter_t begin, iter_t end)
+      : projection(0), edge(nullptr), n_edges(0), mesh(nullptr) {
     init(begin, end);
     recalc();
   }
@@ -461,11 +520,7 @@ class Face : public tagable {
     }
 
     plane.negate();
-
-    int da = carve::geom::largestAxis(plane.N);
-
-    project = getProjector(plane.N.v[da] > 0, da);
-    unproject = getUnprojector(plane.N.v[da] > 0, da);
+    updateProjection();
   }
 
   void canonicalize();
@@ -823,6 +878,14 @@ class MeshSet {
     }
   }
 
+  // Apply a matrix to all vertices. Face planes are refitted in
+  // parallel, or, if the matrix is rigid, transformed directly.
+  void transform(const carve::math::Matrix& matrix);
+
+  void transform(const carve::math::matrix_transformation& t) {
+    transform(t.matrix);
+  }
+
   MeshSet(const std::vector<typename vertex_t::vector_t>& points,
           size_t n_faces, const std::vector<int>& face_indices,
           const MeshOptions& opts = MeshOptions());
@@ -863,6 +926,12 @@ class MeshSet {
 
   void canonicalize();
 
+  // Reorder vertex storage, and the faces of each mesh, along a
+  // Morton (Z-order) curve, so that spatially adjacent elements are
+  // adjacent in memory and in iteration order. Geometry and
+  // topology are unchanged.
+  void reorderSpatially();
+
   void separateMeshes();
 };
 
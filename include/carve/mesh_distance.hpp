@@ -0,0 +1,141 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <carve/mesh.hpp>
+#include <carve/rtree.hpp>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace carve {
+namespace mesh {
+
+// Proximity queries against MeshSet face R-trees. All queries
+// perform a best-first branch-and-bound traversal, ordering nodes
+// by the distance to their bounding boxes, so that only nodes that
+// could contain a closer face than the best found so far are
+// expanded.
+
+typedef carve::geom::RTreeNode<3, Face<3>*> face_rtree_t;
+
+// The result of a proximity query between a point or face and a
+// face of a mesh.
+struct FaceProximity {
+  const Face<3>* face;
+  carve::geom::vector<3> point;
+  double distance2;
+
+  FaceProximity()
+      : face(nullptr),
+        point(),
+        distance2(std::numeric_limits<double>::infinity()) {}
+
+  FaceProximity(const Face<3>* _face, const carve::geom::vector<3>& _point,
+                double _distance2)
+      : face(_face), point(_point), distance2(_distance2) {}
+
+  double distance() const;
+
+  bool operator<(const FaceProximity& other) const {
+    return distance2 < other.distance2;
+  }
+};
+
+// The result of a proximity query between two meshes. point_a
+// lies on face_a, and point_b lies on face_b.
+struct MeshProximity {
+  const Face<3>* face_a;
+  const Face<3>* face_b;
+  carve::geom::vector<3> point_a;
+  carve::geom::vector<3> point_b;
+  double distance2;
+
+  MeshProximity()
+      : face_a(nullptr),
+        face_b(nullptr),
+        point_a(),
+        point_b(),
+        distance2(std::numeric_limits<double>::infinity()) {}
+
+  double distance() const;
+};
+
+// The point on face closest to p. Triangles use the triangle-point
+// distance code in carve::geom; other (planar) faces are handled by
+// projection onto the face plane, falling back to the closest point
+// on the face boundary.
+carve::geom::vector<3> closestPoint(const Face<3>* face,
+                                    const carve::geom::vector<3>& p);
+
+// The squared distance between two faces. pa and pb receive a
+// pair of points (on fa and fb respectively) that realise the
+// distance. Intersecting faces have distance zero.
+double faceDistance2(const Face<3>* fa, const Face<3>* fb,
+                     carve::geom::vector<3>& pa, carve::geom::vector<3>& pb);
+
+// Find the closest point to p on any face in face_rtree. Only
+// faces closer than max_distance are considered; if there are none,
+// false is returned and result is left untouched.
+bool closestPoint(const face_rtree_t* face_rtree,
+                  const carve::geom::vector<3>& p, FaceProximity& result,
+                  double max_distance = std::numeric_limits<double>::infinity());
+
+// Find the (at most) k faces closest to p, ordered by increasing
+// distance.
+void nearestFaces(const face_rtree_t* face_rtree,
+                  const carve::geom::vector<3>& p, size_t k,
+                  std::vector<FaceProximity>& result,
+                  double max_distance = std::numeric_limits<double>::infinity());
+
+// Find the minimum distance between the faces of two face R-trees.
+// Only face pairs closer than max_distance are considered; if there
+// are none, false is returned and result is left untouched.
+bool minimumDistance(const face_rtree_t* a_rtree, const face_rtree_t* b_rtree,
+                     MeshProximity& result,
+                     double max_distance =
+                         std::numeric_limits<double>::infinity());
+
+// Test whether any pair of faces from the two R-trees lies within
+// distance d of each other. Returns as soon as such a pair is found.
+bool withinDistance(const face_rtree_t* a_rtree, const face_rtree_t* b_rtree,
+                    double d);
+
+// Convenience wrappers that build temporary face R-trees.
+bool closestPoint(const MeshSet<3>* meshset, const carve::geom::vector<3>& p,
+                  FaceProximity& result);
+
+void nearestFaces(const MeshSet<3>* meshset, const carve::geom::vector<3>& p,
+                  size_t k, std::vector<FaceProximity>& result);
+
+bool minimumDistance(const MeshSet<3>* a, const MeshSet<3>* b,
+                     MeshProximity& result);
+
+bool withinDistance(const MeshSet<3>* a, const MeshSet<3>* b, double d);
+}  // namespace mesh
+}  // namespace carve
@@ -27,6 +27,7 @@
 #include <carve/djset.hpp>
 #include <carve/geom2d.hpp>
 #include <carve/geom3d.hpp>
+#include <carve/morton.hpp>
 
 #include <deque>
 #include <iostream>
@@ -309,14 +310,13 @@ bool Face<ndim>::recalc() {
 
   int da = carve::geom::largestAxis(plane.N);
   double A = carve::geom2d::signedArea(
-      begin(), end(), projection_mapping(getProjector(false, da)));
+      begin(), end(), projection_mapping(detail::projectionFor(false, da)));
 
   if ((A < 0.0) ^ (plane.N.v[da] < 0.0)) {
     plane.negate();
   }
 
-  project = getProjector(plane.N.v[da] > 0, da);
-  unproject = getUnprojector(plane.N.v[da] > 0, da);
+  projection = detail::projectionFor(plane.N.v[da] > 0, da);
 
   return true;
 }
@@ -470,10 +470,7 @@ Face<ndim>* Face<ndim>::create(iter_t beg, iter_t end, bool reversed) const {
     r->plane = plane;
   }
 
-  int da = carve::geom::largestAxis(r->plane.N);
-
-  r->project = r->getProjector(r->plane.N.v[da] > 0, da);
-  r->unproject = r->getUnprojector(r->plane.N.v[da] > 0, da);
+  r->updateProjection();
 
   return r;
 }
@@ -1032,6 +1029,49 @@ void MeshSet<ndim>::collectVertices() {
   std::swap(vertex_storage, new_vertex_storage);
 }
 
+template <unsigned ndim>
+void MeshSet<ndim>::transform(const carve::math::Matrix& matrix) {
+  typedef typename vertex_t::vector_t vector_t;
+
+  if (!vertex_storage.empty()) {
+    carve::math::transformPoints(matrix, vertex_storage[0].v.v,
+                                 vertex_storage.size(),
+                                 sizeof(vertex_t) / sizeof(double));
+  }
+
+  std::vector<face_t*> faces;
+  for (size_t m = 0; m < meshes.size(); ++m) {
+    faces.insert(faces.end(), meshes[m]->faces.begin(),
+                 meshes[m]->faces.end());
+  }
+  const int N = (int)faces.size();
+
+  if (carve::math::isRigid(matrix)) {
+    // N' = RN and d' = d - N'.t; winding and mesh orientation are
+    // unchanged.
+    const vector_t t = carve::geom::VECTOR(matrix._41, matrix._42, matrix._43);
+#pragma omp parallel for
+    for (int i = 0; i < N; ++i) {
+      face_t* face = faces[i];
+      const vector_t& n = face->plane.N;
+      vector_t n2 = carve::geom::VECTOR(
+          matrix._11 * n.x + matrix._21 * n.y + matrix._31 * n.z,
+          matrix._12 * n.x + matrix._22 * n.y + matrix._32 * n.z,
+          matrix._13 * n.x + matrix._23 * n.y + matrix._33 * n.z);
+      const double d2 = face->plane.d - carve::geom::dot(n2, t);
+      face->setPlane(typename face_t::plane_t(n2, d2));
+    }
+  } else {
+#pragma omp parallel for
+    for (int i = 0; i < N; ++i) {
+      faces[i]->recalc();
+    }
+    for (size_t m = 0; m < meshes.size(); ++m) {
+      meshes[m]->calcOrientation();
+    }
+  }
+}
+
 template <unsigned ndim>
 void MeshSet<ndim>::canonicalize() {
   std::vector<vertex_t*> vptr;
@@ -1065,6 +1105,62 @@ void MeshSet<ndim>::canonicalize() {
   vertex_storage.swap(vout);
 }
 
+template <unsigned ndim>
+void MeshSet<ndim>::reorderSpatially() {
+  const size_t N = vertex_storage.size();
+  if (!N) {
+    return;
+  }
+
+  aabb_t bbox(vertex_storage.begin(), vertex_storage.end());
+  carve::geom::morton_quantizer<ndim> quantizer(bbox);
+
+  std::vector<std::pair<uint64_t, size_t> > vkey;
+  vkey.reserve(N);
+  for (size_t i = 0; i != N; ++i) {
+    vkey.push_back(std::make_pair(quantizer(vertex_storage[i].v), i));
+  }
+  std::sort(vkey.begin(), vkey.end());
+
+  std::vector<vertex_t> vout;
+  std::vector<vertex_t*> vmap;
+  vout.reserve(N);
+  vmap.resize(N);
+
+  for (size_t i = 0; i != N; ++i) {
+    vout.push_back(vertex_storage[vkey[i].second]);
+    vmap[vkey[i].second] = &vout[i];
+  }
+
+  for (face_iter i = faceBegin(); i != faceEnd(); ++i) {
+    for (typename face_t::edge_iter_t j = (*i)->begin(); j != (*i)->end();
+         ++j) {
+      (*j).vert = vmap[(size_t)((*j).vert - &vertex_storage[0])];
+    }
+  }
+
+  vertex_storage.swap(vout);
+
+  std::vector<std::pair<uint64_t, size_t> > fkey;
+  std::vector<face_t*> fout;
+  for (size_t m = 0; m < meshes.size(); ++m) {
+    mesh_t* mesh = meshes[m];
+    fkey.clear();
+    fkey.reserve(mesh->faces.size());
+    for (size_t f = 0; f < mesh->faces.size(); ++f) {
+      fkey.push_back(std::make_pair(quantizer(mesh->faces[f]->centroid()), f));
+    }
+    std::sort(fkey.begin(), fkey.end());
+    fout.clear();
+    fout.reserve(fkey.size());
+    for (size_t f = 0; f < fkey.size(); ++f) {
+      fout.push_back(mesh->faces[fkey[f].second]);
+    }
+    mesh->faces.swap(fout);
+    mesh->cacheEdges();
+  }
+}
+
 template <unsigned ndim>
 void MeshSet<ndim>::separateMeshes() {
   size_t n;
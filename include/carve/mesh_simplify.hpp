@@ -25,6 +25,7 @@
 #pragma once
 
 #include <carve/carve.hpp>
+#include <carve/collection_types.hpp>
 #include <carve/geom2d.hpp>
 #include <carve/heap.hpp>
 #include <carve/mesh.hpp>
@@ -34,6 +35,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <limits>
 #include <set>
 #include <string>
 #include <utility>
@@ -63,6 +65,11 @@ class MeshSimplifier {
     double l[2], t1[2], t2[2];
     size_t heap_idx;
 
+    // the quadric error of collapsing this edge (removing v1 and
+    // moving v2 to target), maintained by decimate().
+    double cost;
+    vector_t target;
+
     void update() {
       const vertex_t* v1 = edge->vert;
       const vertex_t* v2 = edge->next->vert;
@@ -92,9 +99,9 @@ class MeshSimplifier {
       }
     }
 
-    EdgeInfo(edge_t* e) : edge(e) { update(); }
+    EdgeInfo(edge_t* e) : edge(e), cost(0.0) { update(); }
 
-    EdgeInfo() : edge(nullptr) {
+    EdgeInfo() : edge(nullptr), cost(0.0) {
       delta_v = 0.0;
       c[0] = c[1] = c[2] = c[3] = 0.0;
       l[0] = l[1] = 0.0;
@@ -253,7 +260,9 @@ class MeshSimplifier {
 
     EdgeMerger(double _min_edgelen) : min_edgelen(_min_edgelen) {}
 
-    double score(const EdgeInfo* e) const { return min_edgelen - e->l[0]; }
+    virtual double score(const EdgeInfo* e) const {
+      return min_edgelen - e->l[0];
+    }
 
     class Priority {
       Priority& operator=(const Priority&);
@@ -270,6 +279,113 @@ class MeshSimplifier {
     Priority priority() const { return Priority(*this); }
   };
 
+  // Collapses edges in order of increasing quadric error, as long as
+  // it is no more than max_error.
+  struct QuadricMerger : public EdgeMerger {
+    double max_error;
+
+    QuadricMerger(double _max_error)
+        : EdgeMerger(0.0), max_error(_max_error) {}
+
+    bool canMerge(const EdgeInfo* e) const override {
+      return e->cost <= max_error;
+    }
+
+    double score(const EdgeInfo* e) const override { return -e->cost; }
+  };
+
+  // The symmetric 4x4 error quadric [ A b ; b' c ] of Garland and
+  // Heckbert, stored as the upper triangle of A, followed by b and c.
+  struct Quadric {
+    double q[10];
+
+    Quadric() { std::fill(q, q + 10, 0.0); }
+
+    // The squared distance to p, scaled by w.
+    Quadric(const carve::geom::plane<3>& p, double w) {
+      const vector_t& N = p.N;
+      q[0] = w * N.x * N.x;
+      q[1] = w * N.x * N.y;
+      q[2] = w * N.x * N.z;
+      q[3] = w * N.y * N.y;
+      q[4] = w * N.y * N.z;
+      q[5] = w * N.z * N.z;
+      q[6] = w * N.x * p.d;
+      q[7] = w * N.y * p.d;
+      q[8] = w * N.z * p.d;
+      q[9] = w * p.d * p.d;
+    }
+
+    Quadric& operator+=(const Quadric& o) {
+      for (size_t i = 0; i < 10; ++i) {
+        q[i] += o.q[i];
+      }
+      return *this;
+    }
+
+    double error(const vector_t& v) const {
+      return v.x * (q[0] * v.x + 2.0 * (q[1] * v.y + q[2] * v.z + q[6])) +
+             v.y * (q[3] * v.y + 2.0 * (q[4] * v.z + q[7])) +
+             v.z * (q[5] * v.z + 2.0 * q[8]) + q[9];
+    }
+
+    // The point of least error, if A is not (close to) singular.
+    bool minimum(vector_t& v) const {
+      double c00 = q[3] * q[5] - q[4] * q[4];
+      double c01 = q[2] * q[4] - q[1] * q[5];
+      double c02 = q[1] * q[4] - q[2] * q[3];
+      double det = q[0] * c00 + q[1] * c01 + q[2] * c02;
+      double tr = q[0] + q[3] + q[5];
+      if (fabs(det) <= 1e-9 * tr * tr * tr) {
+        return false;
+      }
+      double c11 = q[0] * q[5] - q[2] * q[2];
+      double c12 = q[1] * q[2] - q[0] * q[4];
+      double c22 = q[0] * q[3] - q[1] * q[1];
+      v.x = -(c00 * q[6] + c01 * q[7] + c02 * q[8]) / det;
+      v.y = -(c01 * q[6] + c11 * q[7] + c12 * q[8]) / det;
+      v.z = -(c02 * q[6] + c12 * q[7] + c22 * q[8]) / det;
+      return true;
+    }
+  };
+
+  // Per vertex state for decimate(), indexed by position in the
+  // vertex storage of the meshset.
+  struct DecimationState {
+    meshset_t* meshset;
+    std::vector<Quadric> quadrics;
+    std::vector<char> locked;
+    // the half edges that start or end at each vertex.
+    std::vector<std::vector<EdgeInfo*> > vert_edges;
+    // the batch that last claimed each vertex (batched mode only).
+    std::vector<size_t> mark;
+
+    DecimationState(meshset_t* _meshset)
+        : meshset(_meshset),
+          quadrics(_meshset->vertex_storage.size()),
+          locked(_meshset->vertex_storage.size(), 0),
+          vert_edges(_meshset->vertex_storage.size()) {}
+
+    size_t idx(const vertex_t* v) const {
+      return (size_t)(v - &meshset->vertex_storage[0]);
+    }
+  };
+
+  // An edge collapse taken from the heap by decimate(): the faces
+  // around it, and once it is applied, the vertex that remains and
+  // the edges and faces that were removed.
+  struct Collapse {
+    EdgeInfo* e;
+    bool ok;
+    aabb_t aabb;
+    const vertex_t* vert;
+    std::vector<face_t*> faces;
+    std::vector<EdgeInfo*> removed_edges;
+    std::vector<face_t*> removed_faces;
+    // scratch space for canCollapse().
+    std::vector<const vertex_t*> n1, n2, common;
+  };
+
   typedef std::unordered_map<edge_t*, EdgeInfo*> edge_info_map_t;
   std::unordered_map<edge_t*, EdgeInfo*> edge_info;
 
@@ -295,6 +411,15 @@ class MeshSimplifier {
          ++i) {
       delete (*i).second;
     }
+    edge_info.clear();
+  }
+
+  // Returns the EdgeInfo of an edge that must have one. The map is only
+  // read, so this is safe within the parallel loops.
+  EdgeInfo* findEdgeInfo(edge_t* edge) const {
+    edge_info_map_t::const_iterator i = edge_info.find(edge);
+    CARVE_ASSERT(i != edge_info.end());
+    return (*i).second;
   }
 
   void updateEdgeFlipHeap(std::vector<EdgeInfo*>& edge_heap, edge_t* edge,
@@ -480,6 +605,10 @@ class MeshSimplifier {
     face_rtree_t* tree = face_rtree_t::construct_STR(meshset->faceBegin(),
                                                      meshset->faceEnd(), 4, 4);
 
+    std::vector<face_t*> near_faces;
+    carve::geom::triangle_packet packet;
+    std::vector<carve::geom::TriangleIntType> result;
+
     for (meshset_t::face_iter f = meshset->faceBegin(); f != meshset->faceEnd();
          ++f) {
       face_t* fa = *f;
@@ -492,9 +621,10 @@ class MeshSimplifier {
       tri_a[1] = fa->edge->next->vert->v;
       tri_a[2] = fa->edge->next->next->vert->v;
 
-      std::vector<face_t*> near_faces;
+      near_faces.clear();
       tree->search(fa->getAABB(), std::back_inserter(near_faces));
 
+      packet.clear();
       for (size_t f2 = 0; f2 < near_faces.size(); ++f2) {
         const face_t* fb = near_faces[f2];
         if (fb->nVertices() != 3) {
@@ -505,16 +635,16 @@ class MeshSimplifier {
           continue;
         }
 
-        vector_t tri_b[3];
-        tri_b[0] = fb->edge->vert->v;
-        tri_b[1] = fb->edge->next->vert->v;
-        tri_b[2] = fb->edge->next->next->vert->v;
+        packet.push_back(fb->edge->vert->v, fb->edge->next->vert->v,
+                         fb->edge->next->next->vert->v);
+      }
 
-        if (carve::geom::triangle_intersection_exact(tri_a, tri_b) ==
-            carve::geom::TR_TYPE_INT) {
-          ++n_ints;
-        }
+      result.resize(packet.size());
+      if (!packet.empty()) {
+        carve::geom::triangle_intersection_exact(tri_a, packet, &result[0]);
       }
+      n_ints += (int)std::count(result.begin(), result.end(),
+                                carve::geom::TR_TYPE_INT);
     }
 
     delete tree;
@@ -522,6 +652,26 @@ class MeshSimplifier {
     return n_ints;
   }
 
+  // The change in the number of self intersections from flipping
+  // edge, counted against the faces found in the tree within aabb.
+  int flipIntersectionDelta(const edge_t* edge, const aabb_t& aabb,
+                            const face_rtree_t* tree) {
+    std::vector<face_t*> overlapping;
+    tree->search(aabb, std::back_inserter(overlapping));
+
+    const vertex_t* v1 = edge->vert;
+    const vertex_t* v2 = edge->next->vert;
+    const vertex_t* v3 = edge->next->next->vert;
+    const vertex_t* v4 = edge->rev->next->next->vert;
+
+    int n_int1 = countIntersections(v1, v2, v3, overlapping);
+    int n_int2 = countIntersections(v2, v1, v4, overlapping);
+    int n_int3 = countIntersections(v3, v4, v2, overlapping);
+    int n_int4 = countIntersections(v4, v3, v1, overlapping);
+
+    return (n_int3 + n_int4) - (n_int1 + n_int2);
+  }
+
   size_t flipEdges(meshset_t* mesh, const FlippableBase& flipper) {
     face_rtree_t* tree =
         face_rtree_t::construct_STR(mesh->faceBegin(), mesh->faceEnd(), 4, 4);
@@ -546,72 +696,93 @@ class MeshSimplifier {
     carve::heap::make_heap(edge_heap.begin(), edge_heap.end(),
                            flipper.priority(), EdgeInfo::NotifyPos());
 
-    while (edge_heap.size()) {
-      //           std::cerr << "test" << std::endl;
-      //           for (size_t m = 0; m < mesh->meshes.size(); ++m) {
-      //             for (size_t f = 0; f < mesh->meshes[m]->faces.size(); ++f)
-      //             {
-      //               if (mesh->meshes[m]->faces[f]->edge)
-      //               mesh->meshes[m]->faces[f]->edge->validateLoop();
-      //             }
-      //           }
+    const size_t limit = std::max(batch_size, (size_t)1);
+    std::vector<EdgeInfo*> batch, deferred;
+    std::vector<aabb_t> batch_aabb;
+    std::vector<int> delta;
 
-      carve::heap::pop_heap(edge_heap.begin(), edge_heap.end(),
-                            flipper.priority(), EdgeInfo::NotifyPos());
-      EdgeInfo* e = edge_heap.back();
-      //           std::cerr << "flip " << e << std::endl;
-      edge_heap.pop_back();
-      e->heap_idx = ~0U;
+    while (edge_heap.size()) {
+      // take the best flips whose pairs of faces have disjoint
+      // bounding boxes. No flip in the batch can then affect another,
+      // so checking each against the unmodified mesh is exact.
+      batch.clear();
+      batch_aabb.clear();
+      deferred.clear();
+
+      while (edge_heap.size() && batch.size() < limit &&
+             deferred.size() < limit) {
+        carve::heap::pop_heap(edge_heap.begin(), edge_heap.end(),
+                              flipper.priority(), EdgeInfo::NotifyPos());
+        EdgeInfo* e = edge_heap.back();
+        edge_heap.pop_back();
+        e->heap_idx = ~0U;
 
-      aabb_t aabb;
-      aabb = e->edge->face->getAABB();
-      aabb.unionAABB(e->edge->rev->face->getAABB());
+        aabb_t aabb;
+        aabb = e->edge->face->getAABB();
+        aabb.unionAABB(e->edge->rev->face->getAABB());
 
-      std::vector<face_t*> overlapping;
-      tree->search(aabb, std::back_inserter(overlapping));
+        bool independent = true;
+        for (size_t i = 0; independent && i < batch_aabb.size(); ++i) {
+          independent = !batch_aabb[i].intersects(aabb);
+        }
+        if (independent) {
+          batch.push_back(e);
+          batch_aabb.push_back(aabb);
+        } else {
+          deferred.push_back(e);
+        }
+      }
 
-      // overlapping.erase(e->edge->face);
-      // overlapping.erase(e->edge->rev->face);
+      for (size_t i = 0; i < deferred.size(); ++i) {
+        updateEdgeFlipHeap(edge_heap, deferred[i]->edge, flipper);
+      }
 
-      const vertex_t* v1 = e->edge->vert;
-      const vertex_t* v2 = e->edge->next->vert;
-      const vertex_t* v3 = e->edge->next->next->vert;
-      const vertex_t* v4 = e->edge->rev->next->next->vert;
+      const int N = (int)batch.size();
+      delta.resize(batch.size());
 
-      int n_int1 = countIntersections(v1, v2, v3, overlapping);
-      int n_int2 = countIntersections(v2, v1, v4, overlapping);
-      int n_int3 = countIntersections(v3, v4, v2, overlapping);
-      int n_int4 = countIntersections(v4, v3, v1, overlapping);
+      carve::ParallelExceptionCapture errors;
 
-      if ((n_int3 + n_int4) - (n_int1 + n_int2) > 0) {
-        std::cerr << "delta[ints] = " << (n_int3 + n_int4) - (n_int1 + n_int2)
-                  << std::endl;
-        // avoid creating a self intersection.
-        continue;
+#pragma omp parallel for schedule(dynamic, 4) if (N > 1)
+      for (int i = 0; i < N; ++i) {
+        try {
+          delta[i] =
+              flipIntersectionDelta(batch[i]->edge, batch_aabb[i], tree);
+        } catch (...) {
+          errors.capture();
+        }
       }
+      errors.rethrow();
 
-      n_mods++;
-      CARVE_ASSERT(flipper.canFlip(e));
-      edge_info[e->edge]->update();
-      edge_info[e->edge->rev]->update();
+      for (size_t i = 0; i < batch.size(); ++i) {
+        EdgeInfo* e = batch[i];
 
-      carve::mesh::flipTriEdge(e->edge);
+        if (delta[i] > 0) {
+          std::cerr << "delta[ints] = " << delta[i] << std::endl;
+          // avoid creating a self intersection.
+          continue;
+        }
 
-      tree->updateExtents(aabb);
+        n_mods++;
+        CARVE_ASSERT(flipper.canFlip(e));
+
+        carve::mesh::flipTriEdge(e->edge);
 
-      updateEdgeFlipHeap(edge_heap, e->edge, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->rev, flipper);
+        tree->updateExtents(batch_aabb[i]);
 
-      CARVE_ASSERT(!flipper.canFlip(e));
+        updateEdgeFlipHeap(edge_heap, e->edge, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->rev, flipper);
 
-      updateEdgeFlipHeap(edge_heap, e->edge->next, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->next->next, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->rev->next, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->rev->next->next, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->next->rev, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->next->next->rev, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->rev->next->rev, flipper);
-      updateEdgeFlipHeap(edge_heap, e->edge->rev->next->next->rev, flipper);
+        CARVE_ASSERT(!flipper.canFlip(e));
+
+        updateEdgeFlipHeap(edge_heap, e->edge->next, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->next->next, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->rev->next, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->rev->next->next, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->next->rev, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->next->next->rev, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->rev->next->rev, flipper);
+        updateEdgeFlipHeap(edge_heap, e->edge->rev->next->next->rev, flipper);
+      }
     }
 
     delete tree;
@@ -1165,7 +1336,359 @@ class MeshSimplifier {
     return 0;
   }
 
+  // Accumulate an area weighted quadric for each vertex, and lock
+  // vertices that decimation must not move: those on open edges,
+  // on non-triangular faces, on edges in shared_edges, or shared by
+  // more than one mesh.
+  size_t initDecimation(DecimationState& st,
+                        const carve::csg::V2Set* shared_edges) {
+    meshset_t* meshset = st.meshset;
+    std::vector<const mesh_t*> owner(meshset->vertex_storage.size(),
+                                     nullptr);
+    size_t n_faces = 0;
+
+    for (size_t m = 0; m < meshset->meshes.size(); ++m) {
+      const mesh_t* mesh = meshset->meshes[m];
+      for (size_t f = 0; f < mesh->faces.size(); ++f) {
+        face_t* face = mesh->faces[f];
+        bool tri = face->nVertices() == 3;
+        ++n_faces;
+
+        Quadric q;
+        if (tri) {
+          const vector_t& a = face->edge->vert->v;
+          const vector_t& b = face->edge->next->vert->v;
+          const vector_t& c = face->edge->next->next->vert->v;
+          double area = carve::geom::cross(b - a, c - a).length() / 2.0;
+          q = Quadric(face->plane, area);
+        }
+
+        edge_t* e = face->edge;
+        do {
+          size_t v = st.idx(e->vert);
+          if (owner[v] == nullptr) {
+            owner[v] = mesh;
+          } else if (owner[v] != mesh) {
+            st.locked[v] = 1;
+          }
+          if (!tri || e->rev == nullptr) {
+            st.locked[v] = 1;
+            st.locked[st.idx(e->v2())] = 1;
+          }
+          st.quadrics[v] += q;
+          e = e->next;
+        } while (e != face->edge);
+      }
+    }
+
+    if (shared_edges != nullptr) {
+      for (carve::csg::V2Set::const_iterator i = shared_edges->begin();
+           i != shared_edges->end(); ++i) {
+        st.locked[st.idx((*i).first)] = 1;
+        st.locked[st.idx((*i).second)] = 1;
+      }
+    }
+
+    for (edge_info_map_t::iterator i = edge_info.begin(); i != edge_info.end();
+         ++i) {
+      EdgeInfo* e = (*i).second;
+      st.vert_edges[st.idx(e->edge->v1())].push_back(e);
+      st.vert_edges[st.idx(e->edge->v2())].push_back(e);
+    }
+
+    return n_faces;
+  }
+
+  // Set the target and cost of collapsing e. The target minimises
+  // the summed quadric of both vertices, falling back to the best of
+  // the end points and mid point when the quadric is singular.
+  void updateCollapseCost(const DecimationState& st, EdgeInfo* e) {
+    const vertex_t* v1 = e->edge->v1();
+    const vertex_t* v2 = e->edge->v2();
+    size_t i1 = st.idx(v1);
+    size_t i2 = st.idx(v2);
+
+    if (st.locked[i1]) {
+      e->cost = std::numeric_limits<double>::infinity();
+      return;
+    }
+
+    Quadric q = st.quadrics[i1];
+    q += st.quadrics[i2];
+
+    if (st.locked[i2]) {
+      e->target = v2->v;
+      e->cost = q.error(e->target);
+    } else if (q.minimum(e->target)) {
+      e->cost = q.error(e->target);
+    } else {
+      const vector_t c[3] = {v1->v, v2->v, (v1->v + v2->v) / 2.0};
+      e->cost = std::numeric_limits<double>::infinity();
+      for (size_t i = 0; i < 3; ++i) {
+        double err = q.error(c[i]);
+        if (err < e->cost) {
+          e->cost = err;
+          e->target = c[i];
+        }
+      }
+    }
+    e->cost = std::max(e->cost, 0.0);
+  }
+
+  // Update the costs of both halves of e's edge. Only the cheaper
+  // direction is a candidate for collapse; the other is given an
+  // infinite cost, so that each edge is queued once.
+  void updateEdgeCosts(const DecimationState& st, EdgeInfo* e) {
+    updateCollapseCost(st, e);
+    if (e->edge->rev == nullptr) {
+      return;
+    }
+    EdgeInfo* r = findEdgeInfo(e->edge->rev);
+    updateCollapseCost(st, r);
+    if (r->cost < e->cost || (r->cost == e->cost && r->edge < e->edge)) {
+      e->cost = std::numeric_limits<double>::infinity();
+    } else {
+      r->cost = std::numeric_limits<double>::infinity();
+    }
+  }
+
+  void vertexNeighbours(const DecimationState& st, const vertex_t* v,
+                        std::vector<const vertex_t*>& out) {
+    const std::vector<EdgeInfo*>& edges = st.vert_edges[st.idx(v)];
+    out.clear();
+    for (size_t i = 0; i < edges.size(); ++i) {
+      const edge_t* e = edges[i]->edge;
+      out.push_back(e->v1() == v ? e->v2() : e->v1());
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+  }
+
+  // The faces incident to v1 or v2 (in sorted order).
+  void collapseFaces(const DecimationState& st, const vertex_t* v1,
+                     const vertex_t* v2, std::vector<face_t*>& out) {
+    const std::vector<EdgeInfo*>& e1 = st.vert_edges[st.idx(v1)];
+    const std::vector<EdgeInfo*>& e2 = st.vert_edges[st.idx(v2)];
+    out.clear();
+    for (size_t i = 0; i < e1.size(); ++i) {
+      out.push_back(e1[i]->edge->face);
+    }
+    for (size_t i = 0; i < e2.size(); ++i) {
+      out.push_back(e2[i]->edge->face);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+  }
+
+  aabb_t collapseAABB(const std::vector<face_t*>& faces,
+                      const vector_t& target) {
+    vector_t aabb_min = target, aabb_max = target;
+    for (size_t i = 0; i < faces.size(); ++i) {
+      const edge_t* e = faces[i]->edge;
+      do {
+        assign_op(aabb_min, aabb_min, e->vert->v, carve::util::min_functor());
+        assign_op(aabb_max, aabb_max, e->vert->v, carve::util::max_functor());
+        e = e->next;
+      } while (e != faces[i]->edge);
+    }
+    aabb_t aabb;
+    aabb.fit(aabb_min, aabb_max);
+    return aabb;
+  }
+
+  // True if collapsing c.e keeps the mesh manifold (the end points
+  // share exactly the two opposite vertices as neighbours, and
+  // those keep at least three neighbours), flips no face, and (if
+  // tree is not null) adds no self intersections with the faces
+  // within c.aabb.
+  bool canCollapse(const DecimationState& st, Collapse& c,
+                   const face_rtree_t* tree) {
+    const EdgeInfo* e = c.e;
+    const std::vector<face_t*>& faces = c.faces;
+    const edge_t* edge = e->edge;
+    if (edge->rev == nullptr) {
+      return false;
+    }
+    const vertex_t* v1 = edge->v1();
+    const vertex_t* v2 = edge->v2();
+    const vertex_t* v3 = edge->next->next->vert;
+    const vertex_t* v4 = edge->rev->next->next->vert;
+    if (v3 == v4) {
+      return false;
+    }
+
+    std::vector<const vertex_t*>& n1 = c.n1;
+    std::vector<const vertex_t*>& n2 = c.n2;
+    std::vector<const vertex_t*>& common = c.common;
+    vertexNeighbours(st, v1, n1);
+    vertexNeighbours(st, v2, n2);
+    common.clear();
+    std::set_intersection(n1.begin(), n1.end(), n2.begin(), n2.end(),
+                          std::back_inserter(common));
+    if (common.size() != 2) {
+      return false;
+    }
+    vertexNeighbours(st, v3, n1);
+    vertexNeighbours(st, v4, n2);
+    if (n1.size() <= 3 || n2.size() <= 3) {
+      return false;
+    }
+
+    for (size_t i = 0; i < faces.size(); ++i) {
+      face_t* face = faces[i];
+      if (face == edge->face || face == edge->rev->face) {
+        continue;
+      }
+      vector_t tri[3];
+      mapTriangle(face, v1, v2, e->target, tri);
+      const edge_t* fe = face->edge;
+      vector_t n_pre = carve::geom::cross(fe->next->vert->v - fe->vert->v,
+                                          fe->prev->vert->v - fe->vert->v);
+      vector_t n_post = carve::geom::cross(tri[1] - tri[0], tri[2] - tri[0]);
+      if (carve::geom::dot(n_pre, n_post) <= 0.0) {
+        return false;
+      }
+    }
+
+    if (tree != nullptr) {
+      std::vector<face_t*> near_faces;
+      tree->search(c.aabb, std::back_inserter(near_faces));
+      int i1 =
+          countIntersectionPairs(faces.begin(), faces.end(), near_faces.begin(),
+                                 near_faces.end(), nullptr, nullptr, e->target);
+      int i2 = countIntersectionPairs(faces.begin(), faces.end(),
+                                      near_faces.begin(), near_faces.end(), v1,
+                                      v2, e->target);
+      if (i2 > i1) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void removeVertEdge(DecimationState& st, const vertex_t* v, EdgeInfo* e) {
+    std::vector<EdgeInfo*>& edges = st.vert_edges[st.idx(v)];
+    std::vector<EdgeInfo*>::iterator i =
+        std::find(edges.begin(), edges.end(), e);
+    if (i != edges.end()) {
+      *i = edges.back();
+      edges.pop_back();
+    }
+  }
+
+  // Claim the end points of e and their neighbours for the batch
+  // numbered stamp. Fails, claiming nothing, if another collapse in
+  // the batch has claimed any of them. Collapses with disjoint
+  // claims modify disjoint parts of the mesh.
+  bool claimNeighbourhood(DecimationState& st, const EdgeInfo* e,
+                          size_t stamp) {
+    const vertex_t* v[2] = {e->edge->v1(), e->edge->v2()};
+    for (size_t pass = 0; pass < 2; ++pass) {
+      for (size_t i = 0; i < 2; ++i) {
+        const std::vector<EdgeInfo*>& edges = st.vert_edges[st.idx(v[i])];
+        for (size_t j = 0; j < edges.size(); ++j) {
+          size_t a = st.idx(edges[j]->edge->v1());
+          size_t b = st.idx(edges[j]->edge->v2());
+          if (pass == 0) {
+            if (st.mark[a] == stamp || st.mark[b] == stamp) {
+              return false;
+            }
+          } else {
+            st.mark[a] = st.mark[b] = stamp;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  // Collapse c.e, removing v1 and moving v2 to its target, and
+  // update the costs of the edges around v2. The removed edges and
+  // (now two sided) faces are recorded in c, but left in edge_info,
+  // the heap and the tree, so collapses with disjoint neighbourhoods
+  // can be applied in parallel.
+  void collapseEdge(DecimationState& st, Collapse& c) {
+    EdgeInfo* e = c.e;
+    vertex_t* v1 = e->edge->v1();
+    vertex_t* v2 = e->edge->v2();
+    size_t i1 = st.idx(v1);
+    size_t i2 = st.idx(v2);
+
+    c.vert = v2;
+    c.removed_edges.clear();
+    c.removed_faces.clear();
+
+    EdgeInfo* merged[2] = {e, findEdgeInfo(e->edge->rev)};
+
+    v2->v = e->target;
+    st.quadrics[i2] += st.quadrics[i1];
+
+    std::vector<EdgeInfo*>& v1_edges = st.vert_edges[i1];
+    std::vector<EdgeInfo*>& v2_edges = st.vert_edges[i2];
+    for (size_t i = 0; i < v1_edges.size(); ++i) {
+      EdgeInfo* h = v1_edges[i];
+      if (h == merged[0] || h == merged[1]) {
+        continue;
+      }
+      if (h->edge->vert == v1) {
+        h->edge->vert = v2;
+      }
+      v2_edges.push_back(h);
+    }
+    v1_edges.clear();
+
+    for (size_t i = 0; i < 2; ++i) {
+      EdgeInfo* m = merged[i];
+
+      removeVertEdge(st, v2, m);
+      c.removed_edges.push_back(m);
+
+      face_t* f1 = m->edge->face;
+
+      m->edge->removeHalfEdge();
+
+      if (f1->n_edges == 2) {
+        edge_t* e1 = f1->edge;
+        edge_t* e2 = f1->edge->next;
+        if (e1->rev) {
+          e1->rev->rev = e2->rev;
+        }
+        if (e2->rev) {
+          e2->rev->rev = e1->rev;
+        }
+        EdgeInfo* e1i = findEdgeInfo(e1);
+        EdgeInfo* e2i = findEdgeInfo(e2);
+        removeVertEdge(st, e1->v1(), e1i);
+        removeVertEdge(st, e1->v2(), e1i);
+        removeVertEdge(st, e2->v1(), e2i);
+        removeVertEdge(st, e2->v2(), e2i);
+        c.removed_edges.push_back(e1i);
+        c.removed_edges.push_back(e2i);
+        c.removed_faces.push_back(f1);
+      }
+    }
+
+    // both halves of each interior edge are in v2_edges, so update
+    // costs from the outgoing half.
+    for (size_t i = 0; i < v2_edges.size(); ++i) {
+      if (v2_edges[i]->edge->vert == v2) {
+        updateEdgeCosts(st, v2_edges[i]);
+      }
+    }
+  }
+
  public:
+  // The number of edge flips (in improveMesh()) or collapses (in
+  // decimate()) taken from the heap at a time. Operations in a batch
+  // have disjoint neighbourhoods, and are checked and collapses
+  // applied in parallel when built with OpenMP. Larger batches give
+  // more parallelism, but depart further from strict priority order.
+  // The default of 1 applies operations one at a time.
+  size_t batch_size;
+
+  MeshSimplifier() : batch_size(1) {}
+
   // Merge adjacent coplanar faces (where coplanar is determined
   // by dot-product >= cos(min_normal_angle)).
   size_t mergeCoplanarFaces(meshset_t* meshset, double min_normal_angle) {
@@ -1203,6 +1726,193 @@ class MeshSimplifier {
     return modifications;
   }
 
+  // Decimate triangle meshes by quadric error edge collapse, until no
+  // more than target_faces faces remain, or no collapse has an error
+  // of at most max_error. Open edges, edges in shared_edges,
+  // non-triangular faces and vertices shared between meshes are left
+  // in place. If check_intersections is set, collapses that would
+  // add self intersections (found through a face R-tree) are
+  // rejected. Returns the number of edges collapsed.
+  size_t decimate(meshset_t* meshset, size_t target_faces,
+                  double max_error = std::numeric_limits<double>::max(),
+                  bool check_intersections = false,
+                  const carve::csg::V2Set* shared_edges = nullptr) {
+    if (meshset->vertex_storage.empty()) {
+      return 0;
+    }
+
+    initEdgeInfo(meshset);
+
+    DecimationState st(meshset);
+    size_t n_faces = initDecimation(st, shared_edges);
+
+    face_rtree_t* tree = nullptr;
+    if (check_intersections) {
+      tree = face_rtree_t::construct_STR(meshset->faceBegin(),
+                                         meshset->faceEnd(), 4, 4);
+    }
+
+    QuadricMerger merger(max_error);
+    std::vector<EdgeInfo*> edge_heap;
+    edge_heap.reserve(edge_info.size());
+
+    for (edge_info_map_t::iterator i = edge_info.begin(); i != edge_info.end();
+         ++i) {
+      EdgeInfo* e = (*i).second;
+      if (e->edge->rev == nullptr || e->edge < e->edge->rev) {
+        updateEdgeCosts(st, e);
+      }
+    }
+
+    for (edge_info_map_t::iterator i = edge_info.begin(); i != edge_info.end();
+         ++i) {
+      EdgeInfo* e = (*i).second;
+      if (merger.canMerge(e)) {
+        edge_heap.push_back(e);
+      } else {
+        e->heap_idx = ~0U;
+      }
+    }
+
+    carve::heap::make_heap(edge_heap.begin(), edge_heap.end(),
+                           merger.priority(), EdgeInfo::NotifyPos());
+
+    const size_t limit = std::max(batch_size, (size_t)1);
+    if (limit > 1) {
+      st.mark.assign(meshset->vertex_storage.size(), 0);
+    }
+
+    size_t n_mods = 0;
+    size_t n_batches = 0;
+    std::vector<Collapse> batch(limit);
+    std::vector<EdgeInfo*> deferred;
+
+    while (n_faces > target_faces && edge_heap.size()) {
+      // take the best collapses whose neighbourhoods are disjoint.
+      // Each collapse removes two faces.
+      size_t n = 0;
+      ++n_batches;
+      deferred.clear();
+
+      while (n < limit && deferred.size() < limit && edge_heap.size() &&
+             n_faces > target_faces + 2 * n) {
+        carve::heap::pop_heap(edge_heap.begin(), edge_heap.end(),
+                              merger.priority(), EdgeInfo::NotifyPos());
+        EdgeInfo* e = edge_heap.back();
+        edge_heap.pop_back();
+        e->heap_idx = ~0U;
+
+        if (limit > 1 && !claimNeighbourhood(st, e, n_batches)) {
+          deferred.push_back(e);
+          continue;
+        }
+        batch[n++].e = e;
+      }
+
+      for (size_t i = 0; i < deferred.size(); ++i) {
+        updateEdgeMergeHeap(edge_heap, deferred[i], merger);
+      }
+
+      const int N = (int)n;
+
+      carve::ParallelExceptionCapture errors;
+
+#pragma omp parallel for schedule(dynamic, 4) if (N > 1)
+      for (int i = 0; i < N; ++i) {
+        try {
+          Collapse& c = batch[i];
+          collapseFaces(st, c.e->edge->v1(), c.e->edge->v2(), c.faces);
+          if (tree != nullptr) {
+            c.aabb = collapseAABB(c.faces, c.e->target);
+          }
+          c.ok = canCollapse(st, c, tree);
+        } catch (...) {
+          errors.capture();
+        }
+      }
+      errors.rethrow();
+
+      // each collapse was checked for self intersections against the
+      // unmodified mesh, which is only exact if no other collapse in
+      // the batch changes the mesh within its bounding box.
+      if (tree != nullptr && n > 1) {
+        std::vector<const aabb_t*> kept;
+        for (size_t i = 0; i < n; ++i) {
+          Collapse& c = batch[i];
+          if (!c.ok) {
+            continue;
+          }
+          for (size_t j = 0; c.ok && j < kept.size(); ++j) {
+            c.ok = !kept[j]->intersects(c.aabb);
+          }
+          if (c.ok) {
+            kept.push_back(&c.aabb);
+          } else {
+            updateEdgeMergeHeap(edge_heap, c.e, merger);
+          }
+        }
+      }
+
+#pragma omp parallel for schedule(dynamic, 4) if (N > 1)
+      for (int i = 0; i < N; ++i) {
+        try {
+          if (batch[i].ok) {
+            collapseEdge(st, batch[i]);
+          }
+        } catch (...) {
+          errors.capture();
+        }
+      }
+      errors.rethrow();
+
+      for (size_t i = 0; i < n; ++i) {
+        Collapse& c = batch[i];
+        if (!c.ok) {
+          continue;
+        }
+
+        for (size_t j = 0; j < c.removed_edges.size(); ++j) {
+          EdgeInfo* r = c.removed_edges[j];
+          removeFromEdgeMergeHeap(edge_heap, r, merger);
+          // the half edge has been deleted, but its address is still
+          // the key.
+          edge_info.erase(r->edge);
+          delete r;
+        }
+
+        if (tree != nullptr) {
+          for (size_t j = 0; j < c.removed_faces.size(); ++j) {
+            tree->remove(c.removed_faces[j], c.aabb);
+          }
+          tree->updateExtents(c.aabb);
+        }
+        for (size_t j = 0; j < c.removed_faces.size(); ++j) {
+          c.removed_faces[j]->clearEdges();
+        }
+
+        const std::vector<EdgeInfo*>& v2_edges = st.vert_edges[st.idx(c.vert)];
+        for (size_t j = 0; j < v2_edges.size(); ++j) {
+          updateEdgeMergeHeap(edge_heap, v2_edges[j], merger);
+        }
+
+        n_faces -= c.removed_faces.size();
+        ++n_mods;
+      }
+    }
+
+    delete tree;
+
+    removeRemnantFaces(meshset);
+    clearEdgeInfo();
+
+    for (size_t i = 0; i < meshset->meshes.size(); ++i) {
+      meshset->meshes[i]->cacheEdges();
+      meshset->meshes[i]->recalc();
+    }
+
+    return n_mods;
+  }
+
   // Snap vertices to grid, aligning almost flat axis-aligned
   // faces to the axis, and flattening other faces as much as is
   // possible. Passing a number less than DBL_MIN_EXPONENT (-1021)
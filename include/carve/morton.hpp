@@ -0,0 +1,219 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <carve/aabb.hpp>
+#include <carve/geom.hpp>
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace carve {
+namespace geom {
+
+// Morton (Z-order) codes. A point is quantized onto a grid of
+// 2^bits cells per axis covering a bounding box, and the bits of the
+// resulting integer coordinates are interleaved, so that points that
+// are close in space tend to have close codes. Sorting by Morton
+// code therefore places spatially adjacent objects next to each
+// other.
+template <unsigned ndim>
+struct morton {
+  // coordinates are 32 bit, and codes are 64 bit.
+  enum { bits = 63 / ndim < 32 ? 63 / ndim : 32 };
+
+  static uint64_t encode(const uint32_t* c) {
+    uint64_t r = 0;
+    for (unsigned b = 0; b < bits; ++b) {
+      for (unsigned i = 0; i < ndim; ++i) {
+        r |= (uint64_t)((c[i] >> b) & 1) << (b * ndim + i);
+      }
+    }
+    return r;
+  }
+
+  static void decode(uint64_t code, uint32_t* c) {
+    for (unsigned i = 0; i < ndim; ++i) {
+      c[i] = 0;
+    }
+    for (unsigned b = 0; b < bits; ++b) {
+      for (unsigned i = 0; i < ndim; ++i) {
+        c[i] |= (uint32_t)((code >> (b * ndim + i)) & 1) << b;
+      }
+    }
+  }
+};
+
+template <>
+struct morton<3> {
+  enum { bits = 21 };
+
+  // spread the low 21 bits of x so that there are two zero bits
+  // between each.
+  static uint64_t spread(uint32_t x) {
+    uint64_t r = x & 0x1fffff;
+    r = (r | r << 32) & 0x001f00000000ffffULL;
+    r = (r | r << 16) & 0x001f0000ff0000ffULL;
+    r = (r | r << 8) & 0x100f00f00f00f00fULL;
+    r = (r | r << 4) & 0x10c30c30c30c30c3ULL;
+    r = (r | r << 2) & 0x1249249249249249ULL;
+    return r;
+  }
+
+  static uint32_t compact(uint64_t r) {
+    r &= 0x1249249249249249ULL;
+    r = (r ^ (r >> 2)) & 0x10c30c30c30c30c3ULL;
+    r = (r ^ (r >> 4)) & 0x100f00f00f00f00fULL;
+    r = (r ^ (r >> 8)) & 0x001f0000ff0000ffULL;
+    r = (r ^ (r >> 16)) & 0x001f00000000ffffULL;
+    r = (r ^ (r >> 32)) & 0x00000000001fffffULL;
+    return (uint32_t)r;
+  }
+
+  static uint64_t encode(const uint32_t* c) {
+    return spread(c[0]) | (spread(c[1]) << 1) | (spread(c[2]) << 2);
+  }
+
+  static void decode(uint64_t code, uint32_t* c) {
+    c[0] = compact(code);
+    c[1] = compact(code >> 1);
+    c[2] = compact(code >> 2);
+  }
+};
+
+// Maps points within a bounding box to Morton codes.
+template <unsigned ndim>
+struct morton_quantizer {
+  typedef vector<ndim> vector_t;
+
+  vector_t base;
+  vector_t scale;
+
+  morton_quantizer(const aabb<ndim>& bbox) : base(bbox.min()) {
+    const double cells = (double)(((uint64_t)1 << morton<ndim>::bits) - 1);
+    for (unsigned i = 0; i < ndim; ++i) {
+      double len = 2.0 * bbox.extent.v[i];
+      scale.v[i] = len > 0.0 ? cells / len : 0.0;
+    }
+  }
+
+  uint32_t quantize(const vector_t& v, unsigned i) const {
+    const double cells = (double)(((uint64_t)1 << morton<ndim>::bits) - 1);
+    double c = (v.v[i] - base.v[i]) * scale.v[i];
+    if (!(c > 0.0)) {
+      return 0;
+    }
+    if (c > cells) {
+      c = cells;
+    }
+    return (uint32_t)c;
+  }
+
+  uint64_t operator()(const vector_t& v) const {
+    uint32_t c[ndim];
+    for (unsigned i = 0; i < ndim; ++i) {
+      c[i] = quantize(v, i);
+    }
+    return morton<ndim>::encode(c);
+  }
+};
+
+// Sort (key, value) pairs by key with a least significant digit
+// radix sort, 8 bits per pass. Passes above key_bits are skipped, as
+// are passes in which every key has the same digit. For large
+// inputs, and when built with OpenMP, each pass histograms and
+// scatters contiguous blocks of the input in parallel. The sort is
+// stable.
+template <typename value_t>
+void radix_sort(std::vector<std::pair<uint64_t, value_t> >& v,
+                unsigned key_bits = 64) {
+  typedef std::pair<uint64_t, value_t> item_t;
+  const size_t N = v.size();
+  if (N < 2) {
+    return;
+  }
+
+  int n_threads = 1;
+#if defined(_OPENMP)
+  if (N >= 65536) {
+    n_threads = omp_get_max_threads();
+  }
+#endif
+
+  std::vector<item_t> tmp(N);
+  std::vector<size_t> count((size_t)n_threads * 256);
+
+  for (unsigned shift = 0; shift < key_bits; shift += 8) {
+    std::fill(count.begin(), count.end(), 0);
+
+#pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+    for (int t = 0; t < n_threads; ++t) {
+      size_t* c = &count[(size_t)t * 256];
+      for (size_t i = N * t / n_threads, e = N * (t + 1) / n_threads; i != e;
+           ++i) {
+        ++c[(v[i].first >> shift) & 0xff];
+      }
+    }
+
+    bool trivial = false;
+    size_t sum = 0;
+    for (unsigned d = 0; d < 256; ++d) {
+      size_t start = sum;
+      for (int t = 0; t < n_threads; ++t) {
+        size_t c = count[(size_t)t * 256 + d];
+        count[(size_t)t * 256 + d] = sum;
+        sum += c;
+      }
+      if (sum - start == N) {
+        trivial = true;
+      }
+    }
+    if (trivial) {
+      continue;
+    }
+
+#pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+    for (int t = 0; t < n_threads; ++t) {
+      size_t* c = &count[(size_t)t * 256];
+      for (size_t i = N * t / n_threads, e = N * (t + 1) / n_threads; i != e;
+           ++i) {
+        tmp[c[(v[i].first >> shift) & 0xff]++] = v[i];
+      }
+    }
+
+    v.swap(tmp);
+  }
+}
+}  // namespace geom
+}  // namespace carve
@@ -29,7 +29,7 @@
 #include <carve/geom3d.hpp>
 
 #include <carve/collection_types.hpp>
-#include <carve/octree_decl.hpp>
+#include <carve/linear_octree.hpp>
 #include <carve/polyhedron_base.hpp>
 
 #include <assert.h>
@@ -84,7 +84,28 @@ class Polyhedron : public Geometry<3> {
   std::vector<bool> manifold_is_negative;
 
   carve::geom3d::AABB aabb;
-  carve::csg::Octree octree;
+
+  // spatial indices of faces and edges. Bounding boxes are padded by
+  // EPSILON, so that queries are conservative.
+  struct face_aabb_t {
+    carve::geom3d::AABB operator()(const face_t* f) const {
+      carve::geom3d::AABB r = f->aabb;
+      r.expand(carve::EPSILON);
+      return r;
+    }
+  };
+
+  struct edge_aabb_t {
+    carve::geom3d::AABB operator()(const edge_t* e) const {
+      carve::geom3d::AABB r;
+      r.fit(e->v1->v, e->v2->v);
+      r.expand(carve::EPSILON);
+      return r;
+    }
+  };
+
+  carve::geom::LinearOctree<const face_t*, face_aabb_t> face_octree;
+  carve::geom::LinearOctree<const edge_t*, edge_aabb_t> edge_octree;
 
   // *** construction of Polyhedron objects
 
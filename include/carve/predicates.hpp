@@ -0,0 +1,285 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+#include <carve/shewchuk_predicates.hpp>
+
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+
+namespace carve {
+
+/**
+ * \brief Counts of filtered predicate evaluations, and of those that
+ * could not be decided by the floating point filter and fell back to
+ * adaptive exact arithmetic. Only updated while \a enabled is true.
+ */
+struct predicate_stats_t {
+  bool enabled;
+  std::atomic<unsigned long long> orient2d_calls;
+  std::atomic<unsigned long long> orient2d_exact;
+  std::atomic<unsigned long long> orient3d_calls;
+  std::atomic<unsigned long long> orient3d_exact;
+
+  predicate_stats_t() : enabled(false) { reset(); }
+
+  void reset() {
+    orient2d_calls = 0;
+    orient2d_exact = 0;
+    orient3d_calls = 0;
+    orient3d_exact = 0;
+  }
+};
+
+extern predicate_stats_t predicate_stats;
+
+namespace detail {
+// error bound coefficients from Shewchuk's exactinit(), with
+// epsilon = 2^-53.
+static const double pred_eps = DBL_EPSILON * 0.5;
+static const double ccw_errbound_a = (3.0 + 16.0 * pred_eps) * pred_eps;
+static const double o3d_errbound_a = (7.0 + 56.0 * pred_eps) * pred_eps;
+
+// floating point stage of orient2d: sets det and detsum, and returns
+// true if the sign of det is certain.
+inline bool orient2d_filter(const double* pa, const double* pb,
+                            const double* pc, double& det, double& detsum) {
+  const double detleft = (pa[0] - pc[0]) * (pb[1] - pc[1]);
+  const double detright = (pa[1] - pc[1]) * (pb[0] - pc[0]);
+  det = detleft - detright;
+  detsum = std::fabs(detleft) + std::fabs(detright);
+  return std::fabs(det) >= ccw_errbound_a * detsum;
+}
+
+// floating point stage of orient3d: sets det and permanent, and
+// returns true if the sign of det is certain.
+inline bool orient3d_filter(const double* pa, const double* pb,
+                            const double* pc, const double* pd, double& det,
+                            double& permanent) {
+  const double adx = pa[0] - pd[0], bdx = pb[0] - pd[0], cdx = pc[0] - pd[0];
+  const double ady = pa[1] - pd[1], bdy = pb[1] - pd[1], cdy = pc[1] - pd[1];
+  const double adz = pa[2] - pd[2], bdz = pb[2] - pd[2], cdz = pc[2] - pd[2];
+
+  const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+  const double cdxady = cdx * ady, adxcdy = adx * cdy;
+  const double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+  det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) +
+        cdz * (adxbdy - bdxady);
+  permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz) +
+              (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz) +
+              (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+  return std::fabs(det) > o3d_errbound_a * permanent;
+}
+}  // namespace detail
+
+/**
+ * \brief 2D orientation of pc relative to pa->pb, with the sign
+ * guaranteed correct. The determinant is evaluated in floating point,
+ * and only when its magnitude is within the static error bound does
+ * evaluation continue with Shewchuk's adaptive stages.
+ */
+inline double orient2d_filtered(const double* pa, const double* pb,
+                                const double* pc) {
+  double det, detsum;
+  const bool decided = detail::orient2d_filter(pa, pb, pc, det, detsum);
+
+  if (predicate_stats.enabled) {
+    predicate_stats.orient2d_calls.fetch_add(1, std::memory_order_relaxed);
+    if (!decided) {
+      predicate_stats.orient2d_exact.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return decided ? det : shewchuk::orient2dadapt(pa, pb, pc, detsum);
+}
+
+/**
+ * \brief 3D orientation of pd relative to the plane through pa, pb,
+ * pc, with the sign guaranteed correct. Filtered in the same way as
+ * orient2d_filtered().
+ */
+inline double orient3d_filtered(const double* pa, const double* pb,
+                                const double* pc, const double* pd) {
+  double det, permanent;
+  const bool decided = detail::orient3d_filter(pa, pb, pc, pd, det, permanent);
+
+  if (predicate_stats.enabled) {
+    predicate_stats.orient3d_calls.fetch_add(1, std::memory_order_relaxed);
+    if (!decided) {
+      predicate_stats.orient3d_exact.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return decided ? det : shewchuk::orient3dadapt(pa, pb, pc, pd, permanent);
+}
+
+namespace detail {
+// integer coordinates of grid points.
+static const double grid_scale = double(1ULL << GRID_BITS);
+
+// converts n coordinates to integers, if they lie on the grid.
+inline bool to_grid(const double* p, unsigned n, int64_t* r) {
+  for (unsigned i = 0; i < n; ++i) {
+    if (!(std::fabs(p[i]) <= 1.0)) {
+      return false;
+    }
+    const double s = p[i] * grid_scale;
+    r[i] = (int64_t)s;
+    if ((double)r[i] != s) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace detail
+
+/**
+ * \brief Exact orient2d for points on the snapping grid, in 128 bit
+ * integer arithmetic. Returns false if any point is off the grid, or
+ * if 128 bit integers are not available.
+ */
+inline bool orient2d_grid(const double* pa, const double* pb,
+                          const double* pc, double& result) {
+#if defined(__SIZEOF_INT128__)
+  int64_t a[2], b[2], c[2];
+  if (!detail::to_grid(pa, 2, a) || !detail::to_grid(pb, 2, b) ||
+      !detail::to_grid(pc, 2, c)) {
+    return false;
+  }
+  typedef __int128 wide_t;
+  const wide_t det = (wide_t)(a[0] - c[0]) * (b[1] - c[1]) -
+                     (wide_t)(a[1] - c[1]) * (b[0] - c[0]);
+  result = std::ldexp((double)det, -2 * GRID_BITS);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief Exact orient3d for points on the snapping grid, in 128 bit
+ * integer arithmetic. Returns false if any point is off the grid, or
+ * if 128 bit integers are not available.
+ */
+inline bool orient3d_grid(const double* pa, const double* pb,
+                          const double* pc, const double* pd,
+                          double& result) {
+#if defined(__SIZEOF_INT128__)
+  int64_t a[3], b[3], c[3], d[3];
+  if (!detail::to_grid(pa, 3, a) || !detail::to_grid(pb, 3, b) ||
+      !detail::to_grid(pc, 3, c) || !detail::to_grid(pd, 3, d)) {
+    return false;
+  }
+  typedef __int128 wide_t;
+  const int64_t adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+  const int64_t ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+  const int64_t adz = a[2] - d[2], bdz = b[2] - d[2], cdz = c[2] - d[2];
+  // |differences| <= 2^(GRID_BITS + 1), so each 2x2 minor fits in
+  // 2 * GRID_BITS + 3 bits and the determinant in 3 * GRID_BITS + 6.
+  const wide_t m_a = (wide_t)bdx * cdy - (wide_t)cdx * bdy;
+  const wide_t m_b = (wide_t)cdx * ady - (wide_t)adx * cdy;
+  const wide_t m_c = (wide_t)adx * bdy - (wide_t)bdx * ady;
+  const wide_t det = adz * m_a + bdz * m_b + cdz * m_c;
+  result = std::ldexp((double)det, -3 * GRID_BITS);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \brief orient2d for PREDICATES_INTEGER: exact integer evaluation for
+ * grid points, and orient2d_filtered() otherwise.
+ */
+inline double orient2d_integer(const double* pa, const double* pb,
+                               const double* pc) {
+  double det;
+  if (orient2d_grid(pa, pb, pc, det)) {
+    return det;
+  }
+  return orient2d_filtered(pa, pb, pc);
+}
+
+/**
+ * \brief orient3d for PREDICATES_INTEGER: exact integer evaluation for
+ * grid points, and orient3d_filtered() otherwise.
+ */
+inline double orient3d_integer(const double* pa, const double* pb,
+                               const double* pc, const double* pd) {
+  double det;
+  if (orient3d_grid(pa, pb, pc, pd, det)) {
+    return det;
+  }
+  return orient3d_filtered(pa, pb, pc, pd);
+}
+
+namespace detail {
+// The kernels behind orient2d_batch() and orient3d_batch(). Each
+// returns the number of tuples that needed exact evaluation. The AVX2
+// kernels fall back to the scalar ones unless batch_avx2_supported().
+bool batch_avx2_supported();
+
+size_t orient2d_batch_scalar(size_t n, const double* pa, size_t sa,
+                             const double* pb, size_t sb, const double* pc,
+                             size_t sc, double* out);
+size_t orient2d_batch_avx2(size_t n, const double* pa, size_t sa,
+                           const double* pb, size_t sb, const double* pc,
+                           size_t sc, double* out);
+
+size_t orient3d_batch_scalar(size_t n, const double* pa, size_t sa,
+                             const double* pb, size_t sb, const double* pc,
+                             size_t sc, const double* pd, size_t sd,
+                             double* out);
+size_t orient3d_batch_avx2(size_t n, const double* pa, size_t sa,
+                           const double* pb, size_t sb, const double* pc,
+                           size_t sc, const double* pd, size_t sd,
+                           double* out);
+}  // namespace detail
+
+/**
+ * \brief Batched orient2d_filtered().
+ *
+ * Sets out[i] = orient2d_filtered(pa + i * sa, pb + i * sb, pc + i * sc)
+ * for i in [0, n). Strides are in doubles; a stride of 0 uses the same
+ * point for every tuple. If the library was built with CARVE_WITH_AVX2
+ * and the CPU supports AVX2, four tuples are filtered at a time and
+ * only those that fail the filter are passed to the scalar adaptive
+ * code.
+ */
+void orient2d_batch(size_t n, const double* pa, size_t sa, const double* pb,
+                    size_t sb, const double* pc, size_t sc, double* out);
+
+/**
+ * \brief Batched orient3d_filtered(), with strides as for
+ * orient2d_batch().
+ */
+void orient3d_batch(size_t n, const double* pa, size_t sa, const double* pb,
+                    size_t sb, const double* pc, size_t sc, const double* pd,
+                    size_t sd, double* out);
+
+}  // namespace carve
@@ -126,5 +126,34 @@ struct rev {
                                (v.z * r.scale) + r.dz);
   }
 };
+
+// As fwd, and then rounds to the nearest point of the snapping grid
+// (multiples of 2^-carve::GRID_BITS), on which PREDICATES_INTEGER
+// evaluates predicates exactly.
+struct fwd_snap {
+  rescale r;
+  fwd_snap(const rescale& _r) : r(_r) {}
+  carve::geom3d::Vector operator()(const carve::geom3d::Vector& v) const {
+    return snap(fwd(r)(v));
+  }
+  static double snap(double x) {
+    return ::nearbyint(::ldexp(x, carve::GRID_BITS)) *
+           ::ldexp(1.0, -carve::GRID_BITS);
+  }
+  static carve::geom3d::Vector snap(const carve::geom3d::Vector& v) {
+    return carve::geom::VECTOR(snap(v.x), snap(v.y), snap(v.z));
+  }
+};
+
+// Rounds to the snapping grid, as fwd_snap, and then applies rev.
+// Used to snap output vertices, including those constructed by
+// intersection, deterministically.
+struct rev_snap {
+  rescale r;
+  rev_snap(const rescale& _r) : r(_r) {}
+  carve::geom3d::Vector operator()(const carve::geom3d::Vector& v) const {
+    return rev(r)(fwd_snap::snap(v));
+  }
+};
 }  // namespace rescale
 }  // namespace carve
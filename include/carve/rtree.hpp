@@ -176,6 +176,11 @@ struct RTreeNode {
     _fill(begin, end, typename std::iterator_traits<iter_t>::value_type());
   }
 
+  // Construct an empty node with the given extent. The caller is
+  // responsible for filling in data or child links consistently.
+  explicit RTreeNode(const aabb_t& _bbox)
+      : bbox(_bbox), child(nullptr), sibling(nullptr), data() {}
+
   ~RTreeNode() {
     if (child) {
       RTreeNode* next = child;
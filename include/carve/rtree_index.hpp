@@ -0,0 +1,172 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <carve/mesh.hpp>
+#include <carve/rtree.hpp>
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace carve {
+namespace mesh {
+
+typedef carve::geom::RTreeNode<3, Face<3>*> face_rtree_t;
+
+// A face R-tree for a MeshSet<3>, flattened into a form that can be
+// written to disk and memory mapped back without deserialisation.
+//
+// File layout (native byte order; all records are 8 byte aligned):
+//
+//   header_t
+//   node_t[n_nodes]    nodes in breadth first order; node 0 is the
+//                      root, and the children of a node are stored
+//                      contiguously.
+//   uint32_t[n_refs]   face indices, in MeshSet::faceBegin() order,
+//                      referenced by leaf nodes.
+//
+// Faces are referred to by index, so an index is only meaningful
+// for the mesh it was built from. The header records the face and
+// vertex counts and a hash of the face geometry, and open() rejects
+// an index whose values do not match the mesh it is opened against.
+class FaceRTreeIndex {
+ public:
+  enum { VERSION = 1 };
+
+  struct header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t header_size;
+    uint32_t node_size;
+    uint32_t n_nodes;
+    uint32_t n_refs;
+    uint64_t n_faces;
+    uint64_t n_vertices;
+    uint64_t mesh_hash;
+  };
+
+  // For an internal node, [first, first + count) is a range of
+  // nodes. For a leaf, it is a range of face references.
+  struct node_t {
+    double pos[3];
+    double extent[3];
+    uint32_t first;
+    uint32_t count;
+    uint32_t is_leaf;
+    uint32_t pad;
+
+    carve::geom::aabb<3> getAABB() const {
+      return carve::geom::aabb<3>(
+          carve::geom::VECTOR(pos[0], pos[1], pos[2]),
+          carve::geom::VECTOR(extent[0], extent[1], extent[2]));
+    }
+  };
+
+ private:
+  FaceRTreeIndex(const FaceRTreeIndex&);
+  FaceRTreeIndex& operator=(const FaceRTreeIndex&);
+
+  const char* base;
+  size_t size;
+  bool mapped;
+  std::vector<char> buffer;
+
+  const header_t* header;
+  const node_t* nodes;
+  const uint32_t* refs;
+
+  std::vector<Face<3>*> faces;
+
+  bool validate(const MeshSet<3>* mesh);
+  face_rtree_t* _toRTree(uint32_t n) const;
+
+ public:
+  FaceRTreeIndex();
+  ~FaceRTreeIndex();
+
+  // Compute the hash of the face geometry of a mesh that is used to
+  // detect stale indices.
+  static uint64_t meshHash(const MeshSet<3>* mesh);
+
+  // Flatten tree, which must have been built from the faces of mesh,
+  // and write it to filename. Returns false on failure.
+  static bool write(const std::string& filename, const MeshSet<3>* mesh,
+                    const face_rtree_t* tree);
+
+  // Build an STR tree for mesh and write it to filename.
+  static bool write(const std::string& filename, const MeshSet<3>* mesh);
+
+  // Map the index stored in filename, and check that it is well
+  // formed and was built from mesh. Returns false, leaving the index
+  // closed, if the file cannot be read, or if it is malformed or
+  // stale.
+  bool open(const std::string& filename, const MeshSet<3>* mesh);
+
+  void close();
+
+  bool isOpen() const { return header != nullptr; }
+
+  size_t nodeCount() const { return header ? header->n_nodes : 0; }
+
+  // Search the index for faces whose bounding boxes intersect obj
+  // (generally an aabb), with the same semantics as
+  // RTreeNode::search().
+  template <typename obj_t, typename out_iter_t>
+  void search(const obj_t& obj, out_iter_t out) const {
+    if (!header) {
+      return;
+    }
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+    while (stack.size()) {
+      const node_t& node = nodes[stack.back()];
+      stack.pop_back();
+      if (!node.getAABB().intersects(obj)) {
+        continue;
+      }
+      if (node.is_leaf) {
+        for (uint32_t i = node.first; i != node.first + node.count; ++i) {
+          *out++ = faces[refs[i]];
+        }
+      } else {
+        for (uint32_t i = node.first + node.count; i != node.first;) {
+          stack.push_back(--i);
+        }
+      }
+    }
+  }
+
+  // Reconstruct a pointer-linked RTreeNode from the index, for use
+  // with code that expects one. Node extents are taken from the
+  // index, and no sorting or partitioning is performed.
+  face_rtree_t* toRTree() const;
+};
+}  // namespace mesh
+}  // namespace carve
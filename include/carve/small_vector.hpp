@@ -0,0 +1,186 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/carve.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+namespace carve {
+
+/**
+ * \brief A vector of trivially copyable values that stores up to N
+ * elements inline, and only allocates on the heap once it grows beyond
+ * that. Provides the subset of the std::vector interface used by
+ * carve.
+ */
+template <typename T, unsigned N>
+class small_vector {
+  T* ptr;
+  size_t n;
+  size_t cap;
+  T buf[N];
+
+  void grow(size_t want) {
+    size_t new_cap = std::max(want, cap * 2);
+    T* p = new T[new_cap];
+    std::memcpy(p, ptr, n * sizeof(T));
+    if (ptr != buf) {
+      delete[] ptr;
+    }
+    ptr = p;
+    cap = new_cap;
+  }
+
+ public:
+  typedef T value_type;
+  typedef size_t size_type;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+
+  small_vector() : ptr(buf), n(0), cap(N) {}
+
+  small_vector(size_t sz, const T& v) : ptr(buf), n(0), cap(N) {
+    resize(sz, v);
+  }
+
+  template <typename iter_t>
+  small_vector(iter_t a, iter_t b) : ptr(buf), n(0), cap(N) {
+    reserve(std::distance(a, b));
+    for (; a != b; ++a) {
+      ptr[n++] = *a;
+    }
+  }
+
+  small_vector(const small_vector& other) : ptr(buf), n(0), cap(N) {
+    *this = other;
+  }
+
+  small_vector(small_vector&& other) : ptr(buf), n(0), cap(N) {
+    *this = std::move(other);
+  }
+
+  ~small_vector() {
+    if (ptr != buf) {
+      delete[] ptr;
+    }
+  }
+
+  small_vector& operator=(const small_vector& other) {
+    if (this != &other) {
+      n = 0;
+      reserve(other.n);
+      std::memcpy(ptr, other.ptr, other.n * sizeof(T));
+      n = other.n;
+    }
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    if (other.ptr == other.buf) {
+      return *this = static_cast<const small_vector&>(other);
+    }
+    if (ptr != buf) {
+      delete[] ptr;
+    }
+    ptr = other.ptr;
+    n = other.n;
+    cap = other.cap;
+    other.ptr = other.buf;
+    other.n = 0;
+    other.cap = N;
+    return *this;
+  }
+
+  size_t size() const { return n; }
+  size_t capacity() const { return cap; }
+  bool empty() const { return n == 0; }
+  bool isInline() const { return ptr == buf; }
+
+  iterator begin() { return ptr; }
+  iterator end() { return ptr + n; }
+  const_iterator begin() const { return ptr; }
+  const_iterator end() const { return ptr + n; }
+
+  T& operator[](size_t i) { return ptr[i]; }
+  const T& operator[](size_t i) const { return ptr[i]; }
+  T& back() { return ptr[n - 1]; }
+  const T& back() const { return ptr[n - 1]; }
+
+  void reserve(size_t sz) {
+    if (sz > cap) {
+      grow(sz);
+    }
+  }
+
+  void clear() { n = 0; }
+
+  void resize(size_t sz) {
+    reserve(sz);
+    n = sz;
+  }
+
+  void resize(size_t sz, const T& v) {
+    reserve(sz);
+    std::fill(ptr + std::min(n, sz), ptr + sz, v);
+    n = sz;
+  }
+
+  void push_back(const T& v) {
+    if (n == cap) {
+      T t = v;  // v may refer to an element.
+      grow(n + 1);
+      ptr[n++] = t;
+    } else {
+      ptr[n++] = v;
+    }
+  }
+
+  void pop_back() { --n; }
+
+  iterator erase(iterator first, iterator last) {
+    std::memmove(first, last, (end() - last) * sizeof(T));
+    n -= last - first;
+    return first;
+  }
+
+  bool operator==(const small_vector& other) const {
+    return n == other.n && std::equal(ptr, ptr + n, other.ptr);
+  }
+
+  bool operator!=(const small_vector& other) const {
+    return !(*this == other);
+  }
+};
+
+}  // namespace carve
@@ -194,21 +194,45 @@ class CSG_PolyNode : public CSG_TreeNode {
   }
 };
 
+// Sets the predicate mode of a CSG object, restoring the previous
+// mode on scope exit.
+class CSG_PredicateModeScope {
+  CSG& csg;
+  carve::PredicateMode saved;
+
+  CSG_PredicateModeScope(const CSG_PredicateModeScope&);
+  CSG_PredicateModeScope& operator=(const CSG_PredicateModeScope&);
+
+ public:
+  CSG_PredicateModeScope(CSG& _csg, carve::PredicateMode mode)
+      : csg(_csg), saved(_csg.predicate_mode) {
+    csg.predicate_mode = mode;
+  }
+  ~CSG_PredicateModeScope() { csg.predicate_mode = saved; }
+};
+
 class CSG_OPNode : public CSG_TreeNode {
   CSG_TreeNode *left, *right;
   CSG::OP op;
   bool rescale;
   CSG::CLASSIFY_TYPE classify_type;
+  bool snap;
 
  public:
+  // If _snap is set (which implies _rescale), input vertices are
+  // snapped to the integer grid of carve::GRID_BITS after rescaling,
+  // predicates are evaluated with PREDICATES_INTEGER, and output
+  // vertices are snapped back to the grid before being unscaled.
   CSG_OPNode(CSG_TreeNode* _left, CSG_TreeNode* _right, CSG::OP _op,
              bool _rescale,
-             CSG::CLASSIFY_TYPE _classify_type = CSG::CLASSIFY_NORMAL)
+             CSG::CLASSIFY_TYPE _classify_type = CSG::CLASSIFY_NORMAL,
+             bool _snap = false)
       : left(_left),
         right(_right),
         op(_op),
-        rescale(_rescale),
-        classify_type(_classify_type) {}
+        rescale(_rescale || _snap),
+        classify_type(_classify_type),
+        snap(_snap) {}
 
   ~CSG_OPNode() override {
     delete left;
@@ -258,16 +282,22 @@ class CSG_OPNode : public CSG_TreeNode {
 
     carve::rescale::rescale scaler(min.x, min.y, min.z, max.x, max.y, max.z);
 
-    carve::rescale::fwd fwd_r(scaler);
-    carve::rescale::rev rev_r(scaler);
-
-    l->transform(fwd_r);
-    r->transform(fwd_r);
+    if (snap) {
+      carve::rescale::fwd_snap fwd_r(scaler);
+      l->transform(fwd_r);
+      r->transform(fwd_r);
+    } else {
+      carve::rescale::fwd fwd_r(scaler);
+      l->transform(fwd_r);
+      r->transform(fwd_r);
+    }
 
     carve::mesh::MeshSet<3>* result = nullptr;
     {
       static carve::TimingName FUNC_NAME("csg.compute()");
       carve::TimingBlock block(FUNC_NAME);
+      CSG_PredicateModeScope predicates(
+          csg, snap ? carve::PREDICATES_INTEGER : csg.predicate_mode);
       result = csg.compute(l, r, op, nullptr, classify_type);
     }
 
@@ -279,7 +309,11 @@ class CSG_OPNode : public CSG_TreeNode {
       delete r;
     }
 
-    result->transform(rev_r);
+    if (snap) {
+      result->transform(carve::rescale::rev_snap(scaler));
+    } else {
+      result->transform(carve::rescale::rev(scaler));
+    }
 
     is_temp = true;
     return result;
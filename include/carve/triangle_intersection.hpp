@@ -28,6 +28,8 @@
 
 #include <carve/geom.hpp>
 
+#include <vector>
+
 namespace carve {
 namespace geom {
 
@@ -56,6 +58,64 @@ TriangleIntType triangle_intersection_exact(const vector<2> tri_a[3],
 TriangleIntType triangle_intersection_exact(const vector<3> tri_a[3],
                                             const vector<3> tri_b[3]);
 
+/**
+ * \brief A set of 3d triangles stored as separate coordinate arrays
+ * (x[k][i] is the x coordinate of vertex k of triangle i), so that one
+ * triangle can be tested against many at once.
+ */
+struct triangle_packet {
+  std::vector<double> x[3], y[3], z[3];
+
+  size_t size() const { return x[0].size(); }
+  bool empty() const { return x[0].empty(); }
+
+  void clear() {
+    for (unsigned k = 0; k < 3; ++k) {
+      x[k].clear();
+      y[k].clear();
+      z[k].clear();
+    }
+  }
+
+  void reserve(size_t n) {
+    for (unsigned k = 0; k < 3; ++k) {
+      x[k].reserve(n);
+      y[k].reserve(n);
+      z[k].reserve(n);
+    }
+  }
+
+  void push_back(const vector<3>& a, const vector<3>& b, const vector<3>& c) {
+    const vector<3>* v[3] = {&a, &b, &c};
+    for (unsigned k = 0; k < 3; ++k) {
+      x[k].push_back(v[k]->x);
+      y[k].push_back(v[k]->y);
+      z[k].push_back(v[k]->z);
+    }
+  }
+
+  void push_back(const vector<3> tri[3]) { push_back(tri[0], tri[1], tri[2]); }
+
+  void get(size_t i, vector<3> tri[3]) const {
+    for (unsigned k = 0; k < 3; ++k) {
+      tri[k] = VECTOR(x[k][i], y[k][i], z[k][i]);
+    }
+  }
+};
+
+/**
+ * \brief Classify tri_a against each triangle of \a packet, setting
+ * result[i] to triangle_intersection_exact(tri_a, triangle i).
+ *
+ * Pairs are first rejected in groups, using their bounding boxes and
+ * a floating point filtered test of each triangle's vertices against
+ * the other's plane. Only pairs that survive are passed to the scalar
+ * exact test.
+ */
+void triangle_intersection_exact(const vector<3> tri_a[3],
+                                 const triangle_packet& packet,
+                                 TriangleIntType* result);
+
 TriangleIntType triangle_linesegment_intersection_exact(
     const vector<2> tri_a[3], const vector<2> line_b[2]);
 TriangleIntType triangle_point_intersection_exact(const vector<2> tri_a[3],
@@ -104,20 +104,54 @@ struct tri_idx {
   tri_idx(unsigned _a, unsigned _b, unsigned _c) : a(_a), b(_b), c(_c) {}
 };
 
+/**
+ * \brief Selects the algorithm used by triangulate().
+ */
+enum TriangulationMethod {
+  /** Ear clipping; robust to degenerate and weakly simple input, but
+   * quadratic in the worst case. */
+  EAR_CLIPPING,
+  /** Decomposition into monotone pieces by plane sweep, in
+   * O(n log n). Input the sweep cannot handle (spikes, touching or
+   * crossing edges) falls back to ear clipping. */
+  MONOTONE_SWEEP
+};
+
 /**
  * \brief Triangulate a 2-dimensional polygon.
  *
  * Given a 2-dimensional polygon described as a vector of 2-d
  * points, with no holes and no self-crossings, produce a
- * triangulation using an ear-clipping algorithm.
+ * triangulation using an ear-clipping algorithm. Convex and
+ * y-monotone polygons are recognised and triangulated in linear time,
+ * whichever method is selected.
  *
  * @param [in] poly A vector containing the input polygon.
  * @param [out] result A vector of triangles, represented as
  *                     indicies into poly.
+ * @param [in] method The triangulation algorithm to use.
  */
 
 void triangulate(const std::vector<carve::geom2d::P2>& poly,
-                 std::vector<tri_idx>& result);
+                 std::vector<tri_idx>& result,
+                 TriangulationMethod method = EAR_CLIPPING);
+
+/**
+ * \brief Triangulate a 2-dimensional polygon with holes.
+ *
+ * @param [in] poly A vector containing the polygon loop (the first
+ *                  element of poly) and the hole loops (second and
+ *                  subsequent elements of poly).
+ * @param [out] result A vector of triangles, represented as indices
+ *                     into the concatenation of the loops of poly.
+ * @param [in] method The triangulation algorithm to use. The
+ *                    monotone sweep handles holes directly; ear
+ *                    clipping first bridges them into the polygon
+ *                    loop with incorporateHolesIntoPolygon().
+ */
+void triangulate(const std::vector<std::vector<carve::geom2d::P2> >& poly,
+                 std::vector<tri_idx>& result,
+                 TriangulationMethod method = EAR_CLIPPING);
 
 /**
  * \brief Triangulate a polygon (templated).
@@ -130,10 +164,61 @@ void triangulate(const std::vector<carve::geom2d::P2>& poly,
  *                  represented as vert_t pointers.
  * @param [out] result A vector of triangles, represented as
  *                     indicies into poly.
+ * @param [in] method The triangulation algorithm to use.
  */
 template <typename project_t, typename vert_t>
 void triangulate(const project_t& project, const std::vector<vert_t>& poly,
-                 std::vector<tri_idx>& result);
+                 std::vector<tri_idx>& result,
+                 TriangulationMethod method = EAR_CLIPPING);
+
+namespace detail {
+struct workspace_t;
+}
+
+/**
+ * \brief Reusable triangulation state.
+ *
+ * A Triangulator owns the scratch storage used while triangulating:
+ * the linked list nodes, ear queue and reflex vertex grid of the ear
+ * clipper, the buffers of the monotone fast path, and a buffer for
+ * projected coordinates. Storage is kept between calls, so that once
+ * it has grown to fit the largest polygon seen, further calls make no
+ * heap allocations (given a result vector that is also reused). The
+ * exception is the general plane sweep of MONOTONE_SWEEP, which still
+ * allocates for polygons that need to be decomposed. The storage is
+ * allocated on the first polygon of more than three vertices, so a
+ * Triangulator that only sees triangles allocates nothing.
+ *
+ * A Triangulator may not be shared between threads; keep one per
+ * thread instead.
+ */
+class Triangulator {
+  detail::workspace_t* ws;
+  std::vector<carve::geom2d::P2> projected;
+
+  Triangulator(const Triangulator&);             // not implemented
+  Triangulator& operator=(const Triangulator&);  // not implemented
+
+ public:
+  Triangulator();
+  ~Triangulator();
+
+  /**
+   * \brief As carve::triangulate::triangulate(poly, result, method).
+   */
+  void triangulate(const std::vector<carve::geom2d::P2>& poly,
+                   std::vector<tri_idx>& result,
+                   TriangulationMethod method = EAR_CLIPPING);
+
+  /**
+   * \brief As carve::triangulate::triangulate(project, poly, result,
+   * method).
+   */
+  template <typename project_t, typename vert_t>
+  void triangulate(const project_t& project, const std::vector<vert_t>& poly,
+                   std::vector<tri_idx>& result,
+                   TriangulationMethod method = EAR_CLIPPING);
+};
 
 /**
  * \brief Improve a candidate triangulation of poly by minimising
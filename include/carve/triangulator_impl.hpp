@@ -247,300 +247,184 @@ size_t removeDegeneracies(vertex_info*& begin,
                           std::vector<carve::triangulate::tri_idx>& result);
 
 bool splitAndResume(vertex_info* begin,
-                    std::vector<carve::triangulate::tri_idx>& result);
+                    std::vector<carve::triangulate::tri_idx>& result,
+                    workspace_t& ws);
 
 bool doTriangulate(vertex_info* begin,
-                   std::vector<carve::triangulate::tri_idx>& result);
+                   std::vector<carve::triangulate::tri_idx>& result,
+                   workspace_t& ws);
 
-typedef std::pair<unsigned, unsigned> vert_edge_t;
+bool sweepTriangulate(const std::vector<std::vector<carve::geom2d::P2> >& poly,
+                      std::vector<carve::triangulate::tri_idx>& result);
 
-struct hash_vert_edge_t {
-  size_t operator()(const vert_edge_t& e) const {
-    size_t r = (size_t)e.first;
-    size_t s = (size_t)e.second;
-    return r ^ ((s >> 16) | (s << 16));
-  }
-};
-
-static inline vert_edge_t ordered_vert_edge_t(unsigned a, unsigned b) {
-  return (a < b) ? vert_edge_t(a, b) : vert_edge_t(b, a);
-}
+bool sweepBridgeHoles(const std::vector<std::vector<carve::geom2d::P2> >& poly,
+                      size_t poly_loop, const std::vector<size_t>& hole_loops,
+                      std::vector<std::pair<size_t, size_t> >& hole_vert,
+                      std::vector<std::pair<size_t, size_t> >& attach_vert);
 
-struct tri_pair_t {
-  carve::triangulate::tri_idx *a, *b;
-  double score;
-  size_t idx;
+// patches hole_loops into f_loop, which must hold the polygon loop,
+// along bridges found by sweepBridgeHoles(). returns false, leaving
+// f_loop untouched, if the sweep rejects the input.
+bool sweepIncorporateHoles(
+    const std::vector<std::vector<carve::geom2d::P2> >& poly,
+    std::vector<std::pair<size_t, size_t> >& f_loop,
+    const std::vector<size_t>& hole_loops);
 
-  tri_pair_t() : a(nullptr), b(nullptr), score(0.0) {}
-
-  static inline unsigned N(unsigned i) { return (i + 1) % 3; }
-  static inline unsigned P(unsigned i) { return (i + 2) % 3; }
+/**
+ * \brief Edge flipping for improve(), driven by a work list.
+ *
+ * Triangle adjacency is kept in a flat array of half edges: half edge
+ * 3 * t + i runs from result[t].v[i] to result[t].v[(i + 1) % 3], and
+ * twin[] maps it to the opposite half edge of the neighbouring
+ * triangle, or to itself on the boundary. Edges whose flip would
+ * shorten the triangulation wait in a max heap by score. A flip only
+ * changes the four edges around the flipped edge, so only those are
+ * queued again. Entries left stale by a flip are detected, when
+ * popped, by recomputing their score.
+ */
+template <typename project_t, typename vert_t, typename distance_calc_t>
+class edge_flipper_t {
+  typedef std::pair<double, size_t> entry_t;
 
-  void findSharedEdge(unsigned& ai, unsigned& bi) const {
-    if (a->v[1] == b->v[0]) {
-      if (a->v[0] == b->v[1]) {
-        ai = 0;
-        bi = 0;
-      } else {
-        ai = 1;
-        bi = 2;
-      }
-      return;
-    }
-    if (a->v[1] == b->v[1]) {
-      if (a->v[0] == b->v[2]) {
-        ai = 0;
-        bi = 1;
-      } else {
-        ai = 1;
-        bi = 0;
-      }
-      return;
-    }
-    if (a->v[1] == b->v[2]) {
-      if (a->v[0] == b->v[0]) {
-        ai = 0;
-        bi = 2;
-      } else {
-        ai = 1;
-        bi = 1;
-      }
-      return;
-    }
-    if (a->v[2] == b->v[0]) {
-      ai = 2;
-      bi = 2;
-      return;
-    }
-    if (a->v[2] == b->v[1]) {
-      ai = 2;
-      bi = 0;
-      return;
-    }
-    if (a->v[2] == b->v[2]) {
-      ai = 2;
-      bi = 1;
-      return;
-    }
-    CARVE_FAIL("should not be reached");
-  }
+  const project_t& project;
+  const std::vector<vert_t>& poly;
+  distance_calc_t dist;
+  std::vector<carve::triangulate::tri_idx>& result;
 
-  void flip(vert_edge_t& old_edge, vert_edge_t& new_edge, vert_edge_t perim[4]);
+  std::vector<size_t> twin;
+  std::vector<entry_t> heap;
 
-  template <typename project_t, typename vert_t, typename distance_calc_t>
-  double calc(const project_t& project, const std::vector<vert_t>& poly,
-              distance_calc_t dist) {
-    unsigned ai, bi;
-    unsigned cross_ai, cross_bi;
-    unsigned ea, eb;
+  static size_t next(size_t h) { return h - h % 3 + (h + 1) % 3; }
+  static size_t prev(size_t h) { return h - h % 3 + (h + 2) % 3; }
 
-    findSharedEdge(ai, bi);
+  unsigned vert(size_t h) const { return result[h / 3].v[h % 3]; }
 
-#if defined(CARVE_DEBUG)
-    if (carve::geom2d::signedArea(project(poly[a->v[0]]),
-                                  project(poly[a->v[1]]),
-                                  project(poly[a->v[2]])) > 0.0 ||
-        carve::geom2d::signedArea(project(poly[b->v[0]]),
-                                  project(poly[b->v[1]]),
-                                  project(poly[b->v[2]])) > 0.0) {
-      std::cerr << "warning: triangle pair " << this
-                << " contains triangles with incorrect orientation"
-                << std::endl;
+  // the reduction in edge length obtained by flipping h, or a negative
+  // value if h is a boundary edge or flipping it would invert a
+  // triangle.
+  double score(size_t h) {
+    if (twin[h] == h) {
+      return -1.0;
     }
-#endif
-
-    cross_ai = P(ai);
-    cross_bi = P(bi);
-
-    ea = a->v[cross_ai];
-    eb = b->v[cross_bi];
+    unsigned a = vert(h), b = vert(next(h));
+    unsigned c = vert(prev(h)), d = vert(prev(twin[h]));
 
     double side_1 = carve::geom2d::orient2d(
-        project(poly[ea]), project(poly[eb]), project(poly[a->v[ai]]));
+        project(poly[c]), project(poly[d]), project(poly[a]));
     double side_2 = carve::geom2d::orient2d(
-        project(poly[ea]), project(poly[eb]), project(poly[a->v[N(ai)]]));
-
-    bool can_flip =
-        (side_1 < 0.0 && side_2 > 0.0) || (side_1 > 0.0 && side_2 < 0.0);
-
-    if (!can_flip) {
-      score = -1;
-    } else {
-      score = dist(poly[a->v[ai]], poly[b->v[bi]]) -
-              dist(poly[a->v[cross_ai]], poly[b->v[cross_bi]]);
+        project(poly[c]), project(poly[d]), project(poly[b]));
+    if (!((side_1 < 0.0 && side_2 > 0.0) || (side_1 > 0.0 && side_2 < 0.0))) {
+      return -1.0;
     }
-    return score;
+    return dist(poly[a], poly[b]) - dist(poly[c], poly[d]);
   }
 
-  template <typename project_t, typename vert_t, typename distance_calc_t>
-  double edgeLen(const project_t& project, const std::vector<vert_t>& poly,
-                 distance_calc_t dist) const {
-    unsigned ai, bi;
-    findSharedEdge(ai, bi);
-    return dist(poly[a->v[ai]], poly[b->v[bi]]);
-  }
-};
-
-struct max_score {
-  bool operator()(const tri_pair_t* a, const tri_pair_t* b) const {
-    return a->score < b->score;
+  void queue(size_t h) {
+    double s = score(h);
+    if (s > 0.0) {
+      heap.push_back(entry_t(s, h));
+      std::push_heap(heap.begin(), heap.end());
+    }
   }
-};
-
-struct tri_pairs_t {
-  typedef std::unordered_map<vert_edge_t, tri_pair_t*, hash_vert_edge_t>
-      storage_t;
-  storage_t storage;
 
-  tri_pairs_t() : storage(){};
-
-  ~tri_pairs_t() {
-    for (storage_t::iterator i = storage.begin(); i != storage.end(); ++i) {
-      if ((*i).second) {
-        delete (*i).second;
-      }
+  // makes half edge h (which replaces old_h) the twin of g, where g
+  // was the twin of old_h.
+  void link(size_t h, size_t old_h, size_t g) {
+    if (g == old_h) {
+      twin[h] = h;
+    } else {
+      twin[h] = g;
+      twin[g] = h;
     }
   }
 
-  void insert(unsigned a, unsigned b, carve::triangulate::tri_idx* t);
+  void buildAdjacency() {
+    const size_t H = result.size() * 3;
+    twin.resize(H);
 
-  template <typename project_t, typename vert_t, typename distance_calc_t>
-  void updateEdge(tri_pair_t* tp, const project_t& project,
-                  const std::vector<vert_t>& poly, distance_calc_t dist,
-                  std::vector<tri_pair_t*>& edges, size_t& n) {
-    double old_score = tp->score;
-    double new_score = tp->calc(project, poly, dist);
-#if defined(CARVE_DEBUG)
-    std::cerr << "tp:" << tp << " old_score: " << old_score
-              << " new_score: " << new_score << std::endl;
-#endif
-    if (new_score > 0.0 && old_score <= 0.0) {
-      tp->idx = n;
-      edges[n++] = tp;
-    } else if (new_score <= 0.0 && old_score > 0.0) {
-      std::swap(edges[tp->idx], edges[--n]);
-      edges[tp->idx]->idx = tp->idx;
+    // half edges bucketed by their start vertex.
+    std::vector<size_t> first(poly.size() + 1, 0), out(H);
+    for (size_t h = 0; h < H; ++h) {
+      first[vert(h) + 1]++;
+      twin[h] = h;
+    }
+    for (size_t v = 0; v < poly.size(); ++v) {
+      first[v + 1] += first[v];
+    }
+    std::vector<size_t> fill(first.begin(), first.end() - 1);
+    for (size_t h = 0; h < H; ++h) {
+      out[fill[vert(h)]++] = h;
     }
-  }
 
-  tri_pair_t* get(vert_edge_t& e) {
-    storage_t::iterator i;
-    i = storage.find(e);
-    if (i == storage.end()) {
-      return nullptr;
+    for (size_t h = 0; h < H; ++h) {
+      if (twin[h] != h) {
+        continue;
+      }
+      unsigned a = vert(h), b = vert(next(h));
+      for (size_t k = first[b]; k < first[b + 1]; ++k) {
+        size_t g = out[k];
+        if (twin[g] == g && g != h && vert(next(g)) == a) {
+          twin[h] = g;
+          twin[g] = h;
+          break;
+        }
+      }
     }
-    return (*i).second;
   }
 
-  template <typename project_t, typename vert_t, typename distance_calc_t>
-  void flip(const project_t& project, const std::vector<vert_t>& poly,
-            distance_calc_t dist, std::vector<tri_pair_t*>& edges, size_t& n) {
-    vert_edge_t old_e, new_e;
-    vert_edge_t perim[4];
+  // replaces triangles (a, b, c) and (b, a, d), which share the edge
+  // a-b at half edge h, by (c, a, d) and (d, b, c).
+  void flip(size_t h) {
+    const size_t g = twin[h];
+    const size_t t = h / 3, u = g / 3;
+    unsigned a = vert(h), b = vert(next(h));
+    unsigned c = vert(prev(h)), d = vert(prev(g));
 
-#if defined(CARVE_DEBUG)
-    std::cerr << "improvable edges: " << n << std::endl;
-#endif
+    size_t bc = twin[next(h)], ca = twin[prev(h)];
+    size_t ad = twin[next(g)], db = twin[prev(g)];
+    size_t old_bc = next(h), old_ca = prev(h);
+    size_t old_ad = next(g), old_db = prev(g);
 
-    tri_pair_t* tp =
-        *std::max_element(edges.begin(), edges.begin() + n, max_score());
+    result[t] = carve::triangulate::tri_idx(c, a, d);
+    result[u] = carve::triangulate::tri_idx(d, b, c);
 
-#if defined(CARVE_DEBUG)
-    std::cerr << "improving tri-pair: " << tp << " with score: " << tp->score
-              << std::endl;
-#endif
-
-    tp->flip(old_e, new_e, perim);
+    link(3 * t + 0, old_ca, ca);
+    link(3 * t + 1, old_ad, ad);
+    link(3 * u + 0, old_db, db);
+    link(3 * u + 1, old_bc, bc);
+    twin[3 * t + 2] = 3 * u + 2;
+    twin[3 * u + 2] = 3 * t + 2;
 
-#if defined(CARVE_DEBUG)
-    std::cerr << "old_e: " << old_e.first << "," << old_e.second
-              << " -> new_e: " << new_e.first << "," << new_e.second
-              << std::endl;
-#endif
-
-    CARVE_ASSERT(storage.find(old_e) != storage.end());
-    storage.erase(old_e);
-    storage[new_e] = tp;
-
-    std::swap(edges[tp->idx], edges[--n]);
-    edges[tp->idx]->idx = tp->idx;
-
-    tri_pair_t* tp2;
-
-    tp2 = get(perim[0]);
-    if (tp2 != nullptr) {
-      updateEdge(tp2, project, poly, dist, edges, n);
-    }
-
-    tp2 = get(perim[1]);
-    if (tp2 != nullptr) {
-      CARVE_ASSERT(tp2->a == tp->b || tp2->b == tp->b);
-      if (tp2->a == tp->b) {
-        tp2->a = tp->a;
-      } else {
-        tp2->b = tp->a;
-      }
-      updateEdge(tp2, project, poly, dist, edges, n);
-    }
-
-    tp2 = get(perim[2]);
-    if (tp2 != nullptr) {
-      updateEdge(tp2, project, poly, dist, edges, n);
-    }
-
-    tp2 = get(perim[3]);
-    if (tp2 != nullptr) {
-      CARVE_ASSERT(tp2->a == tp->a || tp2->b == tp->a);
-      if (tp2->a == tp->a) {
-        tp2->a = tp->b;
-      } else {
-        tp2->b = tp->b;
-      }
-      updateEdge(tp2, project, poly, dist, edges, n);
-    }
+    queue(3 * t + 0);
+    queue(3 * t + 1);
+    queue(3 * u + 0);
+    queue(3 * u + 1);
   }
 
-  template <typename project_t, typename vert_t, typename distance_calc_t>
-  size_t getInternalEdges(const project_t& project,
-                          const std::vector<vert_t>& poly, distance_calc_t dist,
-                          std::vector<tri_pair_t*>& edges) {
-    size_t count = 0;
-
-    for (storage_t::iterator i = storage.begin(); i != storage.end();) {
-      tri_pair_t* tp = (*i).second;
-      if (tp->a && tp->b) {
-        tp->calc(project, poly, dist);
-        count++;
-#if defined(CARVE_DEBUG)
-        std::cerr << "internal edge: " << (*i).first.first << ","
-                  << (*i).first.second << " -> " << tp << " " << tp->score
-                  << std::endl;
-#endif
-        ++i;
-      } else {
-        delete (*i).second;
-        storage.erase(i++);
+ public:
+  edge_flipper_t(const project_t& _project, const std::vector<vert_t>& _poly,
+                 distance_calc_t _dist,
+                 std::vector<carve::triangulate::tri_idx>& _result)
+      : project(_project), poly(_poly), dist(_dist), result(_result) {}
+
+  // flips edges, best first, until no flip shortens the triangulation.
+  // each flip strictly reduces the total edge length, so this
+  // terminates.
+  void run() {
+    buildAdjacency();
+    for (size_t h = 0; h < twin.size(); ++h) {
+      if (twin[h] > h) {
+        queue(h);
       }
     }
-
-    edges.resize(count);
-
-    size_t fwd = 0;
-    size_t rev = count;
-    for (storage_t::iterator i = storage.begin(); i != storage.end(); ++i) {
-      tri_pair_t* tp = (*i).second;
-      if (tp && tp->a && tp->b) {
-        if (tp->score > 0.0) {
-          edges[fwd++] = tp;
-        } else {
-          edges[--rev] = tp;
-        }
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end());
+      entry_t e = heap.back();
+      heap.pop_back();
+      if (score(e.second) == e.first) {
+        flip(e.second);
       }
     }
-
-    CARVE_ASSERT(fwd == rev);
-
-    return fwd;
   }
 };
 
@@ -752,52 +636,28 @@ static std::vector<vert_t> incorporateHolesIntoPolygon(
 }
 
 template <typename project_t, typename vert_t>
-void triangulate(const project_t& project, const std::vector<vert_t>& poly,
-                 std::vector<tri_idx>& result) {
-  std::vector<detail::vertex_info*> vinfo;
-  const size_t N = poly.size();
-
-  result.clear();
-  if (N < 3) {
-    return;
-  }
-
-  result.reserve(poly.size() - 2);
-
-  if (N == 3) {
-    result.push_back(tri_idx(0, 1, 2));
-    return;
-  }
-
-  vinfo.resize(N);
-
-  vinfo[0] = new detail::vertex_info(project(poly[0]), 0);
-  for (size_t i = 1; i < N - 1; ++i) {
-    vinfo[i] = new detail::vertex_info(project(poly[i]), i);
-    vinfo[i]->prev = vinfo[i - 1];
-    vinfo[i - 1]->next = vinfo[i];
-  }
-  vinfo[N - 1] = new detail::vertex_info(project(poly[N - 1]), N - 1);
-  vinfo[N - 1]->prev = vinfo[N - 2];
-  vinfo[N - 1]->next = vinfo[0];
-  vinfo[0]->prev = vinfo[N - 1];
-  vinfo[N - 2]->next = vinfo[N - 1];
-
-  for (size_t i = 0; i < N; ++i) {
-    vinfo[i]->recompute();
-  }
-
-  detail::vertex_info* begin = vinfo[0];
+void Triangulator::triangulate(const project_t& project,
+                               const std::vector<vert_t>& poly,
+                               std::vector<tri_idx>& result,
+                               TriangulationMethod method) {
+  projected.clear();
+  projected.reserve(poly.size());
+  for (size_t i = 0; i < poly.size(); ++i) {
+    projected.push_back(project(poly[i]));
+  }
+  triangulate(projected, result, method);
+}
 
-  removeDegeneracies(begin, result);
-  doTriangulate(begin, result);
+template <typename project_t, typename vert_t>
+void triangulate(const project_t& project, const std::vector<vert_t>& poly,
+                 std::vector<tri_idx>& result, TriangulationMethod method) {
+  Triangulator triangulator;
+  triangulator.triangulate(project, poly, result, method);
 }
 
 template <typename project_t, typename vert_t, typename distance_calc_t>
 void improve(const project_t& project, const std::vector<vert_t>& poly,
              distance_calc_t dist, std::vector<tri_idx>& result) {
-  detail::tri_pairs_t tri_pairs;
-
 #if defined(CARVE_DEBUG)
   bool warn = false;
   for (size_t i = 0; i < result.size(); ++i) {
@@ -814,46 +674,9 @@ void improve(const project_t& project, const std::vector<vert_t>& poly,
   }
 #endif
 
-  for (size_t i = 0; i < result.size(); ++i) {
-    tri_idx& t = result[i];
-    tri_pairs.insert(t.a, t.b, &t);
-    tri_pairs.insert(t.b, t.c, &t);
-    tri_pairs.insert(t.c, t.a, &t);
-  }
-
-  std::vector<detail::tri_pair_t*> edges;
-  size_t n = tri_pairs.getInternalEdges(project, poly, dist, edges);
-  for (size_t i = 0; i < n; ++i) {
-    edges[i]->idx = i;
-  }
-
-// procedure:
-// while a tri pair with a positive score exists:
-//   p = pair with highest positive score
-//   flip p, rewriting its two referenced triangles.
-//   negate p's score
-//   for each q in the up-to-four adjoining tri pairs:
-//     update q's tri ptr, if changed, and its score.
-
-#if defined(CARVE_DEBUG)
-  double initial_score = 0;
-  for (size_t i = 0; i < edges.size(); ++i) {
-    initial_score += edges[i]->edgeLen(project, poly, dist);
-  }
-  std::cerr << "initial score: " << initial_score << std::endl;
-#endif
-
-  while (n) {
-    tri_pairs.flip(project, poly, dist, edges, n);
-  }
-
-#if defined(CARVE_DEBUG)
-  double final_score = 0;
-  for (size_t i = 0; i < edges.size(); ++i) {
-    final_score += edges[i]->edgeLen(project, poly, dist);
-  }
-  std::cerr << "final score: " << final_score << std::endl;
-#endif
+  detail::edge_flipper_t<project_t, vert_t, distance_calc_t> flipper(
+      project, poly, dist, result);
+  flipper.run();
 
 #if defined(CARVE_DEBUG)
   if (!warn) {
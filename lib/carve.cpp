@@ -27,10 +27,17 @@
 #endif
 
 #include <carve/carve.hpp>
+#include <carve/predicates.hpp>
 
 #define DEF_EPSILON 1.4901161193847656e-08
 
 namespace carve {
 double EPSILON = DEF_EPSILON;
 double EPSILON2 = DEF_EPSILON * DEF_EPSILON;
+#if defined(CARVE_USE_EXACT_PREDICATES)
+thread_local PredicateMode predicate_mode = PREDICATES_FILTERED;
+#else
+thread_local PredicateMode predicate_mode = PREDICATES_FAST;
+#endif
+predicate_stats_t predicate_stats;
 }
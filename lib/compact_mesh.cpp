@@ -0,0 +1,164 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/compact_mesh.hpp>
+#include <carve/geom3d.hpp>
+
+#include <algorithm>
+
+namespace carve {
+namespace mesh {
+
+namespace {
+struct compact_vertex_mapping {
+  const CompactMeshSet* mesh;
+  compact_vertex_mapping(const CompactMeshSet* _mesh) : mesh(_mesh) {}
+  CompactMeshSet::vector_t operator()(uint32_t i) const {
+    return mesh->vertex(i);
+  }
+};
+}  // namespace
+
+CompactMeshSet::CompactMeshSet() : coords(), face_start(1, 0), face_verts() {}
+
+CompactMeshSet::CompactMeshSet(const std::vector<vector_t>& points,
+                               size_t n_faces,
+                               const std::vector<int>& face_indices)
+    : coords(), face_start(), face_verts() {
+  coords.reserve(points.size() * 3);
+  for (size_t i = 0; i < points.size(); ++i) {
+    addVertex(points[i]);
+  }
+
+  face_start.reserve(n_faces + 1);
+  face_verts.reserve(face_indices.size() - n_faces);
+  face_start.push_back(0);
+  for (size_t i = 0, f = 0; f < n_faces; ++f) {
+    const size_t n = face_indices[i++];
+    addFace(face_indices.begin() + i, face_indices.begin() + i + n);
+    i += n;
+  }
+}
+
+CompactMeshSet::CompactMeshSet(const MeshSet<3>* mesh)
+    : coords(), face_start(), face_verts() {
+  const std::vector<MeshSet<3>::vertex_t>& vs = mesh->vertex_storage;
+  coords.reserve(vs.size() * 3);
+  for (size_t i = 0; i < vs.size(); ++i) {
+    addVertex(vs[i].v);
+  }
+
+  face_start.push_back(0);
+  for (MeshSet<3>::const_face_iter i = mesh->faceBegin(); i != mesh->faceEnd();
+       ++i) {
+    const MeshSet<3>::face_t* face = *i;
+    const MeshSet<3>::edge_t* e = face->edge;
+    do {
+      face_verts.push_back((uint32_t)(e->vert - &vs[0]));
+      e = e->next;
+    } while (e != face->edge);
+    face_start.push_back((uint32_t)face_verts.size());
+  }
+}
+
+size_t CompactMeshSet::addVertex(const vector_t& v) {
+  const size_t index = vertexCount();
+  coords.push_back((float)v.x);
+  coords.push_back((float)v.y);
+  coords.push_back((float)v.z);
+  return index;
+}
+
+carve::geom::plane<3> CompactMeshSet::facePlane(size_t f) const {
+  carve::geom::plane<3> plane;
+  compact_vertex_mapping adapt(this);
+  carve::geom3d::fitPlane(faceBegin(f), faceEnd(f), adapt, plane);
+
+  // orient by winding: Newell's normal.
+  vector_t n = vector_t::ZERO();
+  const uint32_t* b = faceBegin(f);
+  const size_t sz = faceSize(f);
+  for (size_t i = 0; i < sz; ++i) {
+    n += cross(vertex(b[i]), vertex(b[(i + 1) % sz]));
+  }
+  if (dot(n, plane.N) < 0.0) {
+    plane.negate();
+  }
+  return plane;
+}
+
+carve::geom::aabb<3> CompactMeshSet::faceAABB(size_t f) const {
+  carve::geom::aabb<3> aabb;
+  aabb.fit(faceBegin(f), faceEnd(f), compact_vertex_mapping(this));
+  return aabb;
+}
+
+carve::geom::aabb<3> CompactMeshSet::getAABB() const {
+  if (coords.empty()) {
+    return carve::geom::aabb<3>();
+  }
+  float lo[3], hi[3];
+  for (unsigned j = 0; j < 3; ++j) {
+    lo[j] = hi[j] = coords[j];
+  }
+  for (size_t i = 3; i < coords.size(); i += 3) {
+    for (unsigned j = 0; j < 3; ++j) {
+      lo[j] = std::min(lo[j], coords[i + j]);
+      hi[j] = std::max(hi[j], coords[i + j]);
+    }
+  }
+  carve::geom::aabb<3> aabb;
+  aabb.fit(carve::geom::VECTOR(lo[0], lo[1], lo[2]),
+           carve::geom::VECTOR(hi[0], hi[1], hi[2]));
+  return aabb;
+}
+
+size_t CompactMeshSet::memoryUsage() const {
+  return coords.capacity() * sizeof(float) +
+         face_start.capacity() * sizeof(uint32_t) +
+         face_verts.capacity() * sizeof(uint32_t);
+}
+
+MeshSet<3>* CompactMeshSet::toMeshSet(const MeshOptions& opts) const {
+  std::vector<vector_t> points;
+  points.reserve(vertexCount());
+  for (size_t i = 0; i < vertexCount(); ++i) {
+    points.push_back(vertex(i));
+  }
+
+  std::vector<int> face_indices;
+  face_indices.reserve(face_verts.size() + faceCount());
+  for (size_t f = 0; f < faceCount(); ++f) {
+    face_indices.push_back((int)faceSize(f));
+    face_indices.insert(face_indices.end(), faceBegin(f), faceEnd(f));
+  }
+
+  return new MeshSet<3>(points, faceCount(), face_indices, opts);
+}
+}  // namespace mesh
+}  // namespace carve
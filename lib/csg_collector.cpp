@@ -69,15 +69,10 @@ class BaseCollector : public CSG::Collector {
   void FWD(const carve::mesh::MeshSet<3>::face_t* orig_face,
            const std::vector<carve::mesh::MeshSet<3>::vertex_t*>& vertices,
            carve::geom3d::Vector /* normal */, bool /* poly_a */,
-           FaceClass face_class, CSG::Hooks& hooks) {
-    std::vector<carve::mesh::MeshSet<3>::face_t*> new_faces;
-    new_faces.reserve(1);
-    new_faces.push_back(
-        orig_face->create(vertices.begin(), vertices.end(), false));
-    hooks.processOutputFace(new_faces, orig_face, false);
-    for (size_t i = 0; i < new_faces.size(); ++i) {
-      faces.push_back(face_data_t(new_faces[i], orig_face, false));
-    }
+           FaceClass face_class, CSG::Hooks& /* hooks */) {
+    faces.push_back(face_data_t(
+        orig_face->create(vertices.begin(), vertices.end(), false), orig_face,
+        false));
 
 #if defined(CARVE_DEBUG) && defined(DEBUG_PRINT_RESULT_FACES)
     std::cerr << "+" << ENUM(face_class) << " ";
@@ -90,16 +85,11 @@ class BaseCollector : public CSG::Collector {
   void REV(const carve::mesh::MeshSet<3>::face_t* orig_face,
            const std::vector<carve::mesh::MeshSet<3>::vertex_t*>& vertices,
            carve::geom3d::Vector /* normal */, bool /* poly_a */,
-           FaceClass face_class, CSG::Hooks& hooks) {
+           FaceClass face_class, CSG::Hooks& /* hooks */) {
     // normal = -normal;
-    std::vector<carve::mesh::MeshSet<3>::face_t*> new_faces;
-    new_faces.reserve(1);
-    new_faces.push_back(
-        orig_face->create(vertices.begin(), vertices.end(), true));
-    hooks.processOutputFace(new_faces, orig_face, true);
-    for (size_t i = 0; i < new_faces.size(); ++i) {
-      faces.push_back(face_data_t(new_faces[i], orig_face, true));
-    }
+    faces.push_back(face_data_t(
+        orig_face->create(vertices.begin(), vertices.end(), true), orig_face,
+        true));
 
 #if defined(CARVE_DEBUG) && defined(DEBUG_PRINT_RESULT_FACES)
     std::cerr << "-" << ENUM(face_class) << " ";
@@ -217,7 +207,48 @@ class BaseCollector : public CSG::Collector {
     }
   }
 
+  // output faces are handed to processOutputFace hooks once collection
+  // is complete rather than as they are collected, so that when every
+  // hook is thread safe (e.g. triangulation) the faces can be processed
+  // in parallel. the order of the result is the same either way.
+  void processOutputFaces(CSG::Hooks& hooks) {
+    std::vector<face_data_t> in(faces.begin(), faces.end());
+    std::vector<std::vector<carve::mesh::MeshSet<3>::face_t*> > out(
+        in.size());
+    const int N = (int)in.size();
+    const bool parallel =
+        hooks.isThreadSafe(CSG::Hooks::PROCESS_OUTPUT_FACE_HOOK);
+    // the predicate mode is per thread; hooks run under the caller's.
+    const carve::PredicateMode mode = carve::predicate_mode;
+
+    carve::ParallelExceptionCapture errors;
+
+#pragma omp parallel for schedule(dynamic, 16) if (parallel)
+    for (int i = 0; i < N; ++i) {
+      try {
+        carve::PredicateModeScope predicates(mode);
+        out[i].push_back(in[i].face);
+        hooks.processOutputFace(out[i], in[i].orig_face, in[i].flipped);
+      } catch (...) {
+        errors.capture();
+      }
+    }
+    errors.rethrow();
+
+    faces.clear();
+    for (size_t i = 0; i < in.size(); ++i) {
+      for (size_t j = 0; j < out[i].size(); ++j) {
+        faces.push_back(
+            face_data_t(out[i][j], in[i].orig_face, in[i].flipped));
+      }
+    }
+  }
+
   carve::mesh::MeshSet<3>* done(CSG::Hooks& hooks) override {
+    if (hooks.hasHook(CSG::Hooks::PROCESS_OUTPUT_FACE_HOOK)) {
+      processOutputFaces(hooks);
+    }
+
     std::vector<carve::mesh::MeshSet<3>::face_t*> f;
     f.reserve(faces.size());
     for (std::list<face_data_t>::iterator i = faces.begin(); i != faces.end();
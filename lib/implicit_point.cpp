@@ -0,0 +1,135 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/exact.hpp>
+#include <carve/implicit_point.hpp>
+
+#include <cmath>
+
+namespace carve {
+namespace geom3d {
+
+namespace {
+typedef carve::exact::exact_t expansion_t;
+
+// The plane's function at x, exactly: N.x + d for a PLANE, and
+// orient3d(a, b, c, x) for POINTS. An implicit point is unchanged by
+// scaling the function, so the two need not agree in scale or sign.
+void evaluate(const ExactPlane& plane, const Vector& x, expansion_t& r) {
+  if (plane.kind == ExactPlane::POINTS) {
+    carve::exact::orient3dexpansion(plane.a.v, plane.b.v, plane.c.v, x.v, r);
+    return;
+  }
+
+  // the trailing zeroes pad each term, as sum_zeroelim() reads one
+  // component past the end of its inputs.
+  double t[3][3];
+  for (unsigned i = 0; i < 3; ++i) {
+    carve::exact::detail::prod_1_1(&plane.a.v[i], &x.v[i], t[i]);
+    t[i][2] = 0.0;
+  }
+  double d[2] = {plane.b.x, 0.0};
+
+  expansion_t s1, s2;
+  carve::exact::sum_zeroelim(t[0], t[0] + 2, t[1], t[1] + 2, s1);
+  carve::exact::sum_zeroelim(s1, t[2], t[2] + 2, s2);
+  carve::exact::sum_zeroelim(s2, d, d + 1, r);
+}
+
+inline int sgn(double x) {
+  return x < 0.0 ? -1 : x > 0.0 ? +1 : 0;
+}
+}  // namespace
+
+bool ImplicitPoint::valid() const {
+  expansion_t fp, fq, w;
+  evaluate(plane, p, fp);
+  evaluate(plane, q, fq);
+  carve::exact::diff_zeroelim(fp, fq, w);
+  return carve::exact::sign(w) != 0;
+}
+
+Vector ImplicitPoint::approx() const {
+  // the point is p + (q - p) * fp / (fp - fq); interpolate from
+  // whichever end is nearer.
+  expansion_t fp, fq, w;
+  evaluate(plane, p, fp);
+  evaluate(plane, q, fq);
+  carve::exact::diff_zeroelim(fp, fq, w);
+  const double ep = fp, eq = fq, ew = w;
+  if (std::fabs(ep) <= std::fabs(eq)) {
+    return p + (q - p) * (ep / ew);
+  }
+  return q + (p - q) * (-eq / ew);
+}
+
+ImplicitParameter::ImplicitParameter(const ImplicitPoint& pt) {
+  evaluate(pt.plane, pt.p, fp);
+  evaluate(pt.plane, pt.q, fq);
+  ep = fp;
+  eq = fq;
+}
+
+int compareAlong(const ImplicitParameter& a, const ImplicitParameter& b) {
+  // a is at parameter t_a = fp_a / (fp_a - fq_a) along the line, and
+  // sign(t_a - t_b) = sign(fp_b * fq_a - fp_a * fq_b) * sign(w_a * w_b)
+  // where w = fp - fq.
+
+  // the estimates of the plane functions are accurate to a few ulps,
+  // so a generous error bound decides almost every comparison
+  // without further expansion arithmetic.
+  const double bound = 16.0 * carve::exact::detail::constants.epsilon;
+  const double wa = a.ep - a.eq, wb = b.ep - b.eq;
+  const double det = b.ep * a.eq - a.ep * b.eq;
+  if (std::fabs(wa) > bound * (std::fabs(a.ep) + std::fabs(a.eq)) &&
+      std::fabs(wb) > bound * (std::fabs(b.ep) + std::fabs(b.eq)) &&
+      std::fabs(det) >
+          bound * (std::fabs(b.ep * a.eq) + std::fabs(a.ep * b.eq))) {
+    return sgn(det) * sgn(wa) * sgn(wb);
+  }
+
+  expansion_t t1, t2, d, w;
+  carve::exact::product_zeroelim(b.fp, a.fq, t1);
+  carve::exact::product_zeroelim(a.fp, b.fq, t2);
+  carve::exact::diff_zeroelim(t1, t2, d);
+  int s = carve::exact::sign(d);
+  if (s == 0) {
+    return 0;
+  }
+  carve::exact::diff_zeroelim(a.fp, a.fq, w);
+  s *= carve::exact::sign(w);
+  carve::exact::diff_zeroelim(b.fp, b.fq, w);
+  s *= carve::exact::sign(w);
+  return s;
+}
+
+int compareAlong(const ImplicitPoint& a, const ImplicitPoint& b) {
+  return compareAlong(ImplicitParameter(a), ImplicitParameter(b));
+}
+}  // namespace geom3d
+}  // namespace carve
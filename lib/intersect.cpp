@@ -27,14 +27,18 @@
 #endif
 
 #include <carve/csg.hpp>
+#include <carve/linear_octree.hpp>
+#include <carve/morton.hpp>
 #include <carve/pointset.hpp>
 #include <carve/polyline.hpp>
+#include <carve/small_vector.hpp>
 
 #include <iostream>
 #include <list>
 #include <set>
 
 #include <algorithm>
+#include <iterator>
 
 #include "csg_data.hpp"
 #include "csg_detail.hpp"
@@ -50,6 +54,10 @@
 
 #include <memory>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 carve::csg::VertexPool::VertexPool() {}
 
 carve::csg::VertexPool::~VertexPool() {}
@@ -179,6 +187,86 @@ void orderEdgeIntersectionVertices(
   }
 }
 
+struct implicit_edge_vertex {
+  carve::geom3d::ImplicitParameter t;
+  double ovec;
+  carve::mesh::MeshSet<3>::vertex_t* vertex;
+
+  implicit_edge_vertex(const carve::geom3d::ImplicitPoint& _pt, double _ovec,
+                       carve::mesh::MeshSet<3>::vertex_t* _vertex)
+      : t(_pt), ovec(_ovec), vertex(_vertex) {}
+
+  bool operator<(const implicit_edge_vertex& o) const {
+    int c = carve::geom3d::compareAlong(t, o.t);
+    if (c) {
+      return c < 0;
+    }
+    if (ovec != o.ovec) {
+      return ovec > o.ovec;
+    }
+    return vertex < o.vertex;
+  }
+};
+
+/**
+ * \brief As orderEdgeIntersectionVertices(), but ordering the
+ * vertices exactly by their implicit forms on the edge from \a v1 to
+ * \a v2.
+ *
+ * @return false, leaving \a out untouched, if any vertex has no
+ *         implicit form on that edge.
+ */
+template <typename iter_t, typename implicit_map_t>
+bool orderImplicitEdgeIntersectionVertices(
+    iter_t beg, const iter_t end,
+    const carve::mesh::MeshSet<3>::vertex_t::vector_t& v1,
+    const carve::mesh::MeshSet<3>::vertex_t::vector_t& v2,
+    const implicit_map_t& implicit_vertices,
+    std::vector<carve::mesh::MeshSet<3>::vertex_t*>& out) {
+  std::vector<implicit_edge_vertex> ordered_vertices;
+
+  ordered_vertices.reserve(std::distance(beg, end));
+
+  for (; beg != end; ++beg) {
+    carve::mesh::MeshSet<3>::vertex_t* v = (*beg).first;
+    typename implicit_map_t::const_iterator i = implicit_vertices.find(v);
+    if (i == implicit_vertices.end()) {
+      return false;
+    }
+    double ovec = 0.0;
+    for (carve::csg::detail::EdgeIntInfo::mapped_type::const_iterator j =
+             (*beg).second.begin();
+         j != (*beg).second.end(); ++j) {
+      ovec += (*j).second;
+    }
+    size_t n = ordered_vertices.size();
+    for (size_t j = 0; j < (*i).second.size(); ++j) {
+      const carve::geom3d::ImplicitPoint& pt = (*i).second[j];
+      if (pt.p == v1 && pt.q == v2) {
+        ordered_vertices.push_back(implicit_edge_vertex(pt, ovec, v));
+        break;
+      }
+      if (pt.p == v2 && pt.q == v1) {
+        ordered_vertices.push_back(
+            implicit_edge_vertex(pt.reversed(), ovec, v));
+        break;
+      }
+    }
+    if (ordered_vertices.size() == n) {
+      return false;
+    }
+  }
+
+  std::sort(ordered_vertices.begin(), ordered_vertices.end());
+
+  out.clear();
+  out.reserve(ordered_vertices.size());
+  for (size_t i = 0; i < ordered_vertices.size(); ++i) {
+    out.push_back(ordered_vertices[i].vertex);
+  }
+  return true;
+}
+
 /**
  *
  *
@@ -409,6 +497,16 @@ bool carve::csg::CSG::Hooks::hasHook(unsigned hook_num) {
   return hooks[hook_num].size() > 0;
 }
 
+bool carve::csg::CSG::Hooks::isThreadSafe(unsigned hook_num) {
+  for (std::list<Hook*>::iterator j = hooks[hook_num].begin();
+       j != hooks[hook_num].end(); ++j) {
+    if (!(*j)->isThreadSafe()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void carve::csg::CSG::Hooks::intersectionVertex(
     const meshset_t::vertex_t* vertex, const IObjPairSet& intersections) {
   for (std::list<Hook*>::iterator j = hooks[INTERSECTION_VERTEX_HOOK].begin();
@@ -565,43 +663,43 @@ static const carve::mesh::MeshSet<3>::vertex_t* weld(
 }
 
 void carve::csg::CSG::groupIntersections() {
-#if 0  // old code, to be removed.
   static carve::TimingName GROUP_INTERSECTONS("groupIntersections()");
-
   carve::TimingBlock block(GROUP_INTERSECTONS);
-  
-  std::vector<meshset_t::vertex_t *> vertices;
+
+  std::vector<meshset_t::vertex_t*> vertices;
   detail::VVSMap graph;
 #if defined(CARVE_DEBUG)
-  std::cerr << "groupIntersections()" << ": vertex_intersections.size()==" << vertex_intersections.size() << std::endl;
+  std::cerr << "groupIntersections()"
+            << ": vertex_intersections.size()==" << vertex_intersections.size()
+            << std::endl;
 #endif
 
   vertices.reserve(vertex_intersections.size());
   for (carve::csg::VertexIntersections::const_iterator
-         i = vertex_intersections.begin(),
-         e = vertex_intersections.end();
-       i != e;
-       ++i) 
-    {
-      vertices.push_back((*i).first);
-    }
-  carve::geom3d::AABB aabb;
-  aabb.fit(vertices.begin(), vertices.end(), carve::poly::vec_adapt_vertex_ptr());
-  Octree vertex_intersections_octree;
-  vertex_intersections_octree.setBounds(aabb);
-
-  vertex_intersections_octree.addVertices(vertices);
-      
-  std::vector<meshset_t::vertex_t *> out;
+           i = vertex_intersections.begin(),
+           e = vertex_intersections.end();
+       i != e; ++i) {
+    vertices.push_back((*i).first);
+  }
+
+  carve::geom::LinearOctree<meshset_t::vertex_t*> vertex_intersections_octree(
+      vertices.begin(), vertices.end());
+
+  const carve::geom3d::Vector eps =
+      carve::geom::VECTOR(carve::EPSILON, carve::EPSILON, carve::EPSILON);
+  std::vector<meshset_t::vertex_t*> out;
   for (size_t i = 0, l = vertices.size(); i != l; ++i) {
-    // let's find all the vertices near this one. 
+    // let's find all the vertices near this one.
     out.clear();
-    vertex_intersections_octree.findVerticesNearAllowDupes(vertices[i]->v, out);
+    vertex_intersections_octree.search(
+        carve::geom3d::AABB(vertices[i]->v, eps), std::back_inserter(out));
 
     for (size_t j = 0; j < out.size(); ++j) {
-      if (vertices[i] != out[j] && carve::geom::equal(vertices[i]->v, out[j]->v)) {
+      if (vertices[i] != out[j] &&
+          carve::geom::equal(vertices[i]->v, out[j]->v)) {
 #if defined(CARVE_DEBUG)
-        std::cerr << "EQ: " << vertices[i] << "," << out[j] << " " << vertices[i]->v << "," << out[j]->v << std::endl;
+        std::cerr << "EQ: " << vertices[i] << "," << out[j] << " "
+                  << vertices[i]->v << "," << out[j]->v << std::endl;
 #endif
         graph[vertices[i]].insert(out[j]);
         graph[out[j]].insert(vertices[i]);
@@ -617,16 +715,14 @@ void carve::csg::CSG::groupIntersections() {
     open.insert((*i).first);
     while (open.size()) {
       detail::VSet::iterator t = open.begin();
-      const meshset_t::vertex_t *o = (*t);
+      meshset_t::vertex_t* o = (*t);
       open.erase(t);
       i = graph.find(o);
       CARVE_ASSERT(i != graph.end());
       visited.insert(o);
-      for (detail::VVSMap::mapped_type::const_iterator
-             j = (*i).second.begin(),
-             je = (*i).second.end();
-           j != je;
-           ++j) {
+      for (detail::VVSMap::mapped_type::const_iterator j = (*i).second.begin(),
+                                                       je = (*i).second.end();
+           j != je; ++j) {
         if (visited.count((*j)) == 0) {
           open.insert((*j));
         }
@@ -635,7 +731,6 @@ void carve::csg::CSG::groupIntersections() {
     }
     weld(visited, vertex_intersections, vertex_pool);
   }
-#endif
 }
 
 static void recordEdgeIntersectionInfo(
@@ -788,6 +883,19 @@ void carve::csg::CSG::generateVertexEdgeIntersections(
   } while (ea != a->edge);
 }
 
+// A plane containing the line through b1 and b2, and as far as
+// possible from containing the line through a1 and a2: the
+// intersection of the two lines, as a point on the first, is the
+// intersection of that line with this plane.
+static carve::geom3d::ExactPlane edgeEdgePlane(
+    const carve::geom3d::Vector& a1, const carve::geom3d::Vector& a2,
+    const carve::geom3d::Vector& b1, const carve::geom3d::Vector& b2) {
+  int axis = carve::geom::largestAxis(carve::geom::cross(a2 - a1, b2 - b1));
+  carve::geom3d::Vector b3 = b1;
+  b3.v[axis] += (b2 - b1).length();
+  return carve::geom3d::ExactPlane(b1, b2, b3);
+}
+
 void carve::csg::CSG::_generateEdgeEdgeIntersections(meshset_t::edge_t* ea,
                                                      meshset_t::edge_t* eb) {
   if (intersections.intersects(ea, eb)) {
@@ -813,7 +921,21 @@ void carve::csg::CSG::_generateEdgeEdgeIntersections(meshset_t::edge_t* ea,
     case carve::RR_INTERSECTION: {
       // edges intersect
       if (mu1 >= 0.0 && mu1 <= 1.0 && mu2 >= 0.0 && mu2 <= 1.0) {
-        meshset_t::vertex_t* p = vertex_pool.get((p1 + p2) / 2.0);
+        meshset_t::vertex_t* p = nullptr;
+        if (implicit_intersections) {
+          carve::geom3d::ImplicitPoint ip_a(
+              v1->v, v2->v, edgeEdgePlane(v1->v, v2->v, v3->v, v4->v));
+          carve::geom3d::ImplicitPoint ip_b(
+              v3->v, v4->v, edgeEdgePlane(v3->v, v4->v, v1->v, v2->v));
+          if (ip_a.valid() && ip_b.valid()) {
+            p = vertex_pool.get(ip_a.approx());
+            implicit_vertices[p].push_back(ip_a);
+            implicit_vertices[p].push_back(ip_b);
+          }
+        }
+        if (p == nullptr) {
+          p = vertex_pool.get((p1 + p2) / 2.0);
+        }
         intersections.record(ea, eb, p);
         if (ea->rev) {
           intersections.record(ea->rev, eb, p);
@@ -896,7 +1018,18 @@ void carve::csg::CSG::_generateEdgeFaceIntersections(meshset_t::face_t* fa,
   meshset_t::vertex_t::vector_t _p;
   if (fa->simpleLineSegmentIntersection(
           carve::geom3d::LineSegment(eb->v1()->v, eb->v2()->v), _p)) {
-    meshset_t::vertex_t* p = vertex_pool.get(_p);
+    meshset_t::vertex_t* p = nullptr;
+    if (implicit_intersections) {
+      carve::geom3d::ImplicitPoint ip(eb->v1()->v, eb->v2()->v,
+                                      carve::geom3d::ExactPlane(fa->plane));
+      if (ip.valid()) {
+        p = vertex_pool.get(ip.approx());
+        implicit_vertices[p].push_back(ip);
+      }
+    }
+    if (p == nullptr) {
+      p = vertex_pool.get(_p);
+    }
     intersections.record(eb, fa, p);
     if (eb->rev) {
       intersections.record(eb->rev, fa, p);
@@ -918,22 +1051,69 @@ void carve::csg::CSG::generateEdgeFaceIntersections(
   }
 }
 
+// Narrow phase test for a pair of faces whose bounding boxes are
+// within EPSILON: true if the faces are within EPSILON of each other
+// along both face normals, and are not coplanar.
+static bool facePlanesMayIntersect(carve::mesh::MeshSet<3>::face_t* fa,
+                                   carve::mesh::MeshSet<3>::face_t* fb) {
+  std::pair<double, double> a_ra =
+      fa->rangeInDirection(fa->plane.N, fa->edge->vert->v);
+  std::pair<double, double> b_ra =
+      fb->rangeInDirection(fa->plane.N, fa->edge->vert->v);
+  if (carve::rangeSeparation(a_ra, b_ra) > carve::EPSILON) {
+    return false;
+  }
+
+  std::pair<double, double> a_rb =
+      fa->rangeInDirection(fb->plane.N, fb->edge->vert->v);
+  std::pair<double, double> b_rb =
+      fb->rangeInDirection(fb->plane.N, fb->edge->vert->v);
+  if (carve::rangeSeparation(a_rb, b_rb) > carve::EPSILON) {
+    return false;
+  }
+
+  return !facesAreCoplanar(fa, fb);
+}
+
+// Narrow phase test for a candidate pair of faces: true if the
+// faces are within EPSILON of each other in their bounding boxes and
+// along both face normals, and are not coplanar.
+static bool facePairMayIntersect(carve::mesh::MeshSet<3>::face_t* fa,
+                                 const carve::geom::aabb<3>& aabb_a,
+                                 carve::mesh::MeshSet<3>::face_t* fb,
+                                 const carve::geom::aabb<3>& aabb_b) {
+  if (aabb_b.maxAxisSeparation(aabb_a) > carve::EPSILON) {
+    return false;
+  }
+  return facePlanesMayIntersect(fa, fb);
+}
+
 void carve::csg::CSG::generateIntersectionCandidates(
     meshset_t* a, const face_rtree_t* a_node, meshset_t* b,
-    const face_rtree_t* b_node, face_pairs_t& face_pairs, bool descend_a) {
+    const face_rtree_t* b_node, face_pairs_t& face_pairs,
+    carve::geom::aabb_packet<3>& b_boxes, bool descend_a) {
   if (!a_node->bbox.intersects(b_node->bbox)) {
     return;
   }
 
   if (a_node->child && (descend_a || !b_node->child)) {
     for (face_rtree_t* node = a_node->child; node; node = node->sibling) {
-      generateIntersectionCandidates(a, node, b, b_node, face_pairs, false);
+      generateIntersectionCandidates(a, node, b, b_node, face_pairs, b_boxes,
+                                     false);
     }
   } else if (b_node->child) {
     for (face_rtree_t* node = b_node->child; node; node = node->sibling) {
-      generateIntersectionCandidates(a, a_node, b, node, face_pairs, true);
+      generateIntersectionCandidates(a, a_node, b, node, face_pairs, b_boxes,
+                                     true);
     }
   } else {
+    const size_t n_b = b_node->data.size();
+    b_boxes.clear();
+    for (size_t j = 0; j < n_b; ++j) {
+      b_boxes.push_back(b_node->data[j]->getAABB());
+    }
+    carve::small_vector<bool, 16> hit(n_b, false);
+
     for (size_t i = 0; i < a_node->data.size(); ++i) {
       meshset_t::face_t* fa = a_node->data[i];
       carve::geom::aabb<3> aabb_a = fa->getAABB();
@@ -941,36 +1121,220 @@ void carve::csg::CSG::generateIntersectionCandidates(
         continue;
       }
 
-      for (size_t j = 0; j < b_node->data.size(); ++j) {
+      if (!carve::geom::intersects(aabb_a, b_boxes, &hit[0],
+                                   carve::EPSILON)) {
+        continue;
+      }
+      for (size_t j = 0; j < n_b; ++j) {
         meshset_t::face_t* fb = b_node->data[j];
-        carve::geom::aabb<3> aabb_b = fb->getAABB();
-        if (aabb_b.maxAxisSeparation(aabb_a) > carve::EPSILON) {
-          continue;
+        if (hit[j] && facePlanesMayIntersect(fa, fb)) {
+          face_pairs[fa].push_back(fb);
+          face_pairs[fb].push_back(fa);
         }
+      }
+    }
+  }
+}
 
-        std::pair<double, double> a_ra =
-            fa->rangeInDirection(fa->plane.N, fa->edge->vert->v);
-        std::pair<double, double> b_ra =
-            fb->rangeInDirection(fa->plane.N, fa->edge->vert->v);
-        if (carve::rangeSeparation(a_ra, b_ra) > carve::EPSILON) {
-          continue;
-        }
+namespace {
+// Grid cells are this multiple of the mean edge length.
+const double GRID_CELL_SCALE = 2.0;
+// Fall back to the R-tree if the coefficient of variation of edge
+// length exceeds this.
+const double GRID_MAX_EDGE_CV = 1.0;
+// ... or if faces would be binned into more than this many cells
+// each, on average.
+const double GRID_MAX_CELLS_PER_FACE = 8.0;
+
+struct grid_face_t {
+  carve::mesh::MeshSet<3>::face_t* face;
+  carve::geom::aabb<3> bbox;
+  uint32_t lo[3], hi[3];
+};
+}  // namespace
+
+bool carve::csg::CSG::generateGridIntersectionCandidates(
+    meshset_t* a, meshset_t* b, face_pairs_t& face_pairs) {
+  static carve::TimingName FUNC_NAME(
+      "CSG::generateGridIntersectionCandidates()");
+  carve::TimingBlock block(FUNC_NAME);
+
+  // only faces that intersect the overlap of the two inputs can
+  // form candidate pairs.
+  carve::geom::aabb<3> a_box = a->getAABB();
+  carve::geom::aabb<3> b_box = b->getAABB();
+  carve::geom::vector<3> o_min, o_max;
+  for (unsigned i = 0; i < 3; ++i) {
+    o_min.v[i] = std::max(a_box.min(i), b_box.min(i)) - carve::EPSILON;
+    o_max.v[i] = std::min(a_box.max(i), b_box.max(i)) + carve::EPSILON;
+    if (o_min.v[i] > o_max.v[i]) {
+      return true;
+    }
+  }
+  carve::geom::aabb<3> overlap;
+  overlap.fit(o_min, o_max);
+
+  std::vector<grid_face_t> faces;
+  size_t n_a = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    meshset_t* m = pass ? b : a;
+    for (meshset_t::face_iter i = m->faceBegin(); i != m->faceEnd(); ++i) {
+      grid_face_t gf;
+      gf.face = *i;
+      gf.bbox = gf.face->getAABB();
+      gf.bbox.expand(carve::EPSILON);
+      if (gf.bbox.intersects(overlap)) {
+        faces.push_back(gf);
+      }
+    }
+    if (!pass) {
+      n_a = faces.size();
+    }
+  }
+  const int N = (int)faces.size();
+  if (n_a == 0 || (size_t)N == n_a) {
+    return true;
+  }
 
-        std::pair<double, double> a_rb =
-            fa->rangeInDirection(fb->plane.N, fb->edge->vert->v);
-        std::pair<double, double> b_rb =
-            fb->rangeInDirection(fb->plane.N, fb->edge->vert->v);
-        if (carve::rangeSeparation(a_rb, b_rb) > carve::EPSILON) {
-          continue;
+  // cell size from edge length statistics.
+  double sum = 0.0, sum2 = 0.0, count = 0.0;
+#pragma omp parallel for reduction(+ : sum, sum2, count)
+  for (int i = 0; i < N; ++i) {
+    const meshset_t::edge_t* e = faces[i].face->edge;
+    do {
+      double l = e->length();
+      sum += l;
+      sum2 += l * l;
+      count += 1.0;
+      e = e->next;
+    } while (e != faces[i].face->edge);
+  }
+  const double mean = sum / count;
+  const double var = std::max(0.0, sum2 / count - mean * mean);
+  if (!(mean > 0.0) || sqrt(var) / mean > GRID_MAX_EDGE_CV) {
+#if defined(CARVE_DEBUG)
+    std::cerr << "grid broadphase: edge length cv=" << sqrt(var) / mean
+              << "; falling back to rtree" << std::endl;
+#endif
+    return false;
+  }
+
+  double cell = GRID_CELL_SCALE * mean;
+  const double max_cells = (double)((1U << carve::geom::morton<3>::bits) - 1);
+  for (unsigned i = 0; i < 3; ++i) {
+    cell = std::max(cell, 2.0 * overlap.extent.v[i] / max_cells);
+  }
+  const double inv_cell = 1.0 / cell;
+
+  // bin faces into cells, clipped to the overlap region.
+  std::vector<size_t> n_cells(N + 1);
+#pragma omp parallel for
+  for (int i = 0; i < N; ++i) {
+    grid_face_t& gf = faces[i];
+    size_t n = 1;
+    for (unsigned j = 0; j < 3; ++j) {
+      double lo = std::max(gf.bbox.min(j), o_min.v[j]) - o_min.v[j];
+      double hi = std::min(gf.bbox.max(j), o_max.v[j]) - o_min.v[j];
+      gf.lo[j] = (uint32_t)std::min(std::max(lo * inv_cell, 0.0), max_cells);
+      gf.hi[j] = (uint32_t)std::min(std::max(hi * inv_cell, 0.0), max_cells);
+      n *= gf.hi[j] - gf.lo[j] + 1;
+    }
+    n_cells[i + 1] = n;
+  }
+  for (int i = 0; i < N; ++i) {
+    n_cells[i + 1] += n_cells[i];
+  }
+  if ((double)n_cells[N] > GRID_MAX_CELLS_PER_FACE * N) {
+#if defined(CARVE_DEBUG)
+    std::cerr << "grid broadphase: " << n_cells[N] << " cell entries for " << N
+              << " faces; falling back to rtree" << std::endl;
+#endif
+    return false;
+  }
+
+  std::vector<std::pair<uint64_t, uint32_t> > entries(n_cells[N]);
+#pragma omp parallel for
+  for (int i = 0; i < N; ++i) {
+    const grid_face_t& gf = faces[i];
+    size_t k = n_cells[i];
+    uint32_t c[3];
+    for (c[2] = gf.lo[2]; c[2] <= gf.hi[2]; ++c[2]) {
+      for (c[1] = gf.lo[1]; c[1] <= gf.hi[1]; ++c[1]) {
+        for (c[0] = gf.lo[0]; c[0] <= gf.hi[0]; ++c[0]) {
+          entries[k++] =
+              std::make_pair(carve::geom::morton<3>::encode(c), (uint32_t)i);
         }
+      }
+    }
+  }
 
-        if (!facesAreCoplanar(fa, fb)) {
-          face_pairs[fa].push_back(fb);
-          face_pairs[fb].push_back(fa);
+  // the sort is stable, so within a cell, faces of a precede faces
+  // of b.
+  carve::geom::radix_sort(entries, 3 * carve::geom::morton<3>::bits);
+
+  // find cells containing faces from both a and b.
+  std::vector<std::pair<size_t, size_t> > runs;
+  for (size_t i = 0, e = entries.size(); i != e;) {
+    size_t j = i + 1;
+    while (j != e && entries[j].first == entries[i].first) {
+      ++j;
+    }
+    if (entries[i].second < n_a && entries[j - 1].second >= n_a) {
+      runs.push_back(std::make_pair(i, j));
+    }
+    i = j;
+  }
+
+  // test pairs within each cell. A pair that shares several cells is
+  // only tested in the cell containing the minimum corner of the
+  // intersection of their bounding boxes.
+  const int R = (int)runs.size();
+  int n_threads = 1;
+#if defined(_OPENMP)
+  n_threads = omp_get_max_threads();
+#endif
+  std::vector<std::vector<std::pair<meshset_t::face_t*, meshset_t::face_t*> > >
+      found(n_threads);
+
+#pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t) {
+    for (int r = R * t / n_threads, re = R * (t + 1) / n_threads; r != re;
+         ++r) {
+      const size_t begin = runs[r].first;
+      const size_t end = runs[r].second;
+      size_t mid = begin;
+      while (entries[mid].second < n_a) {
+        ++mid;
+      }
+      uint32_t cell_c[3];
+      carve::geom::morton<3>::decode(entries[begin].first, cell_c);
+
+      for (size_t i = begin; i != mid; ++i) {
+        const grid_face_t& ga = faces[entries[i].second];
+        for (size_t j = mid; j != end; ++j) {
+          const grid_face_t& gb = faces[entries[j].second];
+          bool ref = true;
+          for (unsigned k = 0; ref && k < 3; ++k) {
+            ref = std::max(ga.lo[k], gb.lo[k]) == cell_c[k];
+          }
+          if (ref && facePairMayIntersect(ga.face, ga.face->getAABB(), gb.face,
+                                          gb.face->getAABB())) {
+            found[t].push_back(std::make_pair(ga.face, gb.face));
+          }
         }
       }
     }
   }
+
+  for (int t = 0; t < n_threads; ++t) {
+    for (size_t i = 0; i < found[t].size(); ++i) {
+      meshset_t::face_t* fa = found[t][i].first;
+      meshset_t::face_t* fb = found[t][i].second;
+      face_pairs[fa].push_back(fb);
+      face_pairs[fb].push_back(fa);
+    }
+  }
+  return true;
 }
 
 void carve::csg::CSG::generateIntersections(meshset_t* a,
@@ -979,7 +1343,12 @@ void carve::csg::CSG::generateIntersections(meshset_t* a,
                                             const face_rtree_t* b_rtree,
                                             detail::Data& data) {
   face_pairs_t face_pairs;
-  generateIntersectionCandidates(a, a_rtree, b, b_rtree, face_pairs);
+  if (broadphase != BROADPHASE_GRID ||
+      !generateGridIntersectionCandidates(a, b, face_pairs)) {
+    carve::geom::aabb_packet<3> b_boxes;
+    generateIntersectionCandidates(a, a_rtree, b, b_rtree, face_pairs,
+                                   b_boxes);
+  }
 
   for (face_pairs_t::const_iterator i = face_pairs.begin();
        i != face_pairs.end(); ++i) {
@@ -1021,6 +1390,10 @@ void carve::csg::CSG::generateIntersections(meshset_t* a,
 #endif
   makeVertexIntersections();
 
+  if (weld_intersections) {
+    groupIntersections();
+  }
+
 #if defined(CARVE_DEBUG)
   std::cerr << "  intersections.size() " << intersections.size() << std::endl;
   map_histogram(std::cerr, intersections);
@@ -1055,7 +1428,12 @@ void carve::csg::CSG::generateIntersections(meshset_t* a,
   static_cast<Intersections::super>(intersections).clear();
 }
 
-carve::csg::CSG::CSG() {}
+carve::csg::CSG::CSG()
+    : broadphase(BROADPHASE_RTREE),
+      predicate_mode(carve::predicate_mode),
+      weld_intersections(false),
+      implicit_intersections(false),
+      triangulate_face_loops(false) {}
 
 /**
  * \brief For each intersected edge, decompose into a set of vertex pairs
@@ -1074,6 +1452,12 @@ void carve::csg::CSG::divideIntersectedEdges(detail::Data& data) {
     meshset_t::edge_t* edge = (*i).first;
     const detail::EIntMap::mapped_type& int_info = (*i).second;
     std::vector<meshset_t::vertex_t*>& verts = data.divided_edges[edge];
+    if (implicit_intersections && int_info.size() > 1 &&
+        orderImplicitEdgeIntersectionVertices(
+            int_info.begin(), int_info.end(), edge->v1()->v, edge->v2()->v,
+            implicit_vertices, verts)) {
+      continue;
+    }
     orderEdgeIntersectionVertices(int_info.begin(), int_info.end(),
                                   edge->v2()->v - edge->v1()->v, edge->v1()->v,
                                   verts);
@@ -1486,6 +1870,7 @@ carve::mesh::MeshSet<3>* carve::csg::CSG::compute(
     carve::csg::V2Set* shared_edges_ptr, CLASSIFY_TYPE classify_type) {
   static carve::TimingName FUNC_NAME("CSG::compute");
   carve::TimingBlock block(FUNC_NAME);
+  carve::PredicateModeScope predicates(predicate_mode);
 
   VertexClassification vclass;
   EdgeClassification eclass;
@@ -1648,6 +2033,8 @@ bool carve::csg::CSG::sliceAndClassify(
   if (!closed->isClosed()) {
     return false;
   }
+  carve::PredicateModeScope predicates(predicate_mode);
+
   carve::csg::VertexClassification vclass;
   carve::csg::EdgeClassification eclass;
 
@@ -1712,6 +2099,8 @@ void carve::csg::CSG::slice(meshset_t* a, meshset_t* b,
                             std::list<meshset_t*>& a_sliced,
                             std::list<meshset_t*>& b_sliced,
                             carve::csg::V2Set* shared_edges_ptr) {
+  carve::PredicateModeScope predicates(predicate_mode);
+
   carve::csg::VertexClassification vclass;
   carve::csg::EdgeClassification eclass;
 
@@ -1779,5 +2168,6 @@ void carve::csg::CSG::slice(meshset_t* a, meshset_t* b,
 void carve::csg::CSG::init() {
   intersections.clear();
   vertex_intersections.clear();
+  implicit_vertices.clear();
   vertex_pool.reset();
 }
@@ -756,9 +756,7 @@ static void mergeFacesAndHoles(
       if (face_hole_loops.size()) {
 
         f_loops.push_back(carve::triangulate::incorporateHolesIntoPolygon(
-          carve::mesh::MeshSet<3>::face_t::projection_mapping(face->project),
-          face_loops[i],
-          face_hole_loops));
+            face->projector(), face_loops[i], face_hole_loops));
       } else {
         f_loops.push_back(face_loops[i]);
       }
@@ -1009,8 +1007,7 @@ bool processCrossingEdges(
         // signed area.
         double area = carve::geom2d::signedArea(
             endpoint_indices[i].path->begin() + 1,
-            endpoint_indices[i].path->end(),
-            carve::mesh::MeshSet<3>::face_t::projection_mapping(face->project));
+            endpoint_indices[i].path->end(), face->projector());
         if (area < 0) {
           // XXX: Create test case to check that this is the correct sign for
           // the area.
@@ -1088,8 +1085,7 @@ bool processCrossingEdges(
       order.reserve(j - i);
       for (size_t k = i; k < j; ++k) {
         double area = carve::geom2d::signedArea(
-            cross[k].path->begin(), cross[k].path->end(),
-            carve::mesh::MeshSet<3>::face_t::projection_mapping(face->project));
+            cross[k].path->begin(), cross[k].path->end(), face->projector());
 #if defined(CARVE_DEBUG)
         std::cerr << "### k=" << k << " area=" << area << std::endl;
 #endif
@@ -1726,6 +1722,40 @@ void generateOneFaceLoop(
     mergeFacesAndHoles(face, face_loops, hole_loops, hooks);
   }
 }
+
+// Replace each loop produced for a (triangular) face with a
+// triangulation of it. The split edges are loop boundaries, so the
+// result is a triangulation of the face constrained to them, and the
+// added vertices on the face perimeter are kept, so neighbouring
+// faces still meet edge to edge.
+void triangulateFaceLoops(
+    carve::mesh::MeshSet<3>::face_t* face,
+    std::list<std::vector<carve::mesh::MeshSet<3>::vertex_t*> >& face_loops) {
+  typedef std::list<std::vector<carve::mesh::MeshSet<3>::vertex_t*> >
+      loop_list_t;
+
+  static thread_local carve::triangulate::Triangulator triangulator;
+  std::vector<carve::triangulate::tri_idx> result;
+
+  for (loop_list_t::iterator i = face_loops.begin(); i != face_loops.end();) {
+    const std::vector<carve::mesh::MeshSet<3>::vertex_t*>& loop = *i;
+    if (loop.size() == 3) {
+      ++i;
+      continue;
+    }
+
+    triangulator.triangulate(face->projector(), loop, result);
+
+    for (size_t j = 0; j < result.size(); ++j) {
+      loop_list_t::iterator t = face_loops.insert(
+          i, std::vector<carve::mesh::MeshSet<3>::vertex_t*>(3));
+      (*t)[0] = loop[result[j].a];
+      (*t)[1] = loop[result[j].b];
+      (*t)[2] = loop[result[j].c];
+    }
+    i = face_loops.erase(i);
+  }
+}
 }  // namespace
 
 /**
@@ -1772,6 +1802,10 @@ size_t carve::csg::CSG::generateFaceLoops(carve::mesh::MeshSet<3>* poly,
 
     generateOneFaceLoop(face, data, vertex_intersections, hooks, face_loops);
 
+    if (triangulate_face_loops && face->nVertices() == 3) {
+      triangulateFaceLoops(face, face_loops);
+    }
+
 #if defined(CARVE_DEBUG)
     {
       V2Set face_edges;
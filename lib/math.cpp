@@ -34,6 +34,12 @@
 
 #include <stdio.h>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define M_2PI_3 2.0943951023931953
 #define M_SQRT_3_4 0.8660254037844386
 #define EPS std::numeric_limits<double>::epsilon()
@@ -380,5 +386,78 @@ void eigSolve(const Matrix3& m, double& l1, double& l2, double& l3) {
   }
   std::cerr << std::endl;
 }
+
+void transformPoints(const Matrix& A, double* xyz, size_t n, size_t stride) {
+  const int N = (int)n;
+  // the operation order matches operator*(Matrix, vector<3>), so that
+  // results are identical.
+#if defined(__AVX__)
+  // one point per iteration, with the x, y and z results in lanes
+  // 0-2. Columns are loaded as (_11, _12, _13, _14) etc.
+  const __m256d c0 = _mm256_loadu_pd(A.m[0]);
+  const __m256d c1 = _mm256_loadu_pd(A.m[1]);
+  const __m256d c2 = _mm256_loadu_pd(A.m[2]);
+  const __m256d c3 = _mm256_loadu_pd(A.m[3]);
+  const __m256i mask = _mm256_set_epi64x(0, -1, -1, -1);
+#pragma omp parallel for if (N > 10000)
+  for (int i = 0; i < N; ++i) {
+    double* p = xyz + i * stride;
+    __m256d r = _mm256_mul_pd(c0, _mm256_broadcast_sd(p));
+    r = _mm256_add_pd(r, _mm256_mul_pd(c1, _mm256_broadcast_sd(p + 1)));
+    r = _mm256_add_pd(r, _mm256_mul_pd(c2, _mm256_broadcast_sd(p + 2)));
+    r = _mm256_add_pd(r, c3);
+    _mm256_maskstore_pd(p, mask, r);
+  }
+#elif defined(__SSE2__)
+  const __m128d c0 = _mm_loadu_pd(A.m[0]), z0 = _mm_load_sd(A.m[0] + 2);
+  const __m128d c1 = _mm_loadu_pd(A.m[1]), z1 = _mm_load_sd(A.m[1] + 2);
+  const __m128d c2 = _mm_loadu_pd(A.m[2]), z2 = _mm_load_sd(A.m[2] + 2);
+  const __m128d c3 = _mm_loadu_pd(A.m[3]), z3 = _mm_load_sd(A.m[3] + 2);
+#pragma omp parallel for if (N > 10000)
+  for (int i = 0; i < N; ++i) {
+    double* p = xyz + i * stride;
+    const __m128d x = _mm_set1_pd(p[0]);
+    const __m128d y = _mm_set1_pd(p[1]);
+    const __m128d z = _mm_set1_pd(p[2]);
+    __m128d r = _mm_mul_pd(c0, x);
+    __m128d s = _mm_mul_sd(z0, x);
+    r = _mm_add_pd(r, _mm_mul_pd(c1, y));
+    s = _mm_add_sd(s, _mm_mul_sd(z1, y));
+    r = _mm_add_pd(r, _mm_mul_pd(c2, z));
+    s = _mm_add_sd(s, _mm_mul_sd(z2, z));
+    r = _mm_add_pd(r, c3);
+    s = _mm_add_sd(s, z3);
+    _mm_storeu_pd(p, r);
+    _mm_store_sd(p + 2, s);
+  }
+#else
+#pragma omp parallel for if (N > 10000)
+  for (int i = 0; i < N; ++i) {
+    double* p = xyz + i * stride;
+    const double x = p[0], y = p[1], z = p[2];
+    p[0] = A._11 * x + A._21 * y + A._31 * z + A._41;
+    p[1] = A._12 * x + A._22 * y + A._32 * z + A._42;
+    p[2] = A._13 * x + A._23 * y + A._33 * z + A._43;
+  }
+#endif
+}
+
+bool isRigid(const Matrix& A) {
+  // columns of the upper 3x3 block must be orthonormal.
+  const double tol = 1e-12;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = i; j < 3; ++j) {
+      double d = A.m[i][0] * A.m[j][0] + A.m[i][1] * A.m[j][1] +
+                 A.m[i][2] * A.m[j][2];
+      if (fabs(d - (i == j ? 1.0 : 0.0)) > tol) {
+        return false;
+      }
+    }
+  }
+  double det = A._11 * (A._22 * A._33 - A._23 * A._32) -
+               A._21 * (A._12 * A._33 - A._13 * A._32) +
+               A._31 * (A._12 * A._23 - A._13 * A._22);
+  return det > 0.0;
+}
 }  // namespace math
 }  // namespace carve
@@ -32,107 +32,9 @@
 
 #include <carve/poly.hpp>
 
-namespace {
-inline double CALC_X(const carve::geom::plane<3>& p, double y, double z) {
-  return -(p.d + p.N.y * y + p.N.z * z) / p.N.x;
-}
-inline double CALC_Y(const carve::geom::plane<3>& p, double x, double z) {
-  return -(p.d + p.N.x * x + p.N.z * z) / p.N.y;
-}
-inline double CALC_Z(const carve::geom::plane<3>& p, double x, double y) {
-  return -(p.d + p.N.x * x + p.N.y * y) / p.N.z;
-}
-
-carve::geom::vector<2> _project_1(const carve::geom::vector<3>& v) {
-  return carve::geom::VECTOR(v.z, v.y);
-}
-
-carve::geom::vector<2> _project_2(const carve::geom::vector<3>& v) {
-  return carve::geom::VECTOR(v.x, v.z);
-}
-
-carve::geom::vector<2> _project_3(const carve::geom::vector<3>& v) {
-  return carve::geom::VECTOR(v.y, v.x);
-}
-
-carve::geom::vector<2> _project_4(const carve::geom::vector<3>& v) {
-  return carve::geom::VECTOR(v.y, v.z);
-}
-
-carve::geom::vector<2> _project_5(const carve::geom::vector<3>& v) {
-  return carve::geom::VECTOR(v.z, v.x);
-}
-
-carve::geom::vector<2> _project_6(const carve::geom::vector<3>& v) {
-  return carve::geom::VECTOR(v.x, v.y);
-}
-
-carve::geom::vector<3> _unproject_1(const carve::geom::vector<2>& p,
-                                    const carve::geom3d::Plane& plane) {
-  return carve::geom::VECTOR(CALC_X(plane, p.y, p.x), p.y, p.x);
-}
-
-carve::geom::vector<3> _unproject_2(const carve::geom::vector<2>& p,
-                                    const carve::geom3d::Plane& plane) {
-  return carve::geom::VECTOR(p.x, CALC_Y(plane, p.x, p.y), p.y);
-}
-
-carve::geom::vector<3> _unproject_3(const carve::geom::vector<2>& p,
-                                    const carve::geom3d::Plane& plane) {
-  return carve::geom::VECTOR(p.y, p.x, CALC_Z(plane, p.y, p.x));
-}
-
-carve::geom::vector<3> _unproject_4(const carve::geom::vector<2>& p,
-                                    const carve::geom3d::Plane& plane) {
-  return carve::geom::VECTOR(CALC_X(plane, p.x, p.y), p.x, p.y);
-}
-
-carve::geom::vector<3> _unproject_5(const carve::geom::vector<2>& p,
-                                    const carve::geom3d::Plane& plane) {
-  return carve::geom::VECTOR(p.y, CALC_Y(plane, p.y, p.x), p.x);
-}
-
-carve::geom::vector<3> _unproject_6(const carve::geom::vector<2>& p,
-                                    const carve::geom3d::Plane& plane) {
-  return carve::geom::VECTOR(p.x, p.y, CALC_Z(plane, p.x, p.y));
-}
-
-static carve::geom::vector<2> (*project_tab[2][3])(
-    const carve::geom::vector<3>&) = {{&_project_1, &_project_2, &_project_3},
-                                      {&_project_4, &_project_5, &_project_6}};
-
-static carve::geom::vector<3> (*unproject_tab[2][3])(
-    const carve::geom::vector<2>&, const carve::geom3d::Plane&) = {
-    {&_unproject_1, &_unproject_2, &_unproject_3},
-    {&_unproject_4, &_unproject_5, &_unproject_6}};
-}  // namespace
-
 namespace carve {
 namespace mesh {
 
-template <unsigned ndim>
-typename Face<ndim>::project_t Face<ndim>::getProjector(bool positive_facing,
-                                                        int axis) const {
-  return NULL;
-}
-
-template <>
-Face<3>::project_t Face<3>::getProjector(bool positive_facing, int axis) const {
-  return project_tab[positive_facing ? 1 : 0][axis];
-}
-
-template <unsigned ndim>
-typename Face<ndim>::unproject_t Face<ndim>::getUnprojector(
-    bool positive_facing, int axis) const {
-  return NULL;
-}
-
-template <>
-Face<3>::unproject_t Face<3>::getUnprojector(bool positive_facing,
-                                             int axis) const {
-  return unproject_tab[positive_facing ? 1 : 0][axis];
-}
-
 template <unsigned ndim>
 bool Face<ndim>::containsPoint(const vector_t& p) const {
   if (!carve::math::ZERO(carve::geom::distance(plane, p))) {
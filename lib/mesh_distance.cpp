@@ -0,0 +1,456 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/mesh_distance.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+
+namespace {
+typedef carve::mesh::face_rtree_t face_rtree_t;
+typedef carve::mesh::Face<3> face_t;
+typedef carve::mesh::Edge<3> edge_t;
+typedef carve::geom::vector<3> vector_t;
+
+typedef std::pair<double, const face_rtree_t*> node_dist_t;
+typedef std::priority_queue<node_dist_t, std::vector<node_dist_t>,
+                            std::greater<node_dist_t> >
+    node_queue_t;
+
+struct node_pair_dist_t {
+  double dist2;
+  const face_rtree_t* a;
+  const face_rtree_t* b;
+
+  node_pair_dist_t(double _dist2, const face_rtree_t* _a,
+                   const face_rtree_t* _b)
+      : dist2(_dist2), a(_a), b(_b) {}
+
+  bool operator>(const node_pair_dist_t& other) const {
+    return dist2 > other.dist2;
+  }
+};
+
+typedef std::priority_queue<node_pair_dist_t, std::vector<node_pair_dist_t>,
+                            std::greater<node_pair_dist_t> >
+    node_pair_queue_t;
+
+double sqr(double d) {
+  return d * d;
+}
+
+// Test whether the edge e passes through the interior of face f, in
+// which case the edge and face are at distance zero.
+bool edgeCrossesFace(const edge_t* e, const face_t* f, vector_t& x) {
+  const vector_t& p = e->v1()->v;
+  const vector_t& q = e->v2()->v;
+  double dp = carve::geom::distance(f->plane, p);
+  double dq = carve::geom::distance(f->plane, q);
+  if ((dp < 0.0 && dq > 0.0) || (dp > 0.0 && dq < 0.0)) {
+    x = p + (q - p) * (dp / (dp - dq));
+    return f->containsPointInProjection(x);
+  }
+  return false;
+}
+
+// Build a face rtree for meshset. Returns false if meshset has no
+// faces.
+bool buildFaceRTree(const carve::mesh::MeshSet<3>* meshset,
+                    std::unique_ptr<face_rtree_t>& rtree) {
+  std::vector<face_t*> faces;
+  for (carve::mesh::MeshSet<3>::const_face_iter i = meshset->faceBegin();
+       i != meshset->faceEnd(); ++i) {
+    faces.push_back(const_cast<face_t*>(*i));
+  }
+  if (faces.empty()) {
+    return false;
+  }
+  rtree.reset(face_rtree_t::construct_STR(faces.begin(), faces.end(), 4, 4));
+  return true;
+}
+
+bool _minimumDistance(const face_rtree_t* a_rtree, const face_rtree_t* b_rtree,
+                      carve::mesh::MeshProximity& result, double max_dist2,
+                      bool first_only) {
+  bool found = false;
+  double best = max_dist2;
+
+  node_pair_queue_t queue;
+  queue.push(node_pair_dist_t(
+      carve::geom::distance2(a_rtree->bbox, b_rtree->bbox), a_rtree, b_rtree));
+
+  while (!queue.empty()) {
+    node_pair_dist_t curr = queue.top();
+    queue.pop();
+
+    if (curr.dist2 > best) {
+      break;
+    }
+
+    const face_rtree_t* a = curr.a;
+    const face_rtree_t* b = curr.b;
+
+    if (a->child == nullptr && b->child == nullptr) {
+      for (size_t i = 0; i < a->data.size(); ++i) {
+        const face_t* fa = a->data[i];
+        carve::geom::aabb<3> fa_aabb = fa->getAABB();
+        if (carve::geom::distance2(fa_aabb, b->bbox) > best) {
+          continue;
+        }
+        for (size_t j = 0; j < b->data.size(); ++j) {
+          const face_t* fb = b->data[j];
+          if (carve::geom::distance2(fa_aabb, fb->getAABB()) > best) {
+            continue;
+          }
+          vector_t pa, pb;
+          double d2 = carve::mesh::faceDistance2(fa, fb, pa, pb);
+          if (d2 < best || (!found && d2 <= best)) {
+            found = true;
+            best = d2;
+            result.face_a = fa;
+            result.face_b = fb;
+            result.point_a = pa;
+            result.point_b = pb;
+            result.distance2 = d2;
+            if (first_only || d2 == 0.0) {
+              return true;
+            }
+          }
+        }
+      }
+      continue;
+    }
+
+    // descend into the node with children; if both have children,
+    // descend into the larger one.
+    bool descend_a;
+    if (a->child == nullptr) {
+      descend_a = false;
+    } else if (b->child == nullptr) {
+      descend_a = true;
+    } else {
+      descend_a = a->bbox.extent.length2() >= b->bbox.extent.length2();
+    }
+
+    if (descend_a) {
+      for (const face_rtree_t* node = a->child; node; node = node->sibling) {
+        double d2 = carve::geom::distance2(node->bbox, b->bbox);
+        if (d2 <= best) {
+          queue.push(node_pair_dist_t(d2, node, b));
+        }
+      }
+    } else {
+      for (const face_rtree_t* node = b->child; node; node = node->sibling) {
+        double d2 = carve::geom::distance2(a->bbox, node->bbox);
+        if (d2 <= best) {
+          queue.push(node_pair_dist_t(d2, a, node));
+        }
+      }
+    }
+  }
+
+  return found;
+}
+}  // namespace
+
+namespace carve {
+namespace mesh {
+
+double FaceProximity::distance() const {
+  return sqrt(distance2);
+}
+
+double MeshProximity::distance() const {
+  return sqrt(distance2);
+}
+
+carve::geom::vector<3> closestPoint(const Face<3>* face,
+                                    const carve::geom::vector<3>& p) {
+  const edge_t* e = face->edge;
+
+  if (face->n_edges == 3) {
+    return carve::geom::closestPoint(
+        carve::geom::tri<3>(e->vert->v, e->next->vert->v, e->prev->vert->v),
+        p);
+  }
+
+  vector_t q = carve::geom::closestPoint(face->plane, p);
+  if (face->containsPointInProjection(q)) {
+    return q;
+  }
+
+  double best = std::numeric_limits<double>::infinity();
+  do {
+    vector_t c = carve::geom::closestPoint(
+        carve::geom::linesegment<3>(e->v1()->v, e->v2()->v), p);
+    double d2 = carve::geom::distance2(c, p);
+    if (d2 < best) {
+      best = d2;
+      q = c;
+    }
+    e = e->next;
+  } while (e != face->edge);
+
+  return q;
+}
+
+double faceDistance2(const Face<3>* fa, const Face<3>* fb,
+                     carve::geom::vector<3>& pa, carve::geom::vector<3>& pb) {
+  vector_t x;
+
+  // an edge of one face passing through the other.
+  const edge_t* ea = fa->edge;
+  do {
+    if (edgeCrossesFace(ea, fb, x)) {
+      pa = pb = x;
+      return 0.0;
+    }
+    ea = ea->next;
+  } while (ea != fa->edge);
+
+  const edge_t* eb = fb->edge;
+  do {
+    if (edgeCrossesFace(eb, fa, x)) {
+      pa = pb = x;
+      return 0.0;
+    }
+    eb = eb->next;
+  } while (eb != fb->edge);
+
+  double best = std::numeric_limits<double>::infinity();
+
+  // vertex-face pairs.
+  ea = fa->edge;
+  do {
+    x = closestPoint(fb, ea->vert->v);
+    double d2 = carve::geom::distance2(ea->vert->v, x);
+    if (d2 < best) {
+      best = d2;
+      pa = ea->vert->v;
+      pb = x;
+    }
+    ea = ea->next;
+  } while (ea != fa->edge);
+
+  eb = fb->edge;
+  do {
+    x = closestPoint(fa, eb->vert->v);
+    double d2 = carve::geom::distance2(eb->vert->v, x);
+    if (d2 < best) {
+      best = d2;
+      pa = x;
+      pb = eb->vert->v;
+    }
+    eb = eb->next;
+  } while (eb != fb->edge);
+
+  // edge-edge pairs.
+  ea = fa->edge;
+  do {
+    carve::geom::linesegment<3> la(ea->v1()->v, ea->v2()->v);
+    eb = fb->edge;
+    do {
+      vector_t ca, cb;
+      double d2 = carve::geom::closestPoints(
+          la, carve::geom::linesegment<3>(eb->v1()->v, eb->v2()->v), ca, cb);
+      if (d2 < best) {
+        best = d2;
+        pa = ca;
+        pb = cb;
+      }
+      eb = eb->next;
+    } while (eb != fb->edge);
+    ea = ea->next;
+  } while (ea != fa->edge);
+
+  return best;
+}
+
+bool closestPoint(const face_rtree_t* face_rtree,
+                  const carve::geom::vector<3>& p, FaceProximity& result,
+                  double max_distance) {
+  bool found = false;
+  double best = sqr(max_distance);
+
+  node_queue_t queue;
+  queue.push(
+      node_dist_t(carve::geom::distance2(face_rtree->bbox, p), face_rtree));
+
+  while (!queue.empty()) {
+    node_dist_t curr = queue.top();
+    queue.pop();
+
+    if (curr.first > best) {
+      break;
+    }
+
+    const face_rtree_t* node = curr.second;
+    if (node->child) {
+      for (const face_rtree_t* c = node->child; c; c = c->sibling) {
+        double d2 = carve::geom::distance2(c->bbox, p);
+        if (d2 <= best) {
+          queue.push(node_dist_t(d2, c));
+        }
+      }
+      continue;
+    }
+
+    for (size_t i = 0; i < node->data.size(); ++i) {
+      const face_t* face = node->data[i];
+      if (carve::geom::distance2(face->getAABB(), p) > best) {
+        continue;
+      }
+      vector_t q = closestPoint(face, p);
+      double d2 = carve::geom::distance2(q, p);
+      if (d2 < best || (!found && d2 <= best)) {
+        found = true;
+        best = d2;
+        result = FaceProximity(face, q, d2);
+      }
+    }
+  }
+
+  return found;
+}
+
+void nearestFaces(const face_rtree_t* face_rtree,
+                  const carve::geom::vector<3>& p, size_t k,
+                  std::vector<FaceProximity>& result, double max_distance) {
+  result.clear();
+  if (k == 0) {
+    return;
+  }
+
+  const double max_dist2 = sqr(max_distance);
+
+  // a max-heap of the best k faces found so far.
+  std::priority_queue<FaceProximity> best;
+
+  node_queue_t queue;
+  queue.push(
+      node_dist_t(carve::geom::distance2(face_rtree->bbox, p), face_rtree));
+
+  while (!queue.empty()) {
+    node_dist_t curr = queue.top();
+    queue.pop();
+
+    double bound = best.size() == k ? best.top().distance2 : max_dist2;
+    if (curr.first > bound) {
+      break;
+    }
+
+    const face_rtree_t* node = curr.second;
+    if (node->child) {
+      for (const face_rtree_t* c = node->child; c; c = c->sibling) {
+        double d2 = carve::geom::distance2(c->bbox, p);
+        if (d2 <= bound) {
+          queue.push(node_dist_t(d2, c));
+        }
+      }
+      continue;
+    }
+
+    for (size_t i = 0; i < node->data.size(); ++i) {
+      const face_t* face = node->data[i];
+      if (carve::geom::distance2(face->getAABB(), p) > bound) {
+        continue;
+      }
+      vector_t q = closestPoint(face, p);
+      double d2 = carve::geom::distance2(q, p);
+      if (d2 > bound) {
+        continue;
+      }
+      if (best.size() == k) {
+        if (d2 >= best.top().distance2) {
+          continue;
+        }
+        best.pop();
+      }
+      best.push(FaceProximity(face, q, d2));
+      bound = best.size() == k ? best.top().distance2 : max_dist2;
+    }
+  }
+
+  result.reserve(best.size());
+  while (!best.empty()) {
+    result.push_back(best.top());
+    best.pop();
+  }
+  std::reverse(result.begin(), result.end());
+}
+
+bool minimumDistance(const face_rtree_t* a_rtree, const face_rtree_t* b_rtree,
+                     MeshProximity& result, double max_distance) {
+  return _minimumDistance(a_rtree, b_rtree, result, sqr(max_distance), false);
+}
+
+bool withinDistance(const face_rtree_t* a_rtree, const face_rtree_t* b_rtree,
+                    double d) {
+  MeshProximity result;
+  return _minimumDistance(a_rtree, b_rtree, result, sqr(d), true);
+}
+
+bool closestPoint(const MeshSet<3>* meshset, const carve::geom::vector<3>& p,
+                  FaceProximity& result) {
+  std::unique_ptr<face_rtree_t> rtree;
+  if (!buildFaceRTree(meshset, rtree)) {
+    return false;
+  }
+  return closestPoint(rtree.get(), p, result);
+}
+
+void nearestFaces(const MeshSet<3>* meshset, const carve::geom::vector<3>& p,
+                  size_t k, std::vector<FaceProximity>& result) {
+  std::unique_ptr<face_rtree_t> rtree;
+  if (!buildFaceRTree(meshset, rtree)) {
+    result.clear();
+    return;
+  }
+  nearestFaces(rtree.get(), p, k, result);
+}
+
+bool minimumDistance(const MeshSet<3>* a, const MeshSet<3>* b,
+                     MeshProximity& result) {
+  std::unique_ptr<face_rtree_t> a_rtree, b_rtree;
+  if (!buildFaceRTree(a, a_rtree) || !buildFaceRTree(b, b_rtree)) {
+    return false;
+  }
+  return minimumDistance(a_rtree.get(), b_rtree.get(), result);
+}
+
+bool withinDistance(const MeshSet<3>* a, const MeshSet<3>* b, double d) {
+  std::unique_ptr<face_rtree_t> a_rtree, b_rtree;
+  if (!buildFaceRTree(a, a_rtree) || !buildFaceRTree(b, b_rtree)) {
+    return false;
+  }
+  return withinDistance(a_rtree.get(), b_rtree.get(), d);
+}
+}  // namespace mesh
+}  // namespace carve
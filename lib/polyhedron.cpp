@@ -35,11 +35,11 @@
 #include <carve/geom.hpp>
 #include <carve/poly.hpp>
 
-#include <carve/octree_impl.hpp>
 
 #include <carve/timing.hpp>
 
 #include <algorithm>
+#include <iterator>
 
 #include <carve/mesh.hpp>
 #include <random>
@@ -91,10 +91,19 @@ bool Polyhedron::initSpatialIndex() {
   static carve::TimingName FUNC_NAME("Polyhedron::initSpatialIndex()");
   carve::TimingBlock block(FUNC_NAME);
 
-  octree.setBounds(aabb);
-  octree.addFaces(faces);
-  octree.addEdges(edges);
-  octree.splitTree();
+  std::vector<const face_t*> face_ptrs;
+  face_ptrs.reserve(faces.size());
+  for (size_t i = 0; i < faces.size(); ++i) {
+    face_ptrs.push_back(&faces[i]);
+  }
+  face_octree.build(face_ptrs.begin(), face_ptrs.end());
+
+  std::vector<const edge_t*> edge_ptrs;
+  edge_ptrs.reserve(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    edge_ptrs.push_back(&edges[i]);
+  }
+  edge_octree.build(edge_ptrs.begin(), edge_ptrs.end());
 
   return true;
 }
@@ -738,7 +747,7 @@ void Polyhedron::testVertexAgainstClosedManifolds(
 
     possible_faces.clear();
     manifold_intersections.clear();
-    octree.findFacesNear(line, possible_faces);
+    face_octree.search(line, std::back_inserter(possible_faces));
 
     for (unsigned i = 0; !failed && i < possible_faces.size(); i++) {
       if (!manifold_is_closed[possible_faces[i]->manifold_id]) {
@@ -867,7 +876,7 @@ PointClass Polyhedron::containsVertex(const carve::geom3d::Vector& v,
 
     possible_faces.clear();
     manifold_intersections.clear();
-    octree.findFacesNear(line, possible_faces);
+    face_octree.search(line, std::back_inserter(possible_faces));
 
     for (unsigned i = 0; !failed && i < possible_faces.size(); i++) {
       if (manifold_id != -1 && manifold_id != faces[i].manifold_id) {
@@ -986,49 +995,51 @@ PointClass Polyhedron::containsVertex(const carve::geom3d::Vector& v,
 void Polyhedron::findEdgesNear(const carve::geom::aabb<3>& aabb,
                                std::vector<const edge_t*>& outEdges) const {
   outEdges.clear();
-  octree.findEdgesNear(aabb, outEdges);
+  edge_octree.search(aabb, std::back_inserter(outEdges));
 }
 
 void Polyhedron::findEdgesNear(const carve::geom3d::LineSegment& line,
                                std::vector<const edge_t*>& outEdges) const {
   outEdges.clear();
-  octree.findEdgesNear(line, outEdges);
+  edge_octree.search(line, std::back_inserter(outEdges));
 }
 
 void Polyhedron::findEdgesNear(const carve::geom3d::Vector& v,
                                std::vector<const edge_t*>& outEdges) const {
   outEdges.clear();
-  octree.findEdgesNear(v, outEdges);
+  edge_octree.search(v, std::back_inserter(outEdges));
 }
 
 void Polyhedron::findEdgesNear(const face_t& face,
                                std::vector<const edge_t*>& edges) const {
   edges.clear();
-  octree.findEdgesNear(face, edges);
+  edge_octree.search(face.aabb, std::back_inserter(edges));
 }
 
 void Polyhedron::findEdgesNear(const edge_t& edge,
                                std::vector<const edge_t*>& outEdges) const {
   outEdges.clear();
-  octree.findEdgesNear(edge, outEdges);
+  edge_octree.search(carve::geom3d::LineSegment(edge.v1->v, edge.v2->v),
+                     std::back_inserter(outEdges));
 }
 
 void Polyhedron::findFacesNear(const carve::geom3d::LineSegment& line,
                                std::vector<const face_t*>& outFaces) const {
   outFaces.clear();
-  octree.findFacesNear(line, outFaces);
+  face_octree.search(line, std::back_inserter(outFaces));
 }
 
 void Polyhedron::findFacesNear(const carve::geom::aabb<3>& aabb,
                                std::vector<const face_t*>& outFaces) const {
   outFaces.clear();
-  octree.findFacesNear(aabb, outFaces);
+  face_octree.search(aabb, std::back_inserter(outFaces));
 }
 
 void Polyhedron::findFacesNear(const edge_t& edge,
                                std::vector<const face_t*>& outFaces) const {
   outFaces.clear();
-  octree.findFacesNear(edge, outFaces);
+  face_octree.search(carve::geom3d::LineSegment(edge.v1->v, edge.v2->v),
+                     std::back_inserter(outFaces));
 }
 
 void Polyhedron::transform(const carve::math::Matrix& xform) {
@@ -0,0 +1,103 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/predicates.hpp>
+
+namespace carve {
+
+namespace detail {
+
+size_t orient2d_batch_scalar(size_t n, const double* pa, size_t sa,
+                             const double* pb, size_t sb, const double* pc,
+                             size_t sc, double* out) {
+  size_t n_exact = 0;
+  for (size_t t = 0; t < n; ++t) {
+    const double *a = pa + t * sa, *b = pb + t * sb, *c = pc + t * sc;
+    double det, detsum;
+    if (!orient2d_filter(a, b, c, det, detsum)) {
+      det = shewchuk::orient2dadapt(a, b, c, detsum);
+      ++n_exact;
+    }
+    out[t] = det;
+  }
+  return n_exact;
+}
+
+size_t orient3d_batch_scalar(size_t n, const double* pa, size_t sa,
+                             const double* pb, size_t sb, const double* pc,
+                             size_t sc, const double* pd, size_t sd,
+                             double* out) {
+  size_t n_exact = 0;
+  for (size_t t = 0; t < n; ++t) {
+    const double *a = pa + t * sa, *b = pb + t * sb, *c = pc + t * sc,
+                 *d = pd + t * sd;
+    double det, permanent;
+    if (!orient3d_filter(a, b, c, d, det, permanent)) {
+      det = shewchuk::orient3dadapt(a, b, c, d, permanent);
+      ++n_exact;
+    }
+    out[t] = det;
+  }
+  return n_exact;
+}
+
+}  // namespace detail
+
+void orient2d_batch(size_t n, const double* pa, size_t sa, const double* pb,
+                    size_t sb, const double* pc, size_t sc, double* out) {
+  static const bool avx2 = detail::batch_avx2_supported();
+  const size_t n_exact =
+      avx2 ? detail::orient2d_batch_avx2(n, pa, sa, pb, sb, pc, sc, out)
+           : detail::orient2d_batch_scalar(n, pa, sa, pb, sb, pc, sc, out);
+
+  if (predicate_stats.enabled) {
+    predicate_stats.orient2d_calls.fetch_add(n, std::memory_order_relaxed);
+    predicate_stats.orient2d_exact.fetch_add(n_exact,
+                                             std::memory_order_relaxed);
+  }
+}
+
+void orient3d_batch(size_t n, const double* pa, size_t sa, const double* pb,
+                    size_t sb, const double* pc, size_t sc, const double* pd,
+                    size_t sd, double* out) {
+  static const bool avx2 = detail::batch_avx2_supported();
+  const size_t n_exact =
+      avx2 ? detail::orient3d_batch_avx2(n, pa, sa, pb, sb, pc, sc, pd, sd,
+                                         out)
+           : detail::orient3d_batch_scalar(n, pa, sa, pb, sb, pc, sc, pd, sd,
+                                           out);
+
+  if (predicate_stats.enabled) {
+    predicate_stats.orient3d_calls.fetch_add(n, std::memory_order_relaxed);
+    predicate_stats.orient3d_exact.fetch_add(n_exact,
+                                             std::memory_order_relaxed);
+  }
+}
+
+}  // namespace carve
@@ -0,0 +1,166 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// AVX2 kernels for orient2d_batch() and orient3d_batch(). This file
+// is compiled with -mavx2 when CARVE_WITH_AVX2 is on, and the kernels
+// are only called if the CPU supports AVX2. So that no AVX2 code can
+// leak into the rest of the library through a shared inline or
+// template instantiation, nothing here calls an inline function from
+// a header other than the simd:: filters.
+//
+// The vector filters evaluate the same floating point expressions as
+// detail::orient2d_filter() and detail::orient3d_filter(), so the same
+// error bounds apply, and the results match the scalar kernels.
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/predicates.hpp>
+
+#include "simd_predicates.hpp"
+
+namespace carve {
+namespace detail {
+
+#if defined(__AVX2__)
+
+namespace {
+inline size_t last_of(size_t i, size_t last) { return i < last ? i : last; }
+
+// coordinate k of tuples i..i+3, repeating the last tuple past n.
+inline __m256d load4(const double* p, size_t stride, size_t i, size_t n,
+                     unsigned k) {
+  if (stride == 0) {
+    return _mm256_broadcast_sd(p + k);
+  }
+  const size_t last = n - 1;
+  return _mm256_set_pd(p[last_of(i + 3, last) * stride + k],
+                       p[last_of(i + 2, last) * stride + k],
+                       p[last_of(i + 1, last) * stride + k],
+                       p[i * stride + k]);
+}
+
+using simd::abs4;
+}  // namespace
+
+bool batch_avx2_supported() {
+#if defined(__GNUC__)
+  return __builtin_cpu_supports("avx2");
+#else
+  return true;
+#endif
+}
+
+size_t orient2d_batch_avx2(size_t n, const double* pa, size_t sa,
+                           const double* pb, size_t sb, const double* pc,
+                           size_t sc, double* out) {
+  size_t n_exact = 0;
+  const __m256d bound = _mm256_set1_pd(ccw_errbound_a);
+  for (size_t i = 0; i < n; i += 4) {
+    const __m256d cx = load4(pc, sc, i, n, 0);
+    const __m256d cy = load4(pc, sc, i, n, 1);
+    const __m256d acx = _mm256_sub_pd(load4(pa, sa, i, n, 0), cx);
+    const __m256d acy = _mm256_sub_pd(load4(pa, sa, i, n, 1), cy);
+    const __m256d bcx = _mm256_sub_pd(load4(pb, sb, i, n, 0), cx);
+    const __m256d bcy = _mm256_sub_pd(load4(pb, sb, i, n, 1), cy);
+
+    const __m256d detleft = _mm256_mul_pd(acx, bcy);
+    const __m256d detright = _mm256_mul_pd(acy, bcx);
+    const __m256d det = _mm256_sub_pd(detleft, detright);
+    const __m256d detsum = _mm256_add_pd(abs4(detleft), abs4(detright));
+    const int decided = _mm256_movemask_pd(_mm256_cmp_pd(
+        abs4(det), _mm256_mul_pd(bound, detsum), _CMP_GE_OQ));
+
+    double r[4], s[4];
+    _mm256_storeu_pd(r, det);
+    _mm256_storeu_pd(s, detsum);
+    const size_t m = n - i < 4 ? n - i : 4;
+    for (size_t j = 0; j < m; ++j) {
+      const size_t t = i + j;
+      if (!(decided & (1 << j))) {
+        r[j] = shewchuk::orient2dadapt(pa + t * sa, pb + t * sb, pc + t * sc,
+                                       s[j]);
+        ++n_exact;
+      }
+      out[t] = r[j];
+    }
+  }
+  return n_exact;
+}
+
+size_t orient3d_batch_avx2(size_t n, const double* pa, size_t sa,
+                           const double* pb, size_t sb, const double* pc,
+                           size_t sc, const double* pd, size_t sd,
+                           double* out) {
+  size_t n_exact = 0;
+  for (size_t i = 0; i < n; i += 4) {
+    __m256d permanent;
+    const __m256d det = simd::orient3d4(
+        load4(pa, sa, i, n, 0), load4(pa, sa, i, n, 1), load4(pa, sa, i, n, 2),
+        load4(pb, sb, i, n, 0), load4(pb, sb, i, n, 1), load4(pb, sb, i, n, 2),
+        load4(pc, sc, i, n, 0), load4(pc, sc, i, n, 1), load4(pc, sc, i, n, 2),
+        load4(pd, sd, i, n, 0), load4(pd, sd, i, n, 1), load4(pd, sd, i, n, 2),
+        permanent);
+    const int decided = simd::orient3d4_decided(det, permanent);
+
+    double r[4], p[4];
+    _mm256_storeu_pd(r, det);
+    _mm256_storeu_pd(p, permanent);
+    const size_t m = n - i < 4 ? n - i : 4;
+    for (size_t j = 0; j < m; ++j) {
+      const size_t t = i + j;
+      if (!(decided & (1 << j))) {
+        r[j] = shewchuk::orient3dadapt(pa + t * sa, pb + t * sb, pc + t * sc,
+                                       pd + t * sd, p[j]);
+        ++n_exact;
+      }
+      out[t] = r[j];
+    }
+  }
+  return n_exact;
+}
+
+#else
+
+bool batch_avx2_supported() { return false; }
+
+size_t orient2d_batch_avx2(size_t n, const double* pa, size_t sa,
+                           const double* pb, size_t sb, const double* pc,
+                           size_t sc, double* out) {
+  return orient2d_batch_scalar(n, pa, sa, pb, sb, pc, sc, out);
+}
+
+size_t orient3d_batch_avx2(size_t n, const double* pa, size_t sa,
+                           const double* pb, size_t sb, const double* pc,
+                           size_t sc, const double* pd, size_t sd,
+                           double* out) {
+  return orient3d_batch_scalar(n, pa, sa, pb, sb, pc, sc, pd, sd, out);
+}
+
+#endif
+
+}  // namespace detail
+}  // namespace carve
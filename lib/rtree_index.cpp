@@ -0,0 +1,321 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/rtree_index.hpp>
+
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+#include <string.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace carve {
+namespace mesh {
+
+namespace {
+const char MAGIC[8] = {'C', 'A', 'R', 'V', 'E', 'R', 'T', 'I'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+inline void fnv1a(uint64_t& h, const void* data, size_t len) {
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < len; ++i) {
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+}
+}  // namespace
+
+FaceRTreeIndex::FaceRTreeIndex()
+    : base(nullptr),
+      size(0),
+      mapped(false),
+      buffer(),
+      header(nullptr),
+      nodes(nullptr),
+      refs(nullptr),
+      faces() {}
+
+FaceRTreeIndex::~FaceRTreeIndex() {
+  close();
+}
+
+uint64_t FaceRTreeIndex::meshHash(const MeshSet<3>* mesh) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (MeshSet<3>::const_face_iter i = mesh->faceBegin(); i != mesh->faceEnd();
+       ++i) {
+    const Face<3>* face = *i;
+    uint64_t n = face->n_edges;
+    fnv1a(h, &n, sizeof(n));
+    const Edge<3>* e = face->edge;
+    do {
+      fnv1a(h, e->vert->v.v, sizeof(e->vert->v.v));
+      e = e->next;
+    } while (e != face->edge);
+  }
+  return h;
+}
+
+bool FaceRTreeIndex::write(const std::string& filename, const MeshSet<3>* mesh,
+                           const face_rtree_t* tree) {
+  if (tree == nullptr) {
+    return false;
+  }
+
+  std::unordered_map<const Face<3>*, uint32_t> face_idx;
+  uint32_t n_faces = 0;
+  for (MeshSet<3>::const_face_iter i = mesh->faceBegin(); i != mesh->faceEnd();
+       ++i) {
+    face_idx[*i] = n_faces++;
+  }
+
+  std::vector<const face_rtree_t*> order;
+  std::vector<node_t> out_nodes;
+  std::vector<uint32_t> out_refs;
+
+  order.push_back(tree);
+  for (size_t i = 0; i < order.size(); ++i) {
+    const face_rtree_t* n = order[i];
+    node_t out;
+    memset(&out, 0, sizeof(out));
+    for (unsigned j = 0; j < 3; ++j) {
+      out.pos[j] = n->bbox.pos.v[j];
+      out.extent[j] = n->bbox.extent.v[j];
+    }
+    if (n->child) {
+      out.is_leaf = 0;
+      out.first = (uint32_t)order.size();
+      for (const face_rtree_t* c = n->child; c; c = c->sibling) {
+        order.push_back(c);
+        ++out.count;
+      }
+    } else {
+      out.is_leaf = 1;
+      out.first = (uint32_t)out_refs.size();
+      out.count = (uint32_t)n->data.size();
+      for (size_t j = 0; j < n->data.size(); ++j) {
+        std::unordered_map<const Face<3>*, uint32_t>::const_iterator f =
+            face_idx.find(n->data[j]);
+        if (f == face_idx.end()) {
+          return false;
+        }
+        out_refs.push_back((*f).second);
+      }
+    }
+    out_nodes.push_back(out);
+  }
+
+  header_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+  hdr.version = VERSION;
+  hdr.byte_order = BYTE_ORDER_MARK;
+  hdr.header_size = sizeof(header_t);
+  hdr.node_size = sizeof(node_t);
+  hdr.n_nodes = (uint32_t)out_nodes.size();
+  hdr.n_refs = (uint32_t)out_refs.size();
+  hdr.n_faces = n_faces;
+  hdr.n_vertices = mesh->vertex_storage.size();
+  hdr.mesh_hash = meshHash(mesh);
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!out) {
+    return false;
+  }
+  out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  out.write(reinterpret_cast<const char*>(&out_nodes[0]),
+            out_nodes.size() * sizeof(node_t));
+  if (out_refs.size()) {
+    out.write(reinterpret_cast<const char*>(&out_refs[0]),
+              out_refs.size() * sizeof(uint32_t));
+  }
+  return out.good();
+}
+
+bool FaceRTreeIndex::write(const std::string& filename,
+                           const MeshSet<3>* mesh) {
+  MeshSet<3>* m = const_cast<MeshSet<3>*>(mesh);
+  if (m->faceBegin() == m->faceEnd()) {
+    return false;
+  }
+  std::unique_ptr<face_rtree_t> tree(
+      face_rtree_t::construct_STR(m->faceBegin(), m->faceEnd(), 4, 4));
+  return write(filename, mesh, tree.get());
+}
+
+bool FaceRTreeIndex::open(const std::string& filename,
+                          const MeshSet<3>* mesh) {
+  close();
+
+#ifndef WIN32
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(header_t)) {
+    ::close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    return false;
+  }
+  base = static_cast<const char*>(p);
+  size = (size_t)st.st_size;
+  mapped = true;
+#else
+  std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  in.seekg(0, std::ios::end);
+  buffer.resize((size_t)in.tellg());
+  in.seekg(0, std::ios::beg);
+  if (buffer.size()) {
+    in.read(&buffer[0], buffer.size());
+  }
+  if (!in || buffer.size() < sizeof(header_t)) {
+    buffer.clear();
+    return false;
+  }
+  base = &buffer[0];
+  size = buffer.size();
+#endif
+
+  if (!validate(mesh)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool FaceRTreeIndex::validate(const MeshSet<3>* mesh) {
+  const header_t* hdr = reinterpret_cast<const header_t*>(base);
+
+  if (memcmp(hdr->magic, MAGIC, sizeof(MAGIC)) || hdr->version != VERSION ||
+      hdr->byte_order != BYTE_ORDER_MARK ||
+      hdr->header_size != sizeof(header_t) ||
+      hdr->node_size != sizeof(node_t) || hdr->n_nodes == 0) {
+    return false;
+  }
+
+  if (size != sizeof(header_t) + (size_t)hdr->n_nodes * sizeof(node_t) +
+                  (size_t)hdr->n_refs * sizeof(uint32_t)) {
+    return false;
+  }
+
+  const node_t* n = reinterpret_cast<const node_t*>(base + sizeof(header_t));
+  const uint32_t* r = reinterpret_cast<const uint32_t*>(
+      base + sizeof(header_t) + (size_t)hdr->n_nodes * sizeof(node_t));
+
+  // structural checks, so that a corrupt file cannot cause
+  // out-of-bounds accesses or cycles during traversal.
+  for (uint32_t i = 0; i < hdr->n_nodes; ++i) {
+    if (n[i].is_leaf) {
+      if ((uint64_t)n[i].first + n[i].count > hdr->n_refs) {
+        return false;
+      }
+    } else {
+      if (n[i].count == 0 || n[i].first <= i ||
+          (uint64_t)n[i].first + n[i].count > hdr->n_nodes) {
+        return false;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < hdr->n_refs; ++i) {
+    if (r[i] >= hdr->n_faces) {
+      return false;
+    }
+  }
+
+  // staleness checks.
+  MeshSet<3>* m = const_cast<MeshSet<3>*>(mesh);
+  std::vector<Face<3>*> f(m->faceBegin(), m->faceEnd());
+  if (f.size() != hdr->n_faces ||
+      mesh->vertex_storage.size() != hdr->n_vertices ||
+      meshHash(mesh) != hdr->mesh_hash) {
+    return false;
+  }
+
+  header = hdr;
+  nodes = n;
+  refs = r;
+  faces.swap(f);
+  return true;
+}
+
+void FaceRTreeIndex::close() {
+#ifndef WIN32
+  if (mapped) {
+    munmap(const_cast<char*>(base), size);
+  }
+#endif
+  buffer.clear();
+  base = nullptr;
+  size = 0;
+  mapped = false;
+  header = nullptr;
+  nodes = nullptr;
+  refs = nullptr;
+  faces.clear();
+}
+
+face_rtree_t* FaceRTreeIndex::_toRTree(uint32_t n) const {
+  const node_t& node = nodes[n];
+  face_rtree_t* result = new face_rtree_t(node.getAABB());
+  if (node.is_leaf) {
+    result->data.reserve(node.count);
+    for (uint32_t i = node.first; i != node.first + node.count; ++i) {
+      result->data.push_back(faces[refs[i]]);
+    }
+  } else {
+    face_rtree_t** link = &result->child;
+    for (uint32_t i = node.first; i != node.first + node.count; ++i) {
+      *link = _toRTree(i);
+      link = &(*link)->sibling;
+    }
+  }
+  return result;
+}
+
+face_rtree_t* FaceRTreeIndex::toRTree() const {
+  if (!header) {
+    return nullptr;
+  }
+  return _toRTree(0);
+}
+}  // namespace mesh
+}  // namespace carve
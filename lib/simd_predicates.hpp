@@ -0,0 +1,87 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Four-lane versions of the floating point predicate filters in
+// carve/predicates.hpp, for AVX2 builds.
+
+#if defined(__AVX2__)
+
+#include <carve/predicates.hpp>
+
+#include <immintrin.h>
+
+namespace carve {
+namespace simd {
+
+inline __m256d abs4(__m256d x) {
+  return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+}
+
+// orient3d determinant of (a, b, c, d) per lane, evaluated as in
+// detail::orient3d_filter(). Sets permanent, and returns the
+// determinant.
+inline __m256d orient3d4(__m256d ax, __m256d ay, __m256d az, __m256d bx,
+                         __m256d by, __m256d bz, __m256d cx, __m256d cy,
+                         __m256d cz, __m256d dx, __m256d dy, __m256d dz,
+                         __m256d& permanent) {
+  const __m256d adx = _mm256_sub_pd(ax, dx), ady = _mm256_sub_pd(ay, dy),
+                adz = _mm256_sub_pd(az, dz);
+  const __m256d bdx = _mm256_sub_pd(bx, dx), bdy = _mm256_sub_pd(by, dy),
+                bdz = _mm256_sub_pd(bz, dz);
+  const __m256d cdx = _mm256_sub_pd(cx, dx), cdy = _mm256_sub_pd(cy, dy),
+                cdz = _mm256_sub_pd(cz, dz);
+
+  const __m256d bdxcdy = _mm256_mul_pd(bdx, cdy);
+  const __m256d cdxbdy = _mm256_mul_pd(cdx, bdy);
+  const __m256d cdxady = _mm256_mul_pd(cdx, ady);
+  const __m256d adxcdy = _mm256_mul_pd(adx, cdy);
+  const __m256d adxbdy = _mm256_mul_pd(adx, bdy);
+  const __m256d bdxady = _mm256_mul_pd(bdx, ady);
+
+  permanent = _mm256_add_pd(
+      _mm256_add_pd(
+          _mm256_mul_pd(_mm256_add_pd(abs4(bdxcdy), abs4(cdxbdy)), abs4(adz)),
+          _mm256_mul_pd(_mm256_add_pd(abs4(cdxady), abs4(adxcdy)), abs4(bdz))),
+      _mm256_mul_pd(_mm256_add_pd(abs4(adxbdy), abs4(bdxady)), abs4(cdz)));
+  return _mm256_add_pd(
+      _mm256_add_pd(_mm256_mul_pd(adz, _mm256_sub_pd(bdxcdy, cdxbdy)),
+                    _mm256_mul_pd(bdz, _mm256_sub_pd(cdxady, adxcdy))),
+      _mm256_mul_pd(cdz, _mm256_sub_pd(adxbdy, bdxady)));
+}
+
+// lanes (as a movemask) whose orient3d sign is certain.
+inline int orient3d4_decided(__m256d det, __m256d permanent) {
+  return _mm256_movemask_pd(
+      _mm256_cmp_pd(abs4(det),
+                    _mm256_mul_pd(_mm256_set1_pd(detail::o3d_errbound_a),
+                                  permanent),
+                    _CMP_GT_OQ));
+}
+
+}  // namespace simd
+}  // namespace carve
+
+#endif
@@ -30,10 +30,13 @@
 
 #include <carve/geom2d.hpp>
 #include <carve/geom3d.hpp>
+#include <carve/predicates.hpp>
 #include <carve/shewchuk_predicates.hpp>
 
 #include <cstdlib>
 
+#include "simd_predicates.hpp"
+
 #include <iostream>
 
 typedef carve::geom::vector<3> vec3;
@@ -66,6 +69,13 @@ inline double orient2d_exact(const vec2& a, const vec2& b, const vec2& c) {
   return shewchuk::orient2d(a.v, b.v, c.v);
 }
 
+// orientation of each vertex of tri_b relative to the plane of tri_a.
+inline void orient3d_exact(const vec3 tri_a[3], const vec3 tri_b[3],
+                           double o[3]) {
+  carve::orient3d_batch(3, tri_a[0].v, 0, tri_a[1].v, 0, tri_a[2].v, 0,
+                        tri_b[0].v, sizeof(vec3) / sizeof(double), o);
+}
+
 vec3 normal(const vec3 tri[3]) {
   return carve::geom::cross(tri[1] - tri[0], tri[2] - tri[0]);
 }
@@ -101,14 +111,10 @@ bool sat_bbox(const vec3 tri_a[3], const vec3 tri_b[3]) {
 
 // returns true if no intersection, based upon normal testing.
 sat_t sat_normal(const vec3 tri_a[3], const vec3 tri_b[3]) {
-  double v, lo, hi;
-  lo = hi = orient3d_exact(tri_a[0], tri_a[1], tri_a[2], tri_b[0]);
-  v = orient3d_exact(tri_a[0], tri_a[1], tri_a[2], tri_b[1]);
-  lo = std::min(lo, v);
-  hi = std::max(hi, v);
-  v = orient3d_exact(tri_a[0], tri_a[1], tri_a[2], tri_b[2]);
-  lo = std::min(lo, v);
-  hi = std::max(hi, v);
+  double o[3];
+  orient3d_exact(tri_a, tri_b, o);
+  double lo = std::min(std::min(o[0], o[1]), o[2]);
+  double hi = std::max(std::max(o[0], o[1]), o[2]);
 
   if (lo == 0.0 && hi == 0.0) {
     return SAT_COPLANAR;
@@ -299,9 +305,11 @@ void count(int v[3], int c[3]) {
 }
 
 void normal_sign(const vec3 tri_a[3], const vec3 tri_b[3], int nb[3]) {
-  nb[0] = dbl_sign(orient3d_exact(tri_a[0], tri_a[1], tri_a[2], tri_b[0]));
-  nb[1] = dbl_sign(orient3d_exact(tri_a[0], tri_a[1], tri_a[2], tri_b[1]));
-  nb[2] = dbl_sign(orient3d_exact(tri_a[0], tri_a[1], tri_a[2], tri_b[2]));
+  double o[3];
+  orient3d_exact(tri_a, tri_b, o);
+  nb[0] = dbl_sign(o[0]);
+  nb[1] = dbl_sign(o[1]);
+  nb[2] = dbl_sign(o[2]);
 }
 
 int line_segment_tri_test(const vec3 tri_a[3], const vec3& a, const vec3& b) {
@@ -741,5 +749,140 @@ TriangleIntType triangle_intersection_exact(const vec3 tri_a[3],
   }
   return TR_TYPE_TOUCH;
 }
+
+namespace {
+// true if the filter alone shows that q0, q1, q2 lie strictly on the
+// same side of the plane through p0, p1, p2.
+bool filter_one_side(const double* p0, const double* p1, const double* p2,
+                     const double* q0, const double* q1, const double* q2) {
+  double d0, d1, d2, perm;
+  if (!carve::detail::orient3d_filter(p0, p1, p2, q0, d0, perm) ||
+      !carve::detail::orient3d_filter(p0, p1, p2, q1, d1, perm) ||
+      !carve::detail::orient3d_filter(p0, p1, p2, q2, d2, perm)) {
+    return false;
+  }
+  return (d0 > 0.0 && d1 > 0.0 && d2 > 0.0) ||
+         (d0 < 0.0 && d1 < 0.0 && d2 < 0.0);
+}
+
+// scalar rejection test for pair (tri_a, packet triangle i).
+bool packet_reject(const vec3 tri_a[3], const double a_lo[3],
+                   const double a_hi[3], const triangle_packet& packet,
+                   size_t i, vec3 tri_b[3]) {
+  packet.get(i, tri_b);
+  for (unsigned k = 0; k < 3; ++k) {
+    double b_lo, b_hi;
+    extent(tri_b[0].v[k], tri_b[1].v[k], tri_b[2].v[k], b_lo, b_hi);
+    if (a_hi[k] < b_lo || b_hi < a_lo[k]) {
+      return true;
+    }
+  }
+  return filter_one_side(tri_a[0].v, tri_a[1].v, tri_a[2].v, tri_b[0].v,
+                         tri_b[1].v, tri_b[2].v) ||
+         filter_one_side(tri_b[0].v, tri_b[1].v, tri_b[2].v, tri_a[0].v,
+                         tri_a[1].v, tri_a[2].v);
+}
+
+#if defined(__AVX2__)
+// lanes in which the three determinants are all decided by the
+// filter and share a strict sign.
+int one_side4(__m256d d0, __m256d p0, __m256d d1, __m256d p1, __m256d d2,
+              __m256d p2) {
+  const int decided = carve::simd::orient3d4_decided(d0, p0) &
+                      carve::simd::orient3d4_decided(d1, p1) &
+                      carve::simd::orient3d4_decided(d2, p2);
+  const int s0 = _mm256_movemask_pd(d0), s1 = _mm256_movemask_pd(d1),
+            s2 = _mm256_movemask_pd(d2);
+  return decided & ((s0 & s1 & s2) | (~(s0 | s1 | s2) & 0xf));
+}
+
+// rejection test for pairs (tri_a, packet triangles i..i+3).
+int packet_reject4(const vec3 tri_a[3], const double a_lo[3],
+                   const double a_hi[3], const triangle_packet& packet,
+                   size_t i) {
+  __m256d b[3][3];  // b[axis][vertex]
+  const std::vector<double>* coord[3] = {packet.x, packet.y, packet.z};
+  for (unsigned c = 0; c < 3; ++c) {
+    for (unsigned k = 0; k < 3; ++k) {
+      b[c][k] = _mm256_loadu_pd(&coord[c][k][i]);
+    }
+  }
+
+  __m256d sep = _mm256_setzero_pd();
+  for (unsigned c = 0; c < 3; ++c) {
+    const __m256d b_lo = _mm256_min_pd(_mm256_min_pd(b[c][0], b[c][1]), b[c][2]);
+    const __m256d b_hi = _mm256_max_pd(_mm256_max_pd(b[c][0], b[c][1]), b[c][2]);
+    sep = _mm256_or_pd(
+        sep, _mm256_cmp_pd(_mm256_set1_pd(a_hi[c]), b_lo, _CMP_LT_OQ));
+    sep = _mm256_or_pd(
+        sep, _mm256_cmp_pd(b_hi, _mm256_set1_pd(a_lo[c]), _CMP_LT_OQ));
+  }
+  int reject = _mm256_movemask_pd(sep);
+  if (reject == 0xf) {
+    return reject;
+  }
+
+  __m256d a[3][3];  // a[axis][vertex], broadcast
+  for (unsigned c = 0; c < 3; ++c) {
+    for (unsigned k = 0; k < 3; ++k) {
+      a[c][k] = _mm256_set1_pd(tri_a[k].v[c]);
+    }
+  }
+
+  __m256d d[3], p[3];
+  // vertices of b against the plane of a.
+  for (unsigned k = 0; k < 3; ++k) {
+    d[k] = carve::simd::orient3d4(a[0][0], a[1][0], a[2][0], a[0][1], a[1][1],
+                                  a[2][1], a[0][2], a[1][2], a[2][2], b[0][k],
+                                  b[1][k], b[2][k], p[k]);
+  }
+  reject |= one_side4(d[0], p[0], d[1], p[1], d[2], p[2]);
+  if (reject == 0xf) {
+    return reject;
+  }
+
+  // vertices of a against the plane of b.
+  for (unsigned k = 0; k < 3; ++k) {
+    d[k] = carve::simd::orient3d4(b[0][0], b[1][0], b[2][0], b[0][1], b[1][1],
+                                  b[2][1], b[0][2], b[1][2], b[2][2], a[0][k],
+                                  a[1][k], a[2][k], p[k]);
+  }
+  return reject | one_side4(d[0], p[0], d[1], p[1], d[2], p[2]);
+}
+#endif
+}  // namespace
+
+void triangle_intersection_exact(const vec3 tri_a[3],
+                                 const triangle_packet& packet,
+                                 TriangleIntType* result) {
+  double a_lo[3], a_hi[3];
+  for (unsigned k = 0; k < 3; ++k) {
+    extent(tri_a[0].v[k], tri_a[1].v[k], tri_a[2].v[k], a_lo[k], a_hi[k]);
+  }
+
+  const size_t n = packet.size();
+  size_t i = 0;
+  vec3 tri_b[3];
+
+#if defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    const int reject = packet_reject4(tri_a, a_lo, a_hi, packet, i);
+    for (size_t j = 0; j < 4; ++j) {
+      if (reject & (1 << j)) {
+        result[i + j] = TR_TYPE_NONE;
+      } else {
+        packet.get(i + j, tri_b);
+        result[i + j] = triangle_intersection_exact(tri_a, tri_b);
+      }
+    }
+  }
+#endif
+
+  for (; i < n; ++i) {
+    result[i] = packet_reject(tri_a, a_lo, a_hi, packet, i, tri_b)
+                    ? TR_TYPE_NONE
+                    : triangle_intersection_exact(tri_a, tri_b);
+  }
+}
 }  // namespace geom
 }  // namespace carve
@@ -34,6 +34,8 @@
 
 #include <algorithm>
 
+#include "triangulator_sweep.hpp"
+
 namespace {
 // private code related to hole patching.
 
@@ -107,6 +109,103 @@ static inline const carve::geom2d::P2& pvert(
     const std::pair<size_t, size_t>& idx) {
   return poly[idx.first][idx.second];
 }
+
+// patch every hole into f_loop at once, joining hole_vert[i] to
+// attach_vert[i]. each attachment must be to the polygon loop or to a
+// hole that precedes it.
+static bool patchHolesIntoPolygon_2d(
+    const std::vector<std::vector<carve::geom2d::P2> >& poly,
+    std::vector<std::pair<size_t, size_t> >& f_loop,
+    const std::vector<std::pair<size_t, size_t> >& hole_vert,
+    const std::vector<std::pair<size_t, size_t> >& attach_vert) {
+  const size_t NONE = ~(size_t)0;
+
+  // the loop is built as a linked list of nodes. the first node for
+  // each vertex is at base[loop] + index, and the extra nodes created
+  // where a bridge duplicates a vertex are chained through dup.
+  std::vector<size_t> base(poly.size(), NONE);
+  std::vector<std::pair<size_t, size_t> > vert;
+  for (size_t i = 0; i <= hole_vert.size(); ++i) {
+    size_t loop = i ? hole_vert[i - 1].first : f_loop[0].first;
+    base[loop] = vert.size();
+    for (size_t j = 0; j < poly[loop].size(); ++j) {
+      vert.push_back(std::make_pair(loop, j));
+    }
+  }
+  const size_t N = vert.size();
+  std::vector<size_t> next(N, NONE), prev(N, NONE), dup(N, NONE);
+
+  const size_t F = poly[f_loop[0].first].size();
+  for (size_t i = 0; i < F; ++i) {
+    next[i] = (i + 1) % F;
+    prev[(i + 1) % F] = i;
+  }
+
+  for (size_t i = 0; i < hole_vert.size(); ++i) {
+    if (base[attach_vert[i].first] == NONE) {
+      return false;
+    }
+    size_t t = base[attach_vert[i].first] + attach_vert[i].second;
+    if (next[t] == NONE) {
+      return false;
+    }
+
+    // where the attachment vertex already occurs more than once, use
+    // the occurrence whose angle contains the bridge.
+    const carve::geom2d::P2& h = pvert(poly, hole_vert[i]);
+    size_t at = t;
+    if (dup[t] != NONE) {
+      for (; at != NONE; at = dup[at]) {
+        if (carve::geom2d::internalToAngle(pvert(poly, vert[next[at]]),
+                                           pvert(poly, vert[at]),
+                                           pvert(poly, vert[prev[at]]), h)) {
+          break;
+        }
+      }
+      if (at == NONE) {
+        return false;
+      }
+    }
+
+    const size_t after = next[at];
+    const size_t hole_base = base[hole_vert[i].first];
+    const size_t hole_size = poly[hole_vert[i].first].size();
+    const size_t c = hole_base + hole_vert[i].second;
+
+    size_t last = at;
+    for (size_t j = 0; j <= hole_size + 1; ++j) {
+      size_t n;
+      if (j < hole_size) {
+        n = hole_base + (hole_vert[i].second + j) % hole_size;
+      } else {
+        // close the hole, and return along the bridge.
+        size_t orig = j == hole_size ? c : t;
+        n = vert.size();
+        vert.push_back(vert[orig]);
+        next.push_back(NONE);
+        prev.push_back(NONE);
+        dup.push_back(dup[orig]);
+        dup[orig] = n;
+      }
+      next[last] = n;
+      prev[n] = last;
+      last = n;
+    }
+    next[last] = after;
+    prev[after] = last;
+  }
+
+  std::vector<std::pair<size_t, size_t> > result;
+  result.reserve(vert.size());
+  size_t n = 0;
+  do {
+    result.push_back(vert[n]);
+    n = next[n];
+  } while (n != 0);
+
+  f_loop.swap(result);
+  return true;
+}
 }  // namespace
 
 namespace {
@@ -130,7 +229,7 @@ struct vertex_info_l2norm_inc_ordering {
 };
 
 class EarQueue {
-  std::vector<vertex_info*> queue;
+  std::vector<vertex_info*>& queue;
 
   void checkheap() {
     CARVE_ASSERT(
@@ -138,7 +237,10 @@ class EarQueue {
   }
 
  public:
-  EarQueue() {}
+  // the heap is kept in storage, which is cleared but not freed.
+  EarQueue(std::vector<vertex_info*>& storage) : queue(storage) {
+    queue.clear();
+  }
 
   size_t size() const { return queue.size(); }
 
@@ -214,6 +316,151 @@ class EarQueue {
   }
 };
 
+// returns true if the reflex vertex v_test prevents the ear at v from
+// being clipped.
+bool earBlockedBy(const vertex_info* v, const vertex_info* v_test) {
+  if (v_test->p == v->prev->p || v_test->p == v->next->p) {
+    return false;
+  }
+
+  if (v_test->p == v->p) {
+    if (v_test->next->p == v->prev->p && v_test->prev->p == v->next->p) {
+      return true;
+    }
+    if (v_test->next->p == v->prev->p || v_test->prev->p == v->next->p) {
+      return false;
+    }
+  }
+
+  return carve::triangulate::detail::pointInTriangle(v->prev, v, v->next,
+                                                     v_test);
+}
+
+// A uniform grid over the reflex vertices of a loop. Only reflex
+// vertices can block an ear, so for large loops bucketing them lets
+// isClipable() examine the vertices near the candidate ear rather than
+// walking the whole loop. Vertices that have since become convex are
+// left in place and skipped on query.
+class ReflexGrid {
+  typedef std::vector<vertex_info*> cell_t;
+
+  carve::geom2d::P2 origin;
+  double scale_x, scale_y;
+  int nx, ny;
+  double eps;
+  // cells beyond nx * ny are left over from a previous, larger loop.
+  std::vector<cell_t> cells;
+  bool active;
+
+  int cellX(double x) const {
+    return std::min(nx - 1, std::max(0, (int)((x - origin.x) * scale_x)));
+  }
+  int cellY(double y) const {
+    return std::min(ny - 1, std::max(0, (int)((y - origin.y) * scale_y)));
+  }
+  cell_t& cellFor(const carve::geom2d::P2& p) {
+    return cells[cellY(p.y) * nx + cellX(p.x)];
+  }
+
+ public:
+  enum { MAX_CELLS_PER_AXIS = 1024 };
+
+  ReflexGrid() : nx(0), ny(0), active(false) {}
+
+  bool empty() const { return !active; }
+
+  void clear() { active = false; }
+
+  void init(vertex_info* begin, size_t n_reflex) {
+    carve::geom2d::P2 lo = begin->p, hi = begin->p;
+    vertex_info* v = begin;
+    do {
+      assign_op(lo, lo, v->p, carve::util::min_functor());
+      assign_op(hi, hi, v->p, carve::util::max_functor());
+      v = v->next;
+    } while (v != begin);
+
+    double w = hi.x - lo.x, h = hi.y - lo.y;
+    double n = (double)std::max(n_reflex, (size_t)1);
+    double fx = (w > 0.0 && h > 0.0) ? sqrt(n * w / h) : (w > 0.0 ? n : 1.0);
+    nx = (int)std::min(std::max(fx, 1.0), (double)MAX_CELLS_PER_AXIS);
+    ny = (int)std::min(std::max(n / nx, 1.0), (double)MAX_CELLS_PER_AXIS);
+
+    origin = lo;
+    scale_x = w > 0.0 ? nx / w : 0.0;
+    scale_y = h > 0.0 ? ny / h : 0.0;
+    // queried triangles are widened slightly so that a vertex sitting
+    // on an ear's boundary is never missed due to rounding.
+    eps = std::max(w, h) * 1e-9;
+    if (cells.size() < (size_t)(nx * ny)) {
+      cells.resize(nx * ny);
+    }
+    for (int i = 0; i < nx * ny; ++i) {
+      cells[i].clear();
+    }
+    active = true;
+
+    v = begin;
+    do {
+      if (!v->convex) {
+        cellFor(v->p).push_back(v);
+      }
+      v = v->next;
+    } while (v != begin);
+  }
+
+  void insert(vertex_info* v) {
+    cell_t& c = cellFor(v->p);
+    if (std::find(c.begin(), c.end(), v) == c.end()) {
+      c.push_back(v);
+    }
+  }
+
+  void remove(vertex_info* v) {
+    cell_t& c = cellFor(v->p);
+    c.erase(std::remove(c.begin(), c.end(), v), c.end());
+  }
+
+  bool blocked(const vertex_info* v) const {
+    const carve::geom2d::P2& a = v->prev->p;
+    const carve::geom2d::P2& b = v->p;
+    const carve::geom2d::P2& c = v->next->p;
+
+    int x1 = cellX(std::min(a.x, std::min(b.x, c.x)) - eps);
+    int x2 = cellX(std::max(a.x, std::max(b.x, c.x)) + eps);
+    int y1 = cellY(std::min(a.y, std::min(b.y, c.y)) - eps);
+    int y2 = cellY(std::max(a.y, std::max(b.y, c.y)) + eps);
+
+    for (int y = y1; y <= y2; ++y) {
+      for (int x = x1; x <= x2; ++x) {
+        const cell_t& cell = cells[y * nx + x];
+        for (size_t i = 0; i < cell.size(); ++i) {
+          const vertex_info* v_test = cell[i];
+          if (v_test->convex || v_test == v || v_test == v->prev ||
+              v_test == v->next) {
+            continue;
+          }
+          if (earBlockedBy(v, v_test)) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+};
+
+// below this size a linear walk of the loop is cheaper than
+// maintaining a grid.
+const size_t REFLEX_GRID_MIN_VERTICES = 64;
+
+inline bool isClipable(const vertex_info* v, const ReflexGrid& grid) {
+  if (grid.empty()) {
+    return v->isClipable();
+  }
+  return !grid.blocked(v);
+}
+
 int windingNumber(vertex_info* begin, const carve::geom2d::P2& point) {
   int wn = 0;
 
@@ -412,6 +659,48 @@ void dumpPoly(const std::vector<carve::geom2d::P2>& points,
 #endif
 }  // namespace
 
+// Scratch storage owned by a carve::triangulate::Triangulator.
+struct carve::triangulate::detail::workspace_t {
+  enum { BLOCK_SIZE = 256 };
+
+  // vertex_info nodes are taken from blocks that are only released
+  // when the workspace is destroyed, so that node pointers stay valid
+  // for the duration of a triangulation. A block's storage is reserved
+  // up front and never reallocated.
+  std::vector<std::vector<vertex_info> > blocks;
+  size_t block, used;
+
+  std::vector<vertex_info*> heap;
+  ReflexGrid grid;
+  std::vector<std::vector<carve::geom2d::P2> > loops;
+  MonotoneSweep sweep;
+
+  workspace_t() : block(0), used(0) {}
+
+  void reset() {
+    block = 0;
+    used = 0;
+  }
+
+  vertex_info* alloc(const vertex_info& v) {
+    if (used == BLOCK_SIZE) {
+      ++block;
+      used = 0;
+    }
+    if (block == blocks.size()) {
+      blocks.push_back(std::vector<vertex_info>());
+      blocks.back().reserve(BLOCK_SIZE);
+    }
+    std::vector<vertex_info>& b = blocks[block];
+    if (used < b.size()) {
+      b[used] = v;
+    } else {
+      b.push_back(v);
+    }
+    return &b[used++];
+  }
+};
+
 double carve::triangulate::detail::vertex_info::triScore(const vertex_info* p,
                                                          const vertex_info* v,
                                                          const vertex_info* n) {
@@ -491,20 +780,7 @@ bool carve::triangulate::detail::vertex_info::isClipable() const {
       continue;
     }
 
-    if (v_test->p == prev->p || v_test->p == next->p) {
-      continue;
-    }
-
-    if (v_test->p == p) {
-      if (v_test->next->p == prev->p && v_test->prev->p == next->p) {
-        return false;
-      }
-      if (v_test->next->p == prev->p || v_test->prev->p == next->p) {
-        continue;
-      }
-    }
-
-    if (pointInTriangle(prev, this, next, v_test)) {
+    if (earBlockedBy(this, v_test)) {
       return false;
     }
   }
@@ -565,7 +841,6 @@ size_t carve::triangulate::detail::removeDegeneracies(
       n->remove();
       count++;
       remain--;
-      delete n;
     } else {
       v = v->next;
     }
@@ -574,7 +849,8 @@ size_t carve::triangulate::detail::removeDegeneracies(
 }
 
 bool carve::triangulate::detail::splitAndResume(
-    vertex_info* begin, std::vector<carve::triangulate::tri_idx>& result) {
+    vertex_info* begin, std::vector<carve::triangulate::tri_idx>& result,
+    workspace_t& ws) {
   vertex_info *v1, *v2;
 
 #if defined(CARVE_DEBUG_WRITE_PLY_DATA)
@@ -595,8 +871,8 @@ bool carve::triangulate::detail::splitAndResume(
     return false;
   }
 
-  vertex_info* v1_copy = new vertex_info(*v1);
-  vertex_info* v2_copy = new vertex_info(*v2);
+  vertex_info* v1_copy = ws.alloc(*v1);
+  vertex_info* v2_copy = ws.alloc(*v2);
 
   v1->next = v2;
   v2->prev = v1;
@@ -607,13 +883,14 @@ bool carve::triangulate::detail::splitAndResume(
   v1_copy->prev = v2_copy;
   v2_copy->next = v1_copy;
 
-  bool r1 = doTriangulate(v1, result);
-  bool r2 = doTriangulate(v1_copy, result);
+  bool r1 = doTriangulate(v1, result, ws);
+  bool r2 = doTriangulate(v1_copy, result, ws);
   return r1 && r2;
 }
 
 bool carve::triangulate::detail::doTriangulate(
-    vertex_info* begin, std::vector<carve::triangulate::tri_idx>& result) {
+    vertex_info* begin, std::vector<carve::triangulate::tri_idx>& result,
+    workspace_t& ws) {
 #if defined(CARVE_DEBUG)
   std::cerr << "entering doTriangulate" << std::endl;
 #endif
@@ -631,25 +908,37 @@ bool carve::triangulate::detail::doTriangulate(
   }
 #endif
 
-  EarQueue vq;
+  // splitAndResume() reuses the queue and grid storage, but only once
+  // this loop has finished with them.
+  EarQueue vq(ws.heap);
 
   vertex_info* v = begin;
   size_t remain = 0;
+  size_t n_reflex = 0;
   do {
     if (v->isCandidate()) {
       vq.push(v);
     }
+    if (!v->convex) {
+      n_reflex++;
+    }
     v = v->next;
     remain++;
   } while (v != begin);
 
+  ReflexGrid& grid = ws.grid;
+  grid.clear();
+  if (remain >= REFLEX_GRID_MIN_VERTICES) {
+    grid.init(begin, n_reflex);
+  }
+
 #if defined(CARVE_DEBUG)
   std::cerr << "remain = " << remain << std::endl;
 #endif
 
   while (remain > 3 && vq.size()) {
     vertex_info* v = vq.pop();
-    if (!v->isClipable()) {
+    if (!isClipable(v, grid)) {
       v->failed = true;
       continue;
     }
@@ -678,7 +967,9 @@ bool carve::triangulate::detail::doTriangulate(
     if (v == begin) {
       begin = v->next;
     }
-    delete v;
+    if (!grid.empty()) {
+      grid.remove(v);
+    }
 
     if (--remain == 3) {
       break;
@@ -687,11 +978,20 @@ bool carve::triangulate::detail::doTriangulate(
     vq.updateVertex(n);
     vq.updateVertex(p);
 
+    if (!grid.empty()) {
+      if (!n->convex) {
+        grid.insert(n);
+      }
+      if (!p->convex) {
+        grid.insert(p);
+      }
+    }
+
     if (n->score < p->score) {
       std::swap(n, p);
     }
 
-    if (n->score > 0.25 && n->isCandidate() && n->isClipable()) {
+    if (n->score > 0.25 && n->isCandidate() && isClipable(n, grid)) {
       vq.remove(n);
       v = n;
 #if defined(CARVE_DEBUG)
@@ -700,7 +1000,7 @@ bool carve::triangulate::detail::doTriangulate(
       goto continue_clipping;
     }
 
-    if (p->score > 0.25 && p->isCandidate() && p->isClipable()) {
+    if (p->score > 0.25 && p->isCandidate() && isClipable(p, grid)) {
       vq.remove(p);
       v = p;
 #if defined(CARVE_DEBUG)
@@ -729,7 +1029,7 @@ bool carve::triangulate::detail::doTriangulate(
 #endif
 
     if (remain > 3) {
-      return splitAndResume(begin, result);
+      return splitAndResume(begin, result, ws);
     }
   }
 
@@ -738,13 +1038,6 @@ bool carve::triangulate::detail::doTriangulate(
                                                  begin->next->next->idx));
   }
 
-  vertex_info* d = begin;
-  do {
-    vertex_info* n = d->next;
-    delete d;
-    d = n;
-  } while (d != begin);
-
   return true;
 }
 
@@ -800,6 +1093,18 @@ bool testCandidateAttachment(
   return true;
 }
 
+bool carve::triangulate::detail::sweepIncorporateHoles(
+    const std::vector<std::vector<carve::geom2d::P2> >& poly,
+    std::vector<std::pair<size_t, size_t> >& f_loop,
+    const std::vector<size_t>& hole_loops) {
+  // bridges found by a plane sweep are visible by construction, so
+  // holes can be merged in O(n log n).
+  std::vector<std::pair<size_t, size_t> > hole_vert, attach_vert;
+  return sweepBridgeHoles(poly, f_loop[0].first, hole_loops, hole_vert,
+                          attach_vert) &&
+         patchHolesIntoPolygon_2d(poly, f_loop, hole_vert, attach_vert);
+}
+
 void carve::triangulate::incorporateHolesIntoPolygon(
     const std::vector<std::vector<carve::geom2d::P2> >& poly,
     std::vector<std::pair<size_t, size_t> >& result, size_t poly_loop,
@@ -830,6 +1135,12 @@ void carve::triangulate::incorporateHolesIntoPolygon(
     return;
   }
 
+  // degenerate input that the sweep rejects falls through to the
+  // incremental search below.
+  if (detail::sweepIncorporateHoles(poly, result, hole_loops)) {
+    return;
+  }
+
   std::vector<std::pair<size_t, size_t> > h_loop_min_vertex;
 
   h_loop_min_vertex.reserve(hole_loops.size());
@@ -1131,10 +1442,14 @@ carve::triangulate::mergePolygonsAndHoles(
   throw carve::exception("not implemented");
 }
 
-void carve::triangulate::triangulate(
+carve::triangulate::Triangulator::Triangulator() : ws(nullptr) {}
+
+carve::triangulate::Triangulator::~Triangulator() { delete ws; }
+
+void carve::triangulate::Triangulator::triangulate(
     const std::vector<carve::geom2d::P2>& poly,
-    std::vector<carve::triangulate::tri_idx>& result) {
-  std::vector<detail::vertex_info*> vinfo;
+    std::vector<carve::triangulate::tri_idx>& result,
+    TriangulationMethod method) {
   const size_t N = poly.size();
 
 #if defined(CARVE_DEBUG)
@@ -1157,28 +1472,47 @@ void carve::triangulate::triangulate(
     return;
   }
 
-  vinfo.resize(N);
+  // triangles never touch the workspace, so it is only allocated once a
+  // larger polygon is seen.
+  if (ws == nullptr) {
+    ws = new detail::workspace_t;
+  }
 
-  vinfo[0] = new detail::vertex_info(poly[0], 0);
-  for (size_t i = 1; i < N - 1; ++i) {
-    vinfo[i] = new detail::vertex_info(poly[i], i);
-    vinfo[i]->prev = vinfo[i - 1];
-    vinfo[i - 1]->next = vinfo[i];
+  if (detail::fastTriangulate(poly, result, ws->sweep)) {
+    return;
   }
-  vinfo[N - 1] = new detail::vertex_info(poly[N - 1], N - 1);
-  vinfo[N - 1]->prev = vinfo[N - 2];
-  vinfo[N - 1]->next = vinfo[0];
-  vinfo[0]->prev = vinfo[N - 1];
-  vinfo[N - 2]->next = vinfo[N - 1];
+  result.clear();
 
-  for (size_t i = 0; i < N; ++i) {
-    vinfo[i]->recompute();
+  if (method == MONOTONE_SWEEP) {
+    ws->loops.resize(1);
+    ws->loops[0].assign(poly.begin(), poly.end());
+    if (ws->sweep.run(ws->loops, result)) {
+      return;
+    }
+    result.clear();
   }
 
-  detail::vertex_info* begin = vinfo[0];
+  ws->reset();
+
+  detail::vertex_info* begin = ws->alloc(detail::vertex_info(poly[0], 0));
+  detail::vertex_info* prev = begin;
+  for (size_t i = 1; i < N; ++i) {
+    detail::vertex_info* v = ws->alloc(detail::vertex_info(poly[i], i));
+    v->prev = prev;
+    prev->next = v;
+    prev = v;
+  }
+  prev->next = begin;
+  begin->prev = prev;
+
+  detail::vertex_info* v = begin;
+  do {
+    v->recompute();
+    v = v->next;
+  } while (v != begin);
 
-  removeDegeneracies(begin, result);
-  doTriangulate(begin, result);
+  detail::removeDegeneracies(begin, result);
+  detail::doTriangulate(begin, result, *ws);
 
 #if defined(CARVE_DEBUG)
   std::cerr << "TRIANGULATION ENDS" << std::endl;
@@ -1189,47 +1523,47 @@ void carve::triangulate::triangulate(
 #endif
 }
 
-void carve::triangulate::detail::tri_pair_t::flip(vert_edge_t& old_edge,
-                                                  vert_edge_t& new_edge,
-                                                  vert_edge_t perim[4]) {
-  unsigned ai, bi;
-  unsigned cross_ai, cross_bi;
+void carve::triangulate::triangulate(
+    const std::vector<carve::geom2d::P2>& poly,
+    std::vector<carve::triangulate::tri_idx>& result,
+    TriangulationMethod method) {
+  Triangulator triangulator;
+  triangulator.triangulate(poly, result, method);
+}
 
-  findSharedEdge(ai, bi);
-  old_edge = ordered_vert_edge_t(a->v[ai], b->v[bi]);
+void carve::triangulate::triangulate(
+    const std::vector<std::vector<carve::geom2d::P2> >& poly,
+    std::vector<carve::triangulate::tri_idx>& result,
+    TriangulationMethod method) {
+  result.clear();
+  if (poly.empty()) {
+    return;
+  }
 
-  cross_ai = P(ai);
-  cross_bi = P(bi);
-  new_edge = ordered_vert_edge_t(a->v[cross_ai], b->v[cross_bi]);
+  if (method == MONOTONE_SWEEP && detail::sweepTriangulate(poly, result)) {
+    return;
+  }
 
-  score = -score;
+  std::vector<size_t> base(poly.size(), 0);
+  for (size_t i = 1; i < poly.size(); ++i) {
+    base[i] = base[i - 1] + poly[i - 1].size();
+  }
 
-  a->v[N(ai)] = b->v[cross_bi];
-  b->v[N(bi)] = a->v[cross_ai];
+  std::vector<std::pair<size_t, size_t> > loop =
+      incorporateHolesIntoPolygon(poly);
 
-  perim[0] = ordered_vert_edge_t(a->v[P(ai)], a->v[ai]);
-  perim[1] =
-      ordered_vert_edge_t(a->v[N(ai)], a->v[ai]);  // this edge was a b-edge
+  std::vector<carve::geom2d::P2> merged;
+  merged.reserve(loop.size());
+  for (size_t i = 0; i < loop.size(); ++i) {
+    merged.push_back(pvert(poly, loop[i]));
+  }
 
-  perim[2] = ordered_vert_edge_t(b->v[P(bi)], b->v[bi]);
-  perim[3] =
-      ordered_vert_edge_t(b->v[N(bi)], b->v[bi]);  // this edge was an a-edge
-}
+  triangulate(merged, result, EAR_CLIPPING);
 
-void carve::triangulate::detail::tri_pairs_t::insert(
-    unsigned a, unsigned b, carve::triangulate::tri_idx* t) {
-  tri_pair_t* tp;
-  if (a < b) {
-    tp = storage[vert_edge_t(a, b)];
-    if (!tp) {
-      tp = storage[vert_edge_t(a, b)] = new tri_pair_t;
-    }
-    tp->a = t;
-  } else {
-    tp = storage[vert_edge_t(b, a)];
-    if (!tp) {
-      tp = storage[vert_edge_t(b, a)] = new tri_pair_t;
+  for (size_t i = 0; i < result.size(); ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      const std::pair<size_t, size_t>& v = loop[result[i].v[j]];
+      result[i].v[j] = base[v.first] + v.second;
     }
-    tp->b = t;
   }
 }
@@ -0,0 +1,114 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/triangulator.hpp>
+
+#include "triangulator_sweep.hpp"
+
+const size_t carve::triangulate::detail::MonotoneSweep::NONE;
+
+namespace {
+
+using carve::geom2d::P2;
+using carve::triangulate::tri_idx;
+
+// true if a precedes b in sweep order (see MonotoneSweep::above()).
+inline bool higher(const P2& a, const P2& b) {
+  return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+// triangulates a strictly convex loop as a strip that zig-zags between
+// the two ends of the index range, which gives better shaped triangles
+// than a fan. returns false if the loop is not strictly convex.
+bool convexTriangulate(const std::vector<P2>& poly,
+                       std::vector<tri_idx>& result) {
+  const size_t N = poly.size();
+  int sign = 0;
+  size_t maxima = 0;
+  for (size_t i = 0; i < N; ++i) {
+    const P2& p = poly[(i + N - 1) % N];
+    const P2& v = poly[i];
+    const P2& n = poly[(i + 1) % N];
+    double o = carve::geom2d::orient2d(p, v, n);
+    if (o == 0.0) {
+      return false;
+    }
+    int s = o > 0.0 ? +1 : -1;
+    if (sign == 0) {
+      sign = s;
+    } else if (s != sign) {
+      return false;
+    }
+    // a loop that turns the same way throughout but winds more than
+    // once has more than one topmost vertex.
+    if (higher(v, p) && higher(v, n) && ++maxima > 1) {
+      return false;
+    }
+  }
+
+  result.clear();
+  result.reserve(N - 2);
+  size_t a = 0, b = N - 1;
+  for (bool step = true; b - a > 1; step = !step) {
+    if (step) {
+      result.push_back(tri_idx(a, a + 1, b));
+      ++a;
+    } else {
+      result.push_back(tri_idx(a, b - 1, b));
+      --b;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool carve::triangulate::detail::fastTriangulate(
+    const std::vector<carve::geom2d::P2>& poly,
+    std::vector<carve::triangulate::tri_idx>& result, MonotoneSweep& sweep) {
+  if (convexTriangulate(poly, result)) {
+    return true;
+  }
+  return sweep.runMonotone(poly, result);
+}
+
+bool carve::triangulate::detail::sweepTriangulate(
+    const std::vector<std::vector<carve::geom2d::P2> >& poly,
+    std::vector<carve::triangulate::tri_idx>& result) {
+  MonotoneSweep sweep;
+  return sweep.run(poly, result);
+}
+
+bool carve::triangulate::detail::sweepBridgeHoles(
+    const std::vector<std::vector<carve::geom2d::P2> >& poly, size_t poly_loop,
+    const std::vector<size_t>& hole_loops,
+    std::vector<std::pair<size_t, size_t> >& hole_vert,
+    std::vector<std::pair<size_t, size_t> >& attach_vert) {
+  MonotoneSweep sweep;
+  return sweep.bridge(poly, poly_loop, hole_loops, hole_vert, attach_vert);
+}
@@ -0,0 +1,682 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <carve/triangulator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <vector>
+
+// Triangulation by plane sweep: the polygon (with any holes) is first
+// split into y-monotone pieces by adding diagonals at split and merge
+// vertices (de Berg et al., Computational Geometry, ch. 3), and each
+// piece is then triangulated in linear time. Both passes are
+// O(n log n) overall, independent of the number of holes.
+//
+// Most faces produced by CSG operations are convex or already
+// monotone, and fastTriangulate() recognises these in a single linear
+// pass, without the cost of the sweep or of ear clipping.
+
+namespace carve {
+namespace triangulate {
+namespace detail {
+
+class MonotoneSweep {
+  typedef carve::geom2d::P2 P2;
+
+  static const size_t NONE = ~(size_t)0;
+
+  enum VertexType { START, END, SPLIT, MERGE, REGULAR };
+
+  enum Chain { LEFT_CHAIN, RIGHT_CHAIN };
+
+  // vertices, flattened over all loops. every loop is oriented so that
+  // the polygon interior is to its left.
+  std::vector<P2> pts;
+  std::vector<size_t> prev, next;
+  std::vector<VertexType> type;
+
+  // edge i runs from vertex i to next[i]. only edges with the
+  // interior to their right (i.e. those running downwards) are ever
+  // held in the sweep status.
+  struct edge_order {
+    const MonotoneSweep* sweep;
+    edge_order(const MonotoneSweep* _sweep) : sweep(_sweep) {}
+    bool operator()(size_t a, size_t b) const { return sweep->west(a, b); }
+  };
+  typedef std::set<size_t, edge_order> status_t;
+
+  status_t status;
+  std::vector<status_t::iterator> status_pos;
+  std::vector<size_t> helper;
+  size_t probe;
+
+  std::vector<std::pair<size_t, size_t> > diagonals;
+  // for each split vertex, the vertex its diagonal joins it to.
+  std::vector<size_t> split_partner;
+
+  // the source loop of each run of vertices, and where it starts.
+  std::vector<size_t> loop_id, loop_base;
+  // true if the outline had to be reversed.
+  bool reversed;
+
+  // scratch storage for triangulatePiece() and runMonotone(), kept so
+  // that a reused sweep does not reallocate.
+  std::vector<size_t> left, right, merged, stack, outline;
+  std::vector<Chain> chain;
+
+  // discards the previous polygon, keeping allocated storage.
+  void reset() {
+    pts.clear();
+    status.clear();
+    diagonals.clear();
+    loop_base.clear();
+    probe = NONE;
+    reversed = false;
+  }
+
+  // true if a is visited before b; the sweep runs from top to bottom,
+  // and from left to right along a horizontal line.
+  bool above(size_t a, size_t b) const {
+    if (pts[a].y != pts[b].y) {
+      return pts[a].y > pts[b].y;
+    }
+    if (pts[a].x != pts[b].x) {
+      return pts[a].x < pts[b].x;
+    }
+    return a < b;
+  }
+
+  struct sweep_order {
+    const MonotoneSweep* sweep;
+    sweep_order(const MonotoneSweep* _sweep) : sweep(_sweep) {}
+    bool operator()(size_t a, size_t b) const { return sweep->above(a, b); }
+  };
+
+  size_t upper(size_t e) const { return e == NONE ? probe : e; }
+  size_t lower(size_t e) const { return e == NONE ? probe : next[e]; }
+
+  double orient(size_t a, size_t b, size_t c) const {
+    return carve::geom2d::orient2d(pts[a], pts[b], pts[c]);
+  }
+
+  // true if edge a lies to the west of edge b. NONE stands for a
+  // zero length edge at the probe vertex. Edges in the status never
+  // cross, so it suffices to test the upper endpoint of whichever
+  // edge starts later against the other edge.
+  bool west(size_t a, size_t b) const {
+    if (a == b) {
+      return false;
+    }
+    size_t a1 = upper(a), a2 = lower(a);
+    size_t b1 = upper(b), b2 = lower(b);
+    double o;
+    if (a == NONE || (b != NONE && !above(a1, b1))) {
+      if ((o = orient(b1, b2, a1)) != 0.0) {
+        return o < 0.0;
+      }
+      if ((o = orient(b1, b2, a2)) != 0.0) {
+        return o < 0.0;
+      }
+    } else {
+      if ((o = orient(a1, a2, b1)) != 0.0) {
+        return o > 0.0;
+      }
+      if ((o = orient(a1, a2, b2)) != 0.0) {
+        return o > 0.0;
+      }
+    }
+    return a < b;
+  }
+
+  void insertEdge(size_t e, size_t h) {
+    status_pos[e] = status.insert(e).first;
+    helper[e] = h;
+  }
+
+  bool removeEdge(size_t e, size_t v) {
+    if (status_pos[e] == status.end()) {
+      return false;
+    }
+    if (type[helper[e]] == MERGE) {
+      diagonals.push_back(std::make_pair(v, helper[e]));
+    }
+    status.erase(status_pos[e]);
+    status_pos[e] = status.end();
+    return true;
+  }
+
+  // the edge immediately to the west of v.
+  size_t leftOf(size_t v) {
+    probe = v;
+    status_t::iterator i = status.lower_bound(NONE);
+    if (i == status.begin()) {
+      return NONE;
+    }
+    return *--i;
+  }
+
+  bool classify() {
+    type.resize(pts.size());
+    for (size_t v = 0; v < pts.size(); ++v) {
+      bool p_below = above(v, prev[v]);
+      bool n_below = above(v, next[v]);
+      if (p_below == n_below) {
+        double o = orient(prev[v], v, next[v]);
+        if (o == 0.0) {
+          // a spike: cannot tell locally whether it points into or
+          // out of the polygon.
+          return false;
+        }
+        type[v] = p_below ? (o > 0.0 ? START : SPLIT) : (o > 0.0 ? END : MERGE);
+      } else {
+        type[v] = REGULAR;
+      }
+    }
+    return true;
+  }
+
+  bool decompose() {
+    std::vector<size_t> order(pts.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), sweep_order(this));
+
+    status_pos.assign(pts.size(), status.end());
+    helper.assign(pts.size(), NONE);
+    split_partner.assign(pts.size(), NONE);
+
+    for (size_t i = 0; i < order.size(); ++i) {
+      size_t v = order[i];
+      size_t e;
+      switch (type[v]) {
+        case START:
+          insertEdge(v, v);
+          break;
+        case END:
+          if (!removeEdge(prev[v], v)) {
+            return false;
+          }
+          break;
+        case SPLIT:
+          if ((e = leftOf(v)) == NONE) {
+            return false;
+          }
+          diagonals.push_back(std::make_pair(v, helper[e]));
+          split_partner[v] = helper[e];
+          helper[e] = v;
+          insertEdge(v, v);
+          break;
+        case MERGE:
+          if (!removeEdge(prev[v], v) || (e = leftOf(v)) == NONE) {
+            return false;
+          }
+          if (type[helper[e]] == MERGE) {
+            diagonals.push_back(std::make_pair(v, helper[e]));
+          }
+          helper[e] = v;
+          break;
+        case REGULAR:
+          if (above(prev[v], v)) {
+            // interior lies to the east.
+            if (!removeEdge(prev[v], v)) {
+              return false;
+            }
+            insertEdge(v, v);
+          } else {
+            if ((e = leftOf(v)) == NONE) {
+              return false;
+            }
+            if (type[helper[e]] == MERGE) {
+              diagonals.push_back(std::make_pair(v, helper[e]));
+            }
+            helper[e] = v;
+          }
+          break;
+      }
+    }
+    return status.empty();
+  }
+
+  // true if, about v, the direction to a precedes the direction to b
+  // in anticlockwise order starting from the positive x axis.
+  bool angleLess(size_t v, size_t a, size_t b) const {
+    P2 da = pts[a] - pts[v];
+    P2 db = pts[b] - pts[v];
+    int ha = (da.y > 0.0 || (da.y == 0.0 && da.x > 0.0)) ? 0 : 1;
+    int hb = (db.y > 0.0 || (db.y == 0.0 && db.x > 0.0)) ? 0 : 1;
+    if (ha != hb) {
+      return ha < hb;
+    }
+    double o = orient(v, a, b);
+    if (o != 0.0) {
+      return o > 0.0;
+    }
+    return a < b;
+  }
+
+  struct angle_order {
+    const MonotoneSweep* sweep;
+    size_t v;
+    angle_order(const MonotoneSweep* _sweep, size_t _v)
+        : sweep(_sweep), v(_v) {}
+    bool operator()(size_t a, size_t b) const {
+      return sweep->angleLess(v, a, b);
+    }
+  };
+
+  // the vertices of each monotone piece, anticlockwise.
+  bool tracePieces(std::vector<std::vector<size_t> >& pieces) {
+    const size_t N = pts.size();
+
+    // half edges are numbered: polygon edges first (v -> next[v]),
+    // then both directions of each diagonal.
+    std::vector<std::vector<size_t> > fan(N), fan_edge(N);
+    std::vector<size_t> h_from(N + 2 * diagonals.size());
+    std::vector<size_t> h_to(h_from.size());
+    for (size_t v = 0; v < N; ++v) {
+      h_from[v] = v;
+      h_to[v] = next[v];
+    }
+    for (size_t d = 0; d < diagonals.size(); ++d) {
+      size_t a = diagonals[d].first, b = diagonals[d].second;
+      h_from[N + 2 * d] = h_to[N + 2 * d + 1] = a;
+      h_to[N + 2 * d] = h_from[N + 2 * d + 1] = b;
+    }
+
+    // vertices touched by a diagonal need their neighbours in angular
+    // order; every other vertex simply continues to next[v].
+    for (size_t h = N; h < h_from.size(); ++h) {
+      size_t v = h_from[h];
+      if (fan[v].empty()) {
+        fan[v].push_back(next[v]);
+        fan[v].push_back(prev[v]);
+      }
+      fan[v].push_back(h_to[h]);
+    }
+    for (size_t v = 0; v < N; ++v) {
+      if (fan[v].empty()) {
+        continue;
+      }
+      std::sort(fan[v].begin(), fan[v].end(), angle_order(this, v));
+    }
+    for (size_t v = 0; v < N; ++v) {
+      fan_edge[v].assign(fan[v].size(), NONE);
+      for (size_t i = 0; i < fan[v].size(); ++i) {
+        if (fan[v][i] == next[v]) {
+          fan_edge[v][i] = v;
+        }
+      }
+    }
+    for (size_t h = N; h < h_from.size(); ++h) {
+      size_t v = h_from[h];
+      size_t i = std::find(fan[v].begin(), fan[v].end(), h_to[h]) -
+                 fan[v].begin();
+      if (fan_edge[v][i] != NONE) {
+        // a diagonal duplicating an existing edge.
+        return false;
+      }
+      fan_edge[v][i] = h;
+    }
+
+    std::vector<bool> used(h_from.size(), false);
+    for (size_t start = 0; start < h_from.size(); ++start) {
+      if (used[start]) {
+        continue;
+      }
+      pieces.push_back(std::vector<size_t>());
+      std::vector<size_t>& piece = pieces.back();
+      size_t h = start;
+      do {
+        if (used[h]) {
+          return false;
+        }
+        used[h] = true;
+        piece.push_back(h_from[h]);
+
+        size_t u = h_from[h], v = h_to[h];
+        if (fan[v].empty()) {
+          h = v;
+        } else {
+          // the next edge of the piece is the one immediately
+          // clockwise of the edge back to u.
+          size_t i = std::find(fan[v].begin(), fan[v].end(), u) -
+                     fan[v].begin();
+          i = (i + fan[v].size() - 1) % fan[v].size();
+          if ((h = fan_edge[v][i]) == NONE) {
+            return false;
+          }
+        }
+      } while (h != start);
+
+      if (piece.size() < 3) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool triangulatePiece(const std::vector<size_t>& piece,
+                        std::vector<tri_idx>& result) {
+    const size_t K = piece.size();
+    size_t top = 0, bot = 0;
+    for (size_t i = 1; i < K; ++i) {
+      if (above(piece[i], piece[top])) {
+        top = i;
+      }
+      if (above(piece[bot], piece[i])) {
+        bot = i;
+      }
+    }
+
+    // walking anticlockwise from the top, the left chain descends to
+    // the bottom, and the right chain climbs back to the top.
+    left.clear();
+    right.clear();
+    for (size_t i = top; i != bot; i = (i + 1) % K) {
+      size_t j = (i + 1) % K;
+      if (!above(piece[i], piece[j])) {
+        return false;
+      }
+      if (j != bot) {
+        left.push_back(piece[j]);
+        chain[piece[j]] = LEFT_CHAIN;
+      }
+    }
+    for (size_t i = bot; i != top; i = (i + 1) % K) {
+      size_t j = (i + 1) % K;
+      if (!above(piece[j], piece[i])) {
+        return false;
+      }
+      if (j != top) {
+        right.push_back(piece[j]);
+        chain[piece[j]] = RIGHT_CHAIN;
+      }
+    }
+
+    std::vector<size_t>& u = merged;
+    u.clear();
+    u.push_back(piece[top]);
+    std::merge(left.begin(), left.end(), right.rbegin(), right.rend(),
+               std::back_inserter(u), sweep_order(this));
+    u.push_back(piece[bot]);
+
+    stack.clear();
+    stack.push_back(u[0]);
+    stack.push_back(u[1]);
+
+    for (size_t j = 2; j < K - 1; ++j) {
+      size_t uj = u[j];
+      if (chain[uj] != chain[stack.back()]) {
+        for (size_t i = 0; i + 1 < stack.size(); ++i) {
+          if (chain[uj] == LEFT_CHAIN) {
+            result.push_back(tri_idx(uj, stack[i + 1], stack[i]));
+          } else {
+            result.push_back(tri_idx(uj, stack[i], stack[i + 1]));
+          }
+        }
+        stack.clear();
+        stack.push_back(u[j - 1]);
+        stack.push_back(uj);
+      } else {
+        size_t last = stack.back();
+        stack.pop_back();
+        while (!stack.empty()) {
+          size_t s = stack.back();
+          if (chain[uj] == LEFT_CHAIN) {
+            if (orient(s, last, uj) <= 0.0) {
+              break;
+            }
+            result.push_back(tri_idx(s, last, uj));
+          } else {
+            if (orient(uj, last, s) <= 0.0) {
+              break;
+            }
+            result.push_back(tri_idx(uj, last, s));
+          }
+          last = s;
+          stack.pop_back();
+        }
+        stack.push_back(last);
+        stack.push_back(uj);
+      }
+    }
+
+    size_t un = u[K - 1];
+    for (size_t i = 0; i + 1 < stack.size(); ++i) {
+      if (chain[stack.back()] == LEFT_CHAIN) {
+        result.push_back(tri_idx(un, stack[i], stack[i + 1]));
+      } else {
+        result.push_back(tri_idx(un, stack[i + 1], stack[i]));
+      }
+    }
+    return true;
+  }
+
+  // appends a loop to pts. the outline must run anticlockwise, and
+  // holes clockwise.
+  void addLoop(const std::vector<P2>& loop, bool outline) {
+    const size_t base = pts.size(), n = loop.size();
+    pts.insert(pts.end(), loop.begin(), loop.end());
+    loop_base.push_back(base);
+
+    // carve::geom2d::signedArea() is negative for anticlockwise loops.
+    bool flip = (carve::geom2d::signedArea(loop) > 0.0) == outline;
+    if (outline) {
+      reversed = flip;
+    }
+    for (size_t j = 0; j < n; ++j) {
+      size_t p = base + (j + n - 1) % n, q = base + (j + 1) % n;
+      prev[base + j] = flip ? q : p;
+      next[base + j] = flip ? p : q;
+    }
+  }
+
+  // flattens the given loops of poly; the first is the outline and the
+  // rest are holes.
+  bool load(const std::vector<std::vector<P2> >& poly,
+            const std::vector<size_t>& loops) {
+    size_t N = 0;
+    for (size_t i = 0; i < loops.size(); ++i) {
+      if (poly[loops[i]].size() < 3) {
+        return false;
+      }
+      N += poly[loops[i]].size();
+    }
+
+    reset();
+    pts.reserve(N);
+    prev.resize(N);
+    next.resize(N);
+    loop_id = loops;
+    loop_base.clear();
+
+    for (size_t i = 0; i < loops.size(); ++i) {
+      addLoop(poly[loops[i]], i == 0);
+    }
+    return true;
+  }
+
+  // checks that result triangulates the n_loops loops in pts, and
+  // restores the orientation of the input.
+  bool finish(std::vector<tri_idx>& result, size_t n_loops) const {
+    const size_t N = pts.size();
+    if (result.size() != N + 2 * n_loops - 4) {
+      return false;
+    }
+
+    // the triangles must exactly cover the polygon. overlapping or
+    // inverted triangles indicate that the input was not simple.
+    double poly_area = 0.0, tri_area = 0.0, abs_area = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+      poly_area += pts[i].x * pts[next[i]].y - pts[next[i]].x * pts[i].y;
+    }
+    for (size_t i = 0; i < result.size(); ++i) {
+      const P2& a = pts[result[i].a];
+      const P2& b = pts[result[i].b];
+      const P2& c = pts[result[i].c];
+      if (orient(result[i].a, result[i].b, result[i].c) < 0.0) {
+        return false;
+      }
+      tri_area += (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+    for (size_t i = 0; i < N; ++i) {
+      abs_area += fabs(pts[i].x * pts[next[i]].y) +
+                  fabs(pts[next[i]].x * pts[i].y);
+    }
+    if (fabs(poly_area - tri_area) > abs_area * 1e-10) {
+      return false;
+    }
+
+    if (reversed) {
+      for (size_t i = 0; i < result.size(); ++i) {
+        std::swap(result[i].b, result[i].c);
+      }
+    }
+    return true;
+  }
+
+  // the (loop, index) pair that vertex v came from.
+  std::pair<size_t, size_t> source(size_t v) const {
+    size_t i =
+        std::upper_bound(loop_base.begin(), loop_base.end(), v) -
+        loop_base.begin() - 1;
+    return std::make_pair(loop_id[i], v - loop_base[i]);
+  }
+
+ public:
+  MonotoneSweep() : status(edge_order(this)), probe(NONE), reversed(false) {}
+
+  // returns false if the input is degenerate in a way that the sweep
+  // cannot handle (spikes, touching loops, or self intersections).
+  bool run(const std::vector<std::vector<P2> >& poly,
+           std::vector<tri_idx>& result) {
+    std::vector<size_t> loops(poly.size());
+    for (size_t i = 0; i < loops.size(); ++i) {
+      loops[i] = i;
+    }
+    if (!load(poly, loops) || !classify() || !decompose()) {
+      return false;
+    }
+    const size_t N = pts.size();
+
+    std::vector<std::vector<size_t> > pieces;
+    if (!tracePieces(pieces)) {
+      return false;
+    }
+
+    result.clear();
+    result.reserve(N + 2 * poly.size() - 4);
+
+    chain.assign(N, LEFT_CHAIN);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+      if (!triangulatePiece(pieces[i], result)) {
+        return false;
+      }
+    }
+
+    return finish(result, poly.size());
+  }
+
+  // triangulates a single loop without decomposing it, in linear
+  // time. returns false if the loop is not y-monotone, or not simple.
+  bool runMonotone(const std::vector<P2>& poly, std::vector<tri_idx>& result) {
+    const size_t N = poly.size();
+    reset();
+    pts.reserve(N);
+    prev.resize(N);
+    next.resize(N);
+    loop_id.assign(1, 0);
+    addLoop(poly, true);
+
+    outline.resize(N);
+    outline[0] = 0;
+    for (size_t i = 1; i < N; ++i) {
+      outline[i] = next[outline[i - 1]];
+    }
+
+    result.clear();
+    result.reserve(N - 2);
+
+    chain.assign(N, LEFT_CHAIN);
+    if (!triangulatePiece(outline, result)) {
+      return false;
+    }
+    return finish(result, 1);
+  }
+
+  // The topmost vertex of each hole is a split vertex, and the
+  // diagonal added there joins it to a vertex that it can see without
+  // crossing any loop. Bridges are returned in sweep order, so each
+  // one attaches to the outline or to a hole bridged earlier.
+  bool bridge(const std::vector<std::vector<P2> >& poly, size_t poly_loop,
+              const std::vector<size_t>& hole_loops,
+              std::vector<std::pair<size_t, size_t> >& hole_vert,
+              std::vector<std::pair<size_t, size_t> >& attach_vert) {
+    std::vector<size_t> loops;
+    loops.reserve(hole_loops.size() + 1);
+    loops.push_back(poly_loop);
+    loops.insert(loops.end(), hole_loops.begin(), hole_loops.end());
+    if (!load(poly, loops) || !classify() || !decompose()) {
+      return false;
+    }
+
+    std::vector<size_t> tops;
+    tops.reserve(hole_loops.size());
+    for (size_t i = 1; i < loops.size(); ++i) {
+      size_t top = loop_base[i];
+      for (size_t j = 1; j < poly[loops[i]].size(); ++j) {
+        if (above(loop_base[i] + j, top)) {
+          top = loop_base[i] + j;
+        }
+      }
+      if (split_partner[top] == NONE) {
+        return false;
+      }
+      tops.push_back(top);
+    }
+    std::sort(tops.begin(), tops.end(), sweep_order(this));
+
+    hole_vert.clear();
+    attach_vert.clear();
+    for (size_t i = 0; i < tops.size(); ++i) {
+      hole_vert.push_back(source(tops[i]));
+      attach_vert.push_back(source(split_partner[tops[i]]));
+    }
+    return true;
+  }
+};
+
+bool fastTriangulate(const std::vector<carve::geom2d::P2>& poly,
+                     std::vector<carve::triangulate::tri_idx>& result,
+                     MonotoneSweep& sweep);
+
+}  // namespace detail
+}  // namespace triangulate
+}  // namespace carve
@@ -65,6 +65,14 @@ struct Options : public opt::Parser {
   bool glu_triangulate;
 #endif
   bool improve;
+  bool sweep;
+  bool spatial_sort;
+  bool weld;
+  bool grid;
+  bool exact;
+  bool snap;
+  bool implicit;
+  bool triangles;
   carve::csg::CSG::CLASSIFY_TYPE classifier;
 
   std::string stream;
@@ -123,6 +131,38 @@ struct Options : public opt::Parser {
       improve = true;
       return;
     }
+    if (o == "--sweep" || o == "-m") {
+      sweep = true;
+      return;
+    }
+    if (o == "--spatial-sort" || o == "-s") {
+      spatial_sort = true;
+      return;
+    }
+    if (o == "--weld" || o == "-w") {
+      weld = true;
+      return;
+    }
+    if (o == "--grid" || o == "-G") {
+      grid = true;
+      return;
+    }
+    if (o == "--exact" || o == "-x") {
+      exact = true;
+      return;
+    }
+    if (o == "--snap" || o == "-S") {
+      snap = true;
+      return;
+    }
+    if (o == "--implicit" || o == "-I") {
+      implicit = true;
+      return;
+    }
+    if (o == "--triangles" || o == "-T") {
+      triangles = true;
+      return;
+    }
     if (o == "--edge" || o == "-e") {
       classifier = carve::csg::CSG::CLASSIFY_EDGE;
       return;
@@ -237,6 +277,14 @@ struct Options : public opt::Parser {
     glu_triangulate = false;
 #endif
     improve = false;
+    sweep = false;
+    spatial_sort = false;
+    weld = false;
+    grid = false;
+    exact = false;
+    snap = false;
+    implicit = false;
+    triangles = false;
     classifier = carve::csg::CSG::CLASSIFY_NORMAL;
 
     option("canonicalize", 'c', false,
@@ -253,6 +301,25 @@ struct Options : public opt::Parser {
 #endif
     option("improve", 'i', false,
            "Improve triangulation by minimising internal edge lengths.");
+    option("sweep", 'm', false,
+           "Triangulate by monotone decomposition rather than ear "
+           "clipping.");
+    option("spatial-sort", 's', false,
+           "Reorder input vertices and faces along a Morton curve.");
+    option("weld", 'w', false, "Weld coincident intersection vertices.");
+    option("grid", 'G', false,
+           "Use a uniform grid to find intersecting face pairs.");
+    option("exact", 'x', false,
+           "Use filtered exact predicates, and report how often the "
+           "filter falls back to exact arithmetic.");
+    option("snap", 'S', false,
+           "Rescale and snap to an integer grid, with exact integer "
+           "predicates.");
+    option("implicit", 'I', false,
+           "Hold intersection vertices implicitly, and order them along "
+           "edges exactly.");
+    option("triangles", 'T', false,
+           "Split triangular input faces directly into triangles.");
     option("edge", 'e', false, "Use edge classifier.");
     option("epsilon", 'E', true, "Set epsilon used for calculations.");
     option("file", 'f', true, "Read CSG expression from file.");
@@ -518,6 +585,12 @@ carve::csg::CSG_TreeNode* parseAtom(TOK& tok) {
       return nullptr;
     }
 
+    if (options.spatial_sort) {
+      static carve::TimingName FUNC_NAME("reorderSpatially()");
+      carve::TimingBlock block(FUNC_NAME);
+      poly->reorderSpatially();
+    }
+
     std::cerr << "loaded polyhedron " << poly << " has " << poly->meshes.size()
               << " manifolds ("
               << std::count_if(poly->meshes.begin(), poly->meshes.end(),
@@ -790,7 +863,7 @@ carve::csg::CSG_TreeNode* parseExpr(TOK& tok) {
       return nullptr;
     }
     lhs = new carve::csg::CSG_OPNode(lhs, rhs, op, options.rescale,
-                                     options.classifier);
+                                     options.classifier, options.snap);
   }
   return lhs;
 }
@@ -832,6 +905,16 @@ int main(int argc, char** argv) {
 
     try {
       carve::csg::CSG csg;
+      csg.weld_intersections = options.weld;
+      csg.implicit_intersections = options.implicit;
+      csg.triangulate_face_loops = options.triangles;
+      if (options.grid) {
+        csg.broadphase = carve::csg::CSG::BROADPHASE_GRID;
+      }
+      if (options.exact) {
+        csg.predicate_mode = carve::PREDICATES_FILTERED;
+        carve::predicate_stats.enabled = true;
+      }
 
       if (options.triangulate) {
 #if !defined(DISABLE_GLU_TRIANGULATOR)
@@ -846,13 +929,16 @@ int main(int argc, char** argv) {
           }
         } else {
 #endif
+          carve::triangulate::TriangulationMethod method =
+              options.sweep ? carve::triangulate::MONOTONE_SWEEP
+                            : carve::triangulate::EAR_CLIPPING;
           if (options.improve) {
             csg.hooks.registerHook(
-                new carve::csg::CarveTriangulatorWithImprovement,
+                new carve::csg::CarveTriangulatorWithImprovement(method),
                 carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_BIT);
           } else {
             csg.hooks.registerHook(
-                new carve::csg::CarveTriangulator,
+                new carve::csg::CarveTriangulator(method),
                 carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_BIT);
           }
 #if !defined(DISABLE_GLU_TRIANGULATOR)
@@ -869,6 +955,13 @@ int main(int argc, char** argv) {
     }
     duration = carve::Timing::stop();
     std::cerr << "Eval time " << duration << " seconds" << std::endl;
+    if (options.exact) {
+      const carve::predicate_stats_t& s = carve::predicate_stats;
+      std::cerr << "orient2d: " << s.orient2d_calls << " calls, "
+                << s.orient2d_exact << " exact" << std::endl;
+      std::cerr << "orient3d: " << s.orient3d_calls << " calls, "
+                << s.orient3d_exact << " exact" << std::endl;
+    }
 
     carve::Timing::start(WRITE_BLOCK);
     if (result) {
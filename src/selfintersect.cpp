@@ -31,6 +31,7 @@
 #include <carve/geom3d.hpp>
 #include <carve/mesh.hpp>
 #include <carve/poly.hpp>
+#include <carve/predicates.hpp>
 #include <carve/rtree.hpp>
 #include <carve/triangle_intersection.hpp>
 
@@ -577,14 +578,11 @@ int orient3d_inexact(const vec3& a, const vec3& b, const vec3& c,
 
 // returns true if no intersection, based upon normal testing.
 bool sat_normal(const vec3 tri_a[3], const vec3 tri_b[3]) {
-  double v, lo, hi;
-  lo = hi = carve::geom3d::orient3d(tri_a[0], tri_a[1], tri_a[2], tri_b[0]);
-  v = carve::geom3d::orient3d(tri_a[0], tri_a[1], tri_a[2], tri_b[1]);
-  lo = std::min(lo, v);
-  hi = std::max(hi, v);
-  v = carve::geom3d::orient3d(tri_a[0], tri_a[1], tri_a[2], tri_b[2]);
-  lo = std::min(lo, v);
-  hi = std::max(hi, v);
+  double o[3];
+  carve::orient3d_batch(3, tri_a[0].v, 0, tri_a[1].v, 0, tri_a[2].v, 0,
+                        tri_b[0].v, sizeof(vec3) / sizeof(double), o);
+  double lo = std::min(std::min(o[0], o[1]), o[2]);
+  double hi = std::max(std::max(o[0], o[1]), o[2]);
   return lo > 0.0 || hi < 0.0;
 }
 
@@ -712,6 +710,8 @@ int main(int argc, char** argv) {
     tree->search(fa->getAABB(), std::back_inserter(near_faces));
     // std::cerr << "XXX " << near_faces.size() << std::endl;
 
+    std::vector<const carve::mesh::MeshSet<3>::face_t*> cand_faces;
+    carve::geom::triangle_packet packet;
     for (size_t f2 = 0; f2 < near_faces.size(); ++f2) {
       const carve::mesh::MeshSet<3>::face_t* fb = near_faces[f2];
       if (fb->nVertices() != 3) {
@@ -722,13 +722,23 @@ int main(int argc, char** argv) {
         continue;
       }
 
+      cand_faces.push_back(fb);
+      packet.push_back(fb->edge->vert->v, fb->edge->next->vert->v,
+                       fb->edge->next->next->vert->v);
+    }
+
+    std::vector<carve::geom::TriangleIntType> result(packet.size());
+    if (!packet.empty()) {
+      carve::geom::triangle_intersection_exact(tri_a, packet, &result[0]);
+    }
+
+    for (size_t f2 = 0; f2 < cand_faces.size(); ++f2) {
+      const carve::mesh::MeshSet<3>::face_t* fb = cand_faces[f2];
+
       vec3 tri_b[3];
-      tri_b[0] = fb->edge->vert->v;
-      tri_b[1] = fb->edge->next->vert->v;
-      tri_b[2] = fb->edge->next->next->vert->v;
+      packet.get(f2, tri_b);
 
-      if (carve::geom::triangle_intersection_exact(tri_a, tri_b) ==
-          carve::geom::TR_TYPE_INT) {
+      if (result[f2] == carve::geom::TR_TYPE_INT) {
         std::cerr << "intersection: " << fa << " - " << fb << std::endl;
         static int c = 0;
         std::ostringstream fn;
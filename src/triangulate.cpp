@@ -200,13 +200,10 @@ int main(int argc, char** argv) {
     std::vector<carve::mesh::MeshSet<3>::vertex_t*> vloop;
     f->getVertices(vloop);
 
-    carve::triangulate::triangulate(
-        carve::mesh::MeshSet<3>::face_t::projection_mapping(f->project), vloop,
-        result);
+    carve::triangulate::triangulate(f->projector(), vloop, result);
     if (options.improve) {
-      carve::triangulate::improve(
-          carve::mesh::MeshSet<3>::face_t::projection_mapping(f->project),
-          vloop, carve::mesh::vertex_distance(), result);
+      carve::triangulate::improve(f->projector(), vloop,
+                                  carve::mesh::vertex_distance(), result);
     }
 
     for (size_t j = 0; j < result.size(); ++j) {
@@ -0,0 +1,88 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/compact_mesh.hpp>
+#include <carve/input.hpp>
+
+#include "geometry.hpp"
+
+#include <memory>
+
+TEST(CompactMeshTest, RoundTrip) {
+  carve::input::PolyhedronData data;
+  makeSphereData(data, 48, 32);
+  carve::mesh::CompactMeshSet compact(data.points, data.getFaceCount(),
+                                      data.faceIndices);
+
+  ASSERT_EQ(compact.vertexCount(), data.points.size());
+  ASSERT_EQ(compact.faceCount(), (size_t)data.getFaceCount());
+
+  // vertices are rounded to float once.
+  for (size_t i = 0; i < data.points.size(); ++i) {
+    EXPECT_LE(carve::geom::distance(compact.vertex(i), data.points[i]),
+              1e-7);
+  }
+
+  std::unique_ptr<carve::mesh::MeshSet<3> > mesh(compact.toMeshSet());
+  ASSERT_EQ(mesh->meshes.size(), 1U);
+  EXPECT_TRUE(mesh->meshes[0]->isClosed());
+  EXPECT_FALSE(mesh->meshes[0]->isNegative());
+
+  // faces keep their order, and the compact planes agree with the
+  // planes the MeshSet fits.
+  size_t f = 0;
+  for (carve::mesh::MeshSet<3>::face_iter i = mesh->faceBegin();
+       i != mesh->faceEnd(); ++i, ++f) {
+    carve::geom::plane<3> p = compact.facePlane(f);
+    EXPECT_NEAR(carve::geom::distance(p.N, (*i)->plane.N), 0.0, 1e-9);
+    EXPECT_NEAR(p.d, (*i)->plane.d, 1e-9);
+    EXPECT_EQ(compact.faceAABB(f), (*i)->getAABB());
+  }
+  EXPECT_EQ(f, compact.faceCount());
+
+  // converting back is exact.
+  carve::mesh::CompactMeshSet compact2(mesh.get());
+  ASSERT_EQ(compact2.vertexCount(), compact.vertexCount());
+  ASSERT_EQ(compact2.face_start, compact.face_start);
+  for (size_t i = 0; i < compact.faceCount(); ++i) {
+    for (size_t j = 0; j < compact.faceSize(i); ++j) {
+      EXPECT_EQ(compact2.vertex(compact2.faceBegin(i)[j]),
+                compact.vertex(compact.faceBegin(i)[j]));
+    }
+  }
+
+  EXPECT_EQ(compact.getAABB(), mesh->getAABB());
+  size_t mesh_size =
+      sizeof(carve::mesh::Vertex<3>) * compact.vertexCount() +
+      sizeof(carve::mesh::Face<3>) * compact.faceCount() +
+      sizeof(carve::mesh::Edge<3>) * compact.face_verts.size();
+  EXPECT_LT(compact.memoryUsage() * 8, mesh_size);
+}
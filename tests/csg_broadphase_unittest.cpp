@@ -0,0 +1,78 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/csg.hpp>
+#include <carve/input.hpp>
+#include <carve/matrix.hpp>
+
+#include "csg_compare.hpp"
+#include "geometry.hpp"
+
+#include <memory>
+
+static void computeBoth(carve::mesh::MeshSet<3>* a, carve::mesh::MeshSet<3>* b,
+                        carve::csg::CSG::OP op) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > r_grid;
+  compareWithFlag(a, b, op, &carve::csg::CSG::broadphase,
+                  carve::csg::CSG::BROADPHASE_GRID, r_grid);
+}
+
+TEST(CSGBroadphaseTest, GridMatchesRTree) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(48, 24));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(40, 20, false,
+                 carve::math::Matrix::TRANS(0.5, 0.3, 0.2) *
+                     carve::math::Matrix::ROT(0.7, 1.0, 1.0, 0.0)));
+
+  computeBoth(a.get(), b.get(), carve::csg::CSG::UNION);
+  computeBoth(a.get(), b.get(), carve::csg::CSG::INTERSECTION);
+  computeBoth(a.get(), b.get(), carve::csg::CSG::A_MINUS_B);
+}
+
+TEST(CSGBroadphaseTest, GridFallsBackForVariedFaceSizes) {
+  // a coarse sphere against a fine one has too great a spread of
+  // edge lengths for a single cell size; the result must still match.
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(256, 128));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(6, 3, false,
+                 carve::math::Matrix::TRANS(0.6, 0.0, 0.0) *
+                     carve::math::Matrix::SCALE(0.8, 0.8, 0.8)));
+
+  computeBoth(a.get(), b.get(), carve::csg::CSG::UNION);
+}
+
+TEST(CSGBroadphaseTest, DisjointInputs) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(16, 8));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(16, 8, false, carve::math::Matrix::TRANS(3.0, 0.0, 0.0)));
+
+  computeBoth(a.get(), b.get(), carve::csg::CSG::UNION);
+}
@@ -0,0 +1,67 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <carve/carve.hpp>
+#include <carve/csg.hpp>
+
+#include "geometry.hpp"
+
+#include <iterator>
+#include <memory>
+
+// Computes op twice, once with a default CSG object and once with flag
+// set to value, and checks that the two results agree. The second
+// result is returned in result, for further checks by the caller. If
+// reference_hook is given, it is registered as an output face hook of
+// the first CSG object, which takes ownership of it.
+template <typename flag_t>
+static void compareWithFlag(
+    carve::mesh::MeshSet<3>* a, carve::mesh::MeshSet<3>* b,
+    carve::csg::CSG::OP op, flag_t carve::csg::CSG::*flag, flag_t value,
+    std::unique_ptr<carve::mesh::MeshSet<3> >& result,
+    carve::csg::CSG::Hook* reference_hook = nullptr) {
+  carve::csg::CSG csg_ref;
+  if (reference_hook != nullptr) {
+    csg_ref.hooks.registerHook(reference_hook,
+                               carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_BIT);
+  }
+  std::unique_ptr<carve::mesh::MeshSet<3> > r_ref(csg_ref.compute(a, b, op));
+
+  carve::csg::CSG csg_flag;
+  csg_flag.*flag = value;
+  result.reset(csg_flag.compute(a, b, op));
+
+  ASSERT_TRUE(r_ref.get() != nullptr);
+  ASSERT_TRUE(result.get() != nullptr);
+  EXPECT_EQ(r_ref->vertex_storage.size(), result->vertex_storage.size());
+  EXPECT_EQ(r_ref->meshes.size(), result->meshes.size());
+  EXPECT_EQ(std::distance(r_ref->faceBegin(), r_ref->faceEnd()),
+            std::distance(result->faceBegin(), result->faceEnd()));
+  EXPECT_NEAR(volume(r_ref.get()), volume(result.get()), 1e-9);
+}
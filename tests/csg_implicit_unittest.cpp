@@ -0,0 +1,71 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/csg.hpp>
+#include <carve/matrix.hpp>
+
+#include "geometry.hpp"
+
+#include <memory>
+
+TEST(CSGImplicitTest, ImplicitMatchesRounded) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(48, 24));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(40, 20, false,
+                 carve::math::Matrix::TRANS(0.5, 0.3, 0.2) *
+                     carve::math::Matrix::ROT(0.7, 1.0, 1.0, 0.0)));
+
+  carve::csg::CSG::OP ops[3] = {carve::csg::CSG::UNION,
+                                carve::csg::CSG::INTERSECTION,
+                                carve::csg::CSG::A_MINUS_B};
+
+  for (int op = 0; op < 3; ++op) {
+    carve::csg::CSG csg_rounded;
+    std::unique_ptr<carve::mesh::MeshSet<3> > rounded(
+        csg_rounded.compute(a.get(), b.get(), ops[op]));
+
+    carve::csg::CSG csg_implicit;
+    csg_implicit.implicit_intersections = true;
+    std::unique_ptr<carve::mesh::MeshSet<3> > implicit(
+        csg_implicit.compute(a.get(), b.get(), ops[op]));
+
+    ASSERT_TRUE(rounded.get() != nullptr);
+    ASSERT_TRUE(implicit.get() != nullptr);
+    EXPECT_EQ(rounded->vertex_storage.size(), implicit->vertex_storage.size());
+    EXPECT_EQ(rounded->meshes.size(), implicit->meshes.size());
+    EXPECT_EQ(std::distance(rounded->faceBegin(), rounded->faceEnd()),
+              std::distance(implicit->faceBegin(), implicit->faceEnd()));
+    for (size_t i = 0; i < implicit->meshes.size(); ++i) {
+      EXPECT_TRUE(implicit->meshes[i]->isClosed());
+    }
+    EXPECT_NEAR(volume(rounded.get()), volume(implicit.get()), 1e-9);
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/csg.hpp>
+#include <carve/matrix.hpp>
+#include <carve/tree.hpp>
+
+#include "geometry.hpp"
+
+#include <memory>
+
+static carve::mesh::MeshSet<3>* evalOp(carve::csg::CSG& csg,
+                                       carve::mesh::MeshSet<3>* a,
+                                       carve::mesh::MeshSet<3>* b,
+                                       carve::csg::CSG::OP op, bool snap) {
+  carve::csg::CSG_OPNode node(new carve::csg::CSG_PolyNode(a, false),
+                              new carve::csg::CSG_PolyNode(b, false), op, true,
+                              carve::csg::CSG::CLASSIFY_NORMAL, snap);
+  return static_cast<carve::csg::CSG_TreeNode&>(node).eval(csg);
+}
+
+TEST(CSGTreeTest, SnappedOpMatchesRescaled) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(32, 16));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(24, 12, false,
+                 carve::math::Matrix::TRANS(0.5, 0.3, 0.2) *
+                     carve::math::Matrix::ROT(0.7, 1.0, 1.0, 0.0)));
+
+  carve::csg::CSG::OP ops[3] = {carve::csg::CSG::UNION,
+                                carve::csg::CSG::INTERSECTION,
+                                carve::csg::CSG::A_MINUS_B};
+
+  for (int op = 0; op < 3; ++op) {
+    carve::csg::CSG csg;
+    csg.predicate_mode = carve::PREDICATES_FAST;
+
+    std::unique_ptr<carve::mesh::MeshSet<3> > scaled(
+        evalOp(csg, a.get(), b.get(), ops[op], false));
+    std::unique_ptr<carve::mesh::MeshSet<3> > snapped(
+        evalOp(csg, a.get(), b.get(), ops[op], true));
+
+    // the snapped evaluation ran with integer predicates, and put back
+    // the mode it found.
+    EXPECT_EQ(carve::PREDICATES_FAST, csg.predicate_mode);
+
+    ASSERT_TRUE(scaled.get() != nullptr);
+    ASSERT_TRUE(snapped.get() != nullptr);
+    EXPECT_EQ(scaled->meshes.size(), snapped->meshes.size());
+    EXPECT_EQ(scaled->vertex_storage.size(), snapped->vertex_storage.size());
+    for (size_t i = 0; i < snapped->meshes.size(); ++i) {
+      EXPECT_TRUE(snapped->meshes[i]->isClosed());
+    }
+    // vertices move by at most a grid step, so volume barely changes.
+    EXPECT_NEAR(volume(scaled.get()), volume(snapped.get()), 1e-9);
+  }
+}
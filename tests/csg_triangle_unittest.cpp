@@ -0,0 +1,86 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/csg.hpp>
+#include <carve/csg_triangulator.hpp>
+#include <carve/input.hpp>
+#include <carve/matrix.hpp>
+
+#include "csg_compare.hpp"
+#include "geometry.hpp"
+
+#include <memory>
+
+// Computes op with triangulated face loops, and checks the result
+// against the general pipeline followed by a triangulating hook.
+static void computeBoth(carve::mesh::MeshSet<3>* a, carve::mesh::MeshSet<3>* b,
+                        carve::csg::CSG::OP op) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > r_fast;
+  ASSERT_NO_FATAL_FAILURE(
+      compareWithFlag(a, b, op, &carve::csg::CSG::triangulate_face_loops, true,
+                      r_fast, new carve::csg::CarveTriangulator));
+
+  for (carve::mesh::MeshSet<3>::face_iter i = r_fast->faceBegin();
+       i != r_fast->faceEnd(); ++i) {
+    EXPECT_EQ(3U, (*i)->nVertices());
+  }
+  for (size_t i = 0; i < r_fast->meshes.size(); ++i) {
+    EXPECT_TRUE(r_fast->meshes[i]->isClosed());
+  }
+}
+
+TEST(CSGTriangleTest, MatchesTriangulatingHook) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(48, 24, true));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(40, 20, true,
+                 carve::math::Matrix::TRANS(0.5, 0.3, 0.2) *
+                     carve::math::Matrix::ROT(0.7, 1.0, 1.0, 0.0)));
+
+  computeBoth(a.get(), b.get(), carve::csg::CSG::UNION);
+  computeBoth(a.get(), b.get(), carve::csg::CSG::INTERSECTION);
+  computeBoth(a.get(), b.get(), carve::csg::CSG::A_MINUS_B);
+}
+
+TEST(CSGTriangleTest, FacesWithHoles) {
+  // a small sphere centred on a face of a coarse one cuts a hole in
+  // that face, which must be triangulated around.
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeSphere(6, 3, true));
+  carve::mesh::MeshSet<3>::face_t* face = a->meshes[0]->faces[1];
+  ASSERT_EQ(3U, face->nVertices());
+  carve::geom::vector<3> c = face->centroid();
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeSphere(12, 6, true,
+                 carve::math::Matrix::TRANS(c.x, c.y, c.z) *
+                     carve::math::Matrix::SCALE(0.05, 0.05, 0.05)));
+
+  computeBoth(a.get(), b.get(), carve::csg::CSG::UNION);
+  computeBoth(a.get(), b.get(), carve::csg::CSG::A_MINUS_B);
+}
@@ -0,0 +1,131 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/csg.hpp>
+#include <carve/input.hpp>
+#include <carve/matrix.hpp>
+
+#include "geometry.hpp"
+
+#include <memory>
+#include <set>
+
+// two cubes that touch along the plane x=1, held as separate
+// meshes with their own copies of the shared vertices.
+static carve::mesh::MeshSet<3>* makeTouchingCubes() {
+  static const int faces[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                                  {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  carve::input::PolyhedronData data;
+  for (int c = 0; c < 2; ++c) {
+    int base = (int)data.getVertexCount();
+    for (int i = 0; i < 8; ++i) {
+      data.addVertex(carve::geom::VECTOR(c * 2.0 + ((i & 1) ? 1.0 : -1.0),
+                                         (i & 2) ? 1.0 : -1.0,
+                                         (i & 4) ? 1.0 : -1.0));
+    }
+    for (int j = 0; j < 6; ++j) {
+      data.addFace(base + faces[j][0], base + faces[j][1], base + faces[j][2],
+                   base + faces[j][3]);
+    }
+  }
+  return data.createMesh(carve::input::opts());
+}
+
+static carve::mesh::MeshSet<3>* makeBox(const carve::geom3d::Vector& lo,
+                                        const carve::geom3d::Vector& hi) {
+  static const int faces[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                                  {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  carve::input::PolyhedronData data;
+  for (int i = 0; i < 8; ++i) {
+    data.addVertex(carve::geom::VECTOR((i & 1) ? hi.x : lo.x,
+                                       (i & 2) ? hi.y : lo.y,
+                                       (i & 4) ? hi.z : lo.z));
+  }
+  for (int j = 0; j < 6; ++j) {
+    data.addFace(faces[j][0], faces[j][1], faces[j][2], faces[j][3]);
+  }
+  return data.createMesh(carve::input::opts());
+}
+
+static bool closed(const carve::mesh::MeshSet<3>* m) {
+  for (size_t i = 0; i < m->meshes.size(); ++i) {
+    if (!m->meshes[i]->isClosed()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static size_t countPositions(const carve::mesh::MeshSet<3>* m) {
+  std::set<carve::geom3d::Vector> pos;
+  for (size_t i = 0; i < m->vertex_storage.size(); ++i) {
+    pos.insert(m->vertex_storage[i].v);
+  }
+  return pos.size();
+}
+
+TEST(CSGWeldTest, CoincidentIntersectionsAreWelded) {
+  // each edge of b that crosses x=1 cuts a face of both cubes at the
+  // same point, giving two intersection vertices in the same place.
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(makeTouchingCubes());
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeBox(carve::geom::VECTOR(0.5, -0.2, -1.7),
+              carve::geom::VECTOR(1.5, 0.8, 2.3)));
+
+  carve::csg::CSG::OP ops[3] = {carve::csg::CSG::UNION,
+                                carve::csg::CSG::INTERSECTION,
+                                carve::csg::CSG::A_MINUS_B};
+  double expected_volume[3] = {18.0, 2.0, 14.0};
+
+  for (int op = 0; op < 3; ++op) {
+    carve::csg::CSG csg_plain;
+    std::unique_ptr<carve::mesh::MeshSet<3> > plain(
+        csg_plain.compute(a.get(), b.get(), ops[op]));
+
+    carve::csg::CSG csg_weld;
+    csg_weld.weld_intersections = true;
+    std::unique_ptr<carve::mesh::MeshSet<3> > welded(
+        csg_weld.compute(a.get(), b.get(), ops[op]));
+
+    ASSERT_TRUE(plain.get() != nullptr);
+    ASSERT_TRUE(welded.get() != nullptr);
+
+    // the four crossings on x=1 collapse to one vertex each, without
+    // losing any distinct position.
+    EXPECT_EQ(plain->vertex_storage.size(),
+              welded->vertex_storage.size() + 4);
+    EXPECT_EQ(countPositions(plain.get()), countPositions(welded.get()));
+
+    EXPECT_TRUE(closed(welded.get()));
+    EXPECT_NEAR(expected_volume[op], volume(plain.get()), 1e-9);
+    EXPECT_NEAR(expected_volume[op], volume(welded.get()), 1e-9);
+  }
+}
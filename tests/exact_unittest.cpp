@@ -30,6 +30,12 @@
 
 #include <carve/carve.hpp>
 #include <carve/exact.hpp>
+#include <carve/shewchuk_predicates.hpp>
+#include <carve/small_vector.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
 
 using namespace carve::exact;
 
@@ -161,3 +167,98 @@ TEST(ExactTest, SumZeroelim) {
   //                result);
   //   std::cerr << result << std::endl;
 }
+
+TEST(ExactTest, SmallVector) {
+  carve::small_vector<double, 4> v;
+  EXPECT_TRUE(v.isInline());
+  for (int i = 0; i < 4; ++i) {
+    v.push_back(i);
+  }
+  EXPECT_TRUE(v.isInline());
+  v.push_back(4);
+  EXPECT_FALSE(v.isInline());
+  EXPECT_EQ(v.size(), 5U);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(v[i], (double)i);
+  }
+
+  carve::small_vector<double, 4> w(v);
+  EXPECT_EQ(v, w);
+  w.erase(w.begin() + 1, w.begin() + 3);
+  EXPECT_EQ(w.size(), 3U);
+  EXPECT_EQ(w[0], 0.0);
+  EXPECT_EQ(w[1], 3.0);
+  EXPECT_EQ(w[2], 4.0);
+
+  carve::small_vector<double, 4> x(std::move(v));
+  EXPECT_EQ(x.size(), 5U);
+  EXPECT_TRUE(v.empty());
+}
+
+TEST(ExactTest, SmallExact) {
+  double a = 4, b = 3, c = 1e60;
+
+  EXPECT_EQ((detail::add<1, 1, small_exact_t>(&a, &b)),
+            small_exact_t(0.0, 7.0));
+  EXPECT_EQ((detail::sub<2, 1>(detail::sub<1, 1, small_exact_t>(&c, &a), &a)),
+            small_exact_t(0.0, -8.0, 1e60));
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for (int i = 0; i < 10000; ++i) {
+    double p[4][3];
+    for (int j = 0; j < 4; ++j) {
+      for (int k = 0; k < 3; ++k) {
+        p[j][k] = dist(rng);
+      }
+    }
+    if (i & 1) {
+      // make the points (nearly) coplanar.
+      for (int k = 0; k < 3; ++k) {
+        p[3][k] = p[0][k] + (p[1][k] - p[0][k]) * 0.25 +
+                  (p[2][k] - p[0][k]) * 0.5;
+      }
+    }
+    double r0 = orient3dexact<exact_t>(p[0], p[1], p[2], p[3]);
+    double r1 = orient3dexact<small_exact_t>(p[0], p[1], p[2], p[3]);
+    double r2 = shewchuk::orient3dexact(p[0], p[1], p[2], p[3]);
+    EXPECT_EQ(r0, r1);
+    EXPECT_EQ((r1 > 0) - (r1 < 0), (r2 > 0) - (r2 < 0));
+  }
+}
+
+// Benchmark of orient3dexact with heap backed (exact_t) against small
+// buffer (small_exact_t) expansions. Disabled by default; run with
+// --gtest_also_run_disabled_tests --gtest_filter=*SmallExactTiming.
+TEST(ExactTest, DISABLED_SmallExactTiming) {
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  const int N = 200000;
+  std::vector<double> pts(N * 12);
+  for (size_t i = 0; i < pts.size(); ++i) {
+    pts[i] = dist(rng);
+  }
+
+  typedef std::chrono::steady_clock bench_clock;
+  double s0 = 0.0, s1 = 0.0;
+  bench_clock::time_point t0 = bench_clock::now();
+  for (int i = 0; i < N; ++i) {
+    const double* p = &pts[i * 12];
+    s0 += orient3dexact<exact_t>(p, p + 3, p + 6, p + 9);
+  }
+  bench_clock::time_point t1 = bench_clock::now();
+  for (int i = 0; i < N; ++i) {
+    const double* p = &pts[i * 12];
+    s1 += orient3dexact<small_exact_t>(p, p + 3, p + 6, p + 9);
+  }
+  bench_clock::time_point t2 = bench_clock::now();
+
+  EXPECT_EQ(s0, s1);
+  std::cerr << "orient3dexact x" << N << ": exact_t "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count()
+            << "ms, small_exact_t "
+            << std::chrono::duration<double, std::milli>(t2 - t1).count()
+            << "ms" << std::endl;
+}
@@ -187,3 +187,87 @@ TEST(GeomTest, Geom2D) {
               VECTOR(1120.40699999999992542143, 213543.469000000011874363))),
       false);
 }
+
+static int sign(double d) { return (d > 0.0) - (d < 0.0); }
+
+TEST(GeomTest, FilteredOrient2D) {
+  // points near the line y = x, a few ulps apart, where the plain
+  // floating point determinant often has the wrong sign.
+  const P2 q = VECTOR(12.0, 12.0);
+  const P2 r = VECTOR(24.0, 24.0);
+  const double u = ldexp(1.0, -53);
+
+  carve::PredicateMode saved = carve::predicate_mode;
+  carve::predicate_stats.reset();
+  carve::predicate_stats.enabled = true;
+
+  int fast_wrong = 0;
+  for (int x = 0; x < 64; ++x) {
+    for (int y = 0; y < 64; ++y) {
+      P2 p = VECTOR(0.5 + x * u, 0.5 + y * u);
+      int expected = sign(shewchuk::orient2dexact(p.v, q.v, r.v));
+
+      carve::setPredicateMode(carve::PREDICATES_FAST);
+      fast_wrong += sign(orient2d(p, q, r)) != expected;
+
+      carve::setPredicateMode(carve::PREDICATES_FILTERED);
+      EXPECT_EQ(expected, sign(orient2d(p, q, r)));
+    }
+  }
+
+  carve::predicate_stats.enabled = false;
+  carve::setPredicateMode(saved);
+
+  EXPECT_GT(fast_wrong, 0);
+  EXPECT_EQ(64U * 64U, carve::predicate_stats.orient2d_calls);
+  EXPECT_GT(carve::predicate_stats.orient2d_exact, 0U);
+}
+
+TEST(GeomTest, BatchedOrient2D) {
+  const P2 q = VECTOR(12.0, 12.0);
+  const P2 r = VECTOR(24.0, 24.0);
+  const double u = ldexp(1.0, -53);
+
+  std::vector<P2> p;
+  for (int x = 0; x < 16; ++x) {
+    for (int y = 0; y < 15; ++y) {
+      p.push_back(VECTOR(0.5 + x * u, 0.5 + y * u));
+    }
+  }
+
+  std::vector<double> out(p.size());
+  carve::orient2d_batch(p.size(), p[0].v, 2, q.v, 0, r.v, 0, &out[0]);
+  for (size_t i = 0; i < p.size(); ++i) {
+    EXPECT_EQ(sign(shewchuk::orient2dexact(p[i].v, q.v, r.v)), sign(out[i]));
+  }
+}
+
+TEST(GeomTest, BatchedOrient2DVectorMatchesScalar) {
+  if (!carve::detail::batch_avx2_supported()) {
+    GTEST_SKIP();
+  }
+  const P2 q = VECTOR(12.0, 12.0);
+  const P2 r = VECTOR(24.0, 24.0);
+  const double u = ldexp(1.0, -53);
+
+  // near-degenerate points, some of which fail the filter, in a batch
+  // whose length is not a multiple of the vector width.
+  std::vector<P2> p;
+  for (int x = 0; x < 16; ++x) {
+    for (int y = 0; y < 15; ++y) {
+      p.push_back(VECTOR(0.5 + x * u, 0.5 + y * u));
+    }
+  }
+  p.push_back(VECTOR(0.0, 1.0));
+
+  std::vector<double> vec(p.size()), sca(p.size());
+  size_t n_vec = carve::detail::orient2d_batch_avx2(p.size(), p[0].v, 2, q.v,
+                                                    0, r.v, 0, &vec[0]);
+  size_t n_sca = carve::detail::orient2d_batch_scalar(p.size(), p[0].v, 2,
+                                                      q.v, 0, r.v, 0, &sca[0]);
+  EXPECT_EQ(n_sca, n_vec);
+  EXPECT_GT(n_vec, 0U);
+  for (size_t i = 0; i < p.size(); ++i) {
+    EXPECT_EQ(sca[i], vec[i]);
+  }
+}
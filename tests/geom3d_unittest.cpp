@@ -28,16 +28,21 @@
 #include <carve_config.h>
 #endif
 
+#include <carve/aabb.hpp>
 #include <carve/carve.hpp>
 #include <carve/geom.hpp>
 #include <carve/geom2d.hpp>
 #include <carve/geom3d.hpp>
+#include <carve/implicit_point.hpp>
 #include <carve/matrix.hpp>
+#include <carve/morton.hpp>
+#include <carve/rescale.hpp>
 
 using namespace carve::geom;
 using namespace carve::geom3d;
 
 #include <random>
+#include <thread>
 
 std::mt19937 rng;
 std::normal_distribution<double> norm;
@@ -200,3 +205,299 @@ TEST(GeomTest, Geom3D) {
     checkInvariance(dir, base, a, b);
   }
 }
+
+TEST(GeomTest, MortonRoundTrip) {
+  uint32_t c[3] = {0x1fffff, 0x0a5a5a, 0x000001};
+  uint32_t d[3];
+  carve::geom::morton<3>::decode(carve::geom::morton<3>::encode(c), d);
+  ASSERT_EQ(c[0], d[0]);
+  ASSERT_EQ(c[1], d[1]);
+  ASSERT_EQ(c[2], d[2]);
+
+  // the specialised and generic encodings must agree.
+  uint64_t generic = 0;
+  for (unsigned b = 0; b < 21; ++b) {
+    for (unsigned i = 0; i < 3; ++i) {
+      generic |= (uint64_t)((c[i] >> b) & 1) << (b * 3 + i);
+    }
+  }
+  ASSERT_EQ(carve::geom::morton<3>::encode(c), generic);
+
+  uint32_t e = 0xffffffff, f;
+  carve::geom::morton<1>::decode(carve::geom::morton<1>::encode(&e), &f);
+  ASSERT_EQ(e, f);
+}
+
+TEST(GeomTest, FilteredOrient3D) {
+  carve::PredicateMode saved = carve::predicate_mode;
+  carve::setPredicateMode(carve::PREDICATES_FILTERED);
+  carve::predicate_stats.reset();
+  carve::predicate_stats.enabled = true;
+
+  // well separated points are decided by the filter alone.
+  for (int i = 0; i < 100; ++i) {
+    Vector a = randomUnitVector(), b = randomUnitVector(),
+           c = randomUnitVector();
+    Vector d = (a + b + c) / 3.0 + cross(b - a, c - a).normalized();
+    EXPECT_LT(orient3d(a, b, c, d), 0.0);
+  }
+  EXPECT_EQ(100U, carve::predicate_stats.orient3d_calls);
+  EXPECT_EQ(0U, carve::predicate_stats.orient3d_exact);
+
+  // points on the plane z = 0 are exactly coplanar, and must be
+  // reported as such.
+  for (int i = 0; i < 100; ++i) {
+    Vector a = randomUnitVector(), b = randomUnitVector(),
+           c = randomUnitVector(), d = randomUnitVector();
+    a.z = b.z = c.z = d.z = 0.5;
+    EXPECT_EQ(0.0, orient3d(a, b, c, d));
+  }
+  EXPECT_GT(carve::predicate_stats.orient3d_exact, 0U);
+
+  carve::predicate_stats.enabled = false;
+  carve::setPredicateMode(saved);
+}
+
+TEST(GeomTest, PredicateModeIsPerThread) {
+  carve::PredicateModeScope predicates(carve::PREDICATES_FAST);
+
+  carve::PredicateMode seen = carve::PREDICATES_FAST;
+  std::thread t([&seen]() {
+    carve::PredicateModeScope inner(carve::PREDICATES_INTEGER);
+    seen = carve::predicate_mode;
+  });
+  t.join();
+
+  EXPECT_EQ(carve::PREDICATES_INTEGER, seen);
+  EXPECT_EQ(carve::PREDICATES_FAST, carve::predicate_mode);
+}
+
+TEST(GeomTest, BatchedOrient3D) {
+  // a mix of general position and exactly coplanar points, in batches
+  // of every size up to 9 so that partial vector lanes are exercised.
+  for (size_t n = 1; n <= 9; ++n) {
+    std::vector<Vector> a(n), b(n), c(n), d(n);
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = randomUnitVector();
+      b[i] = randomUnitVector();
+      c[i] = randomUnitVector();
+      d[i] = randomUnitVector();
+      if (i % 2) {
+        a[i].z = b[i].z = c[i].z = d[i].z = 0.25;
+      }
+    }
+
+    std::vector<double> out(n);
+    carve::orient3d_batch(n, a[0].v, 3, b[0].v, 3, c[0].v, 3, d[0].v, 3,
+                          &out[0]);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(sign(shewchuk::orient3d(a[i].v, b[i].v, c[i].v, d[i].v)),
+                sign(out[i]));
+    }
+
+    // a single plane against many points.
+    carve::orient3d_batch(n, a[0].v, 0, b[0].v, 0, c[0].v, 0, d[0].v, 3,
+                          &out[0]);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(sign(shewchuk::orient3d(a[0].v, b[0].v, c[0].v, d[i].v)),
+                sign(out[i]));
+    }
+  }
+}
+
+TEST(GeomTest, BatchedOrient3DVectorMatchesScalar) {
+  if (!carve::detail::batch_avx2_supported()) {
+    GTEST_SKIP();
+  }
+  for (size_t n = 1; n <= 9; ++n) {
+    std::vector<Vector> a(n), b(n), c(n), d(n);
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = randomUnitVector();
+      b[i] = randomUnitVector();
+      c[i] = randomUnitVector();
+      d[i] = randomUnitVector();
+      if (i % 2) {
+        a[i].z = b[i].z = c[i].z = d[i].z = 0.25;
+      }
+    }
+
+    std::vector<double> vec(n), sca(n);
+    size_t n_vec = carve::detail::orient3d_batch_avx2(
+        n, a[0].v, 3, b[0].v, 3, c[0].v, 3, d[0].v, 3, &vec[0]);
+    size_t n_sca = carve::detail::orient3d_batch_scalar(
+        n, a[0].v, 3, b[0].v, 3, c[0].v, 3, d[0].v, 3, &sca[0]);
+    EXPECT_EQ(n_sca, n_vec);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(sca[i], vec[i]);
+    }
+
+    n_vec = carve::detail::orient3d_batch_avx2(n, a[0].v, 0, b[0].v, 0,
+                                               c[0].v, 0, d[0].v, 3, &vec[0]);
+    n_sca = carve::detail::orient3d_batch_scalar(
+        n, a[0].v, 0, b[0].v, 0, c[0].v, 0, d[0].v, 3, &sca[0]);
+    EXPECT_EQ(n_sca, n_vec);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(sca[i], vec[i]);
+    }
+  }
+}
+
+TEST(GeomTest, IntegerOrient3D) {
+  typedef carve::rescale::fwd_snap snap_t;
+  double det;
+
+  for (int i = 0; i < 1000; ++i) {
+    Vector a = snap_t::snap(randomUnitVector() * 0.25),
+           b = snap_t::snap(randomUnitVector() * 0.25),
+           c = snap_t::snap(randomUnitVector() * 0.25),
+           d = snap_t::snap(randomUnitVector() * 0.25);
+    if (i % 2) {
+      // d on the line through a and b is exactly coplanar, at the
+      // grid points that the line passes through.
+      d = a + (b - a) * 2.0;
+    }
+    ASSERT_TRUE(carve::orient3d_grid(a.v, b.v, c.v, d.v, det));
+    EXPECT_EQ(sign(shewchuk::orient3d(a.v, b.v, c.v, d.v)), sign(det));
+    EXPECT_EQ(sign(det), sign(carve::orient3d_integer(a.v, b.v, c.v, d.v)));
+  }
+
+  // points off the grid, or outside [-1, 1], are not handled.
+  Vector a = VECTOR(0.0, 0.0, 0.0), b = VECTOR(1.0, 0.0, 0.0),
+         c = VECTOR(0.0, 1.0, 0.0);
+  EXPECT_TRUE(carve::orient3d_grid(a.v, b.v, c.v, c.v, det));
+  EXPECT_EQ(0.0, det);
+  Vector d = VECTOR(0.0, 0.0, 1.0 / 3.0);
+  EXPECT_FALSE(carve::orient3d_grid(a.v, b.v, c.v, d.v, det));
+  EXPECT_LT(carve::orient3d_integer(a.v, b.v, c.v, d.v), 0.0);
+  d = VECTOR(0.0, 0.0, 2.0);
+  EXPECT_FALSE(carve::orient3d_grid(a.v, b.v, c.v, d.v, det));
+}
+
+TEST(GeomTest, ImplicitPoint) {
+  // a segment crossing the plane z = 0.1, whose intersection point
+  // cannot be represented exactly.
+  const Vector p = VECTOR(0.3, 0.7, -1.0 / 3.0),
+               q = VECTOR(0.9, -0.2, 2.0 / 3.0);
+  const Plane z1(VECTOR(0.0, 0.0, 1.0), -0.1);
+  const Plane z2(VECTOR(0.0, 0.0, 1.0), -nextafter(0.1, 1.0));
+  ImplicitPoint pt1(p, q, ExactPlane(z1)), pt2(p, q, ExactPlane(z2));
+  ASSERT_TRUE(pt1.valid());
+  ASSERT_TRUE(pt2.valid());
+  EXPECT_NEAR(0.1, pt1.approx().z, 1e-16);
+
+  // the plane through any triangle in z = 0.1 gives exactly the same
+  // point, and it lies strictly before the plane 1ulp further on.
+  Vector a = VECTOR(0.0, 0.0, 0.1), b = VECTOR(1.0, 0.0, 0.1),
+         c = VECTOR(0.0, 1.0, 0.1);
+  ImplicitPoint pt3(p, q, ExactPlane(a, b, c));
+  EXPECT_EQ(0, compareAlong(pt1, pt3));
+  EXPECT_EQ(-1, compareAlong(pt3, pt2));
+  EXPECT_EQ(0, compareAlong(pt1, pt1));
+  EXPECT_EQ(-1, compareAlong(pt1, pt2));
+  EXPECT_EQ(+1, compareAlong(pt2, pt1));
+  EXPECT_EQ(+1, compareAlong(pt1.reversed(), pt2.reversed()));
+
+  // a plane through three points, containing the segment.
+  ImplicitPoint parallel(p, q, ExactPlane(p, q, VECTOR(5.0, 5.0, 5.0)));
+  EXPECT_FALSE(parallel.valid());
+
+  // points along a segment are ordered as their rounded forms, and
+  // cached parameters compare as the points do.
+  for (int i = 0; i < 100; ++i) {
+    Vector a = randomUnitVector(), b = randomUnitVector(),
+           c = randomUnitVector();
+    Vector n = cross(b - a, c - a).normalized();
+    ImplicitPoint pt(a - n, a + n, ExactPlane(a, b, c));
+    ASSERT_TRUE(pt.valid());
+    ImplicitPoint pt_a(a - n, a + n, ExactPlane(a + n * 0.25, b, c));
+    EXPECT_EQ(+1, compareAlong(pt_a, pt));
+    EXPECT_EQ(+1,
+              compareAlong(ImplicitParameter(pt_a), ImplicitParameter(pt)));
+    EXPECT_EQ(-1, compareAlong(pt_a.reversed(), pt.reversed()));
+  }
+}
+
+static aabb<3> randomAABB() {
+  return aabb<3>(randomUnitVector(),
+                 VECTOR(fabs(norm(rng)), fabs(norm(rng)), fabs(norm(rng))) *
+                     0.25);
+}
+
+// the box that the generic aabb<ndim> code fits to [lo, hi].
+static aabb<3> referenceAABB(const Vector& lo, const Vector& hi) {
+  aabb<3> r;
+  for (unsigned j = 0; j < 3; ++j) {
+    r.pos.v[j] = (lo.v[j] + hi.v[j]) / 2.0;
+    r.extent.v[j] = std::max(hi.v[j] - r.pos.v[j], r.pos.v[j] - lo.v[j]);
+  }
+  return r;
+}
+
+TEST(GeomTest, AABB3D) {
+  for (int i = 0; i < 1000; ++i) {
+    Vector a = randomUnitVector(), b = randomUnitVector(),
+           c = randomUnitVector();
+    Vector lo, hi;
+    for (unsigned j = 0; j < 3; ++j) {
+      lo.v[j] = std::min(std::min(a.v[j], b.v[j]), c.v[j]);
+      hi.v[j] = std::max(std::max(a.v[j], b.v[j]), c.v[j]);
+    }
+    aabb<3> box;
+    box.fit(a, b, c);
+    EXPECT_EQ(box, referenceAABB(lo, hi));
+
+    aabb<3> p = randomAABB(), q = randomAABB();
+    double sep = -1e300;
+    for (unsigned j = 0; j < 3; ++j) {
+      sep = std::max(sep, fabs(q.pos.v[j] - p.pos.v[j]) - p.extent.v[j] -
+                              q.extent.v[j]);
+    }
+    EXPECT_EQ(p.maxAxisSeparation(q), sep);
+    EXPECT_EQ(p.intersects(q), sep <= 0.0);
+
+    for (unsigned j = 0; j < 3; ++j) {
+      lo.v[j] = std::min(p.min(j), q.min(j));
+      hi.v[j] = std::max(p.max(j), q.max(j));
+    }
+    aabb<3> u = p;
+    u.unionAABB(q);
+    EXPECT_EQ(u, referenceAABB(lo, hi));
+  }
+}
+
+TEST(GeomTest, AABBPacket) {
+  // batches of every size up to 9 so that partial vector lanes are
+  // exercised.
+  for (size_t n = 1; n <= 9; ++n) {
+    aabb<3> a = randomAABB();
+    std::vector<aabb<3> > boxes(n);
+    aabb_packet<3> packet;
+    for (size_t i = 0; i < n; ++i) {
+      boxes[i] = randomAABB();
+      packet.push_back(boxes[i]);
+    }
+    ASSERT_EQ(packet.size(), n);
+    EXPECT_EQ(packet.get(n - 1), boxes[n - 1]);
+
+    std::vector<double> sep(n);
+    maxAxisSeparation(a, packet, &sep[0]);
+
+    bool hit[9], hit_tol[9], hit_aos[9];
+    size_t count = carve::geom::intersects(a, packet, hit);
+    size_t count_tol = carve::geom::intersects(a, packet, hit_tol, 0.1);
+    size_t count_aos = carve::geom::intersects(a, &boxes[0], n, hit_aos);
+
+    size_t expect = 0, expect_tol = 0;
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(sep[i], boxes[i].maxAxisSeparation(a));
+      EXPECT_EQ(hit[i], boxes[i].intersects(a));
+      EXPECT_EQ(hit_tol[i], boxes[i].maxAxisSeparation(a) <= 0.1);
+      EXPECT_EQ(hit_aos[i], hit[i]);
+      expect += hit[i];
+      expect_tol += hit_tol[i];
+    }
+    EXPECT_EQ(count, expect);
+    EXPECT_EQ(count_tol, expect_tol);
+    EXPECT_EQ(count_aos, expect);
+  }
+}
@@ -156,3 +156,54 @@ TEST(HeapTest, Sort) {
 
   test_sort(heap);
 }
+
+// record_t keyed on position in a vector of values, so that values
+// can change while they are in the heap.
+struct index_record_t {
+  std::vector<size_t>& pos;
+  index_record_t(std::vector<size_t>& _pos) : pos(_pos) {}
+  void operator()(size_t x, size_t y) const { pos[x] = y; }
+};
+
+struct index_less_t {
+  const std::vector<int>& val;
+  index_less_t(const std::vector<int>& _val) : val(_val) {}
+  bool operator()(size_t a, size_t b) const { return val[a] < val[b]; }
+};
+
+TEST(HeapTest, AdjustAndRemove) {
+  const size_t N = 200;
+  std::vector<int> val(N);
+  std::vector<size_t> pos(N);
+  std::vector<size_t> heap(N);
+  for (size_t i = 0; i < N; ++i) {
+    val[i] = (int)((i * 7919) % 1000);
+    heap[i] = i;
+  }
+  index_less_t less(val);
+  carve::heap::make_heap(heap.begin(), heap.end(), less, index_record_t(pos));
+
+  for (size_t i = 0; i < 1000; ++i) {
+    // alternately raise and lower the priority of an element.
+    size_t x = (i * 104729) % N;
+    val[x] += (i & 1) ? 600 : -600;
+    carve::heap::adjust_heap(heap.begin(), heap.end(), heap.begin() + pos[x],
+                             less, index_record_t(pos));
+    ASSERT_TRUE(carve::heap::is_heap(heap.begin(), heap.end(), less));
+    for (size_t j = 0; j < heap.size(); ++j) {
+      ASSERT_EQ(j, pos[heap[j]]);
+    }
+  }
+
+  while (heap.size() > 1) {
+    size_t x = heap[(heap.size() * 7) / 10];
+    carve::heap::remove_heap(heap.begin(), heap.end(), heap.begin() + pos[x],
+                             less, index_record_t(pos));
+    ASSERT_EQ(x, heap.back());
+    heap.pop_back();
+    ASSERT_TRUE(carve::heap::is_heap(heap.begin(), heap.end(), less));
+    for (size_t j = 0; j < heap.size(); ++j) {
+      ASSERT_EQ(j, pos[heap[j]]);
+    }
+  }
+}
@@ -30,8 +30,10 @@
 
 #include <carve/carve.hpp>
 #include <carve/csg.hpp>
+#include <carve/csg_triangulator.hpp>
 #include <carve/input.hpp>
 
+#include <algorithm>
 #include <map>
 
 static carve::mesh::MeshSet<3>* makeCube(const carve::math::Matrix& transform) {
@@ -92,3 +94,95 @@ TEST(HookTest, ResultFace) {
   ASSERT_EQ(counter[a], 6);
   ASSERT_EQ(counter[b], 10);
 }
+
+struct SerialTriangulator : public carve::csg::CarveTriangulator {
+  bool isThreadSafe() const override { return false; }
+};
+
+typedef std::vector<carve::geom3d::Vector> tri_t;
+
+static std::vector<tri_t> triangles(const carve::mesh::MeshSet<3>* poly) {
+  std::vector<tri_t> result;
+  for (carve::mesh::MeshSet<3>::const_face_iter i = poly->faceBegin();
+       i != poly->faceEnd(); ++i) {
+    std::vector<carve::mesh::MeshSet<3>::vertex_t*> v;
+    (*i)->getVertices(v);
+    tri_t tri;
+    for (size_t j = 0; j < v.size(); ++j) {
+      tri.push_back(v[j]->v);
+    }
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()),
+                tri.end());
+    result.push_back(tri);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+TEST(HookTest, ParallelTriangulation) {
+  carve::mesh::MeshSet<3>* a = makeCube(carve::math::Matrix::SCALE(+5, +5, .5));
+  carve::mesh::MeshSet<3>* b =
+      makeCube(carve::math::Matrix::ROT(.5, +1, +1, +1));
+
+  carve::csg::CSG serial_csg;
+  serial_csg.hooks.registerHook(
+      new SerialTriangulator, carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_BIT);
+  ASSERT_FALSE(serial_csg.hooks.isThreadSafe(
+      carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_HOOK));
+  carve::mesh::MeshSet<3>* serial =
+      serial_csg.compute(a, b, carve::csg::CSG::UNION, nullptr,
+                         carve::csg::CSG::CLASSIFY_EDGE);
+
+  carve::csg::CSG parallel_csg;
+  parallel_csg.hooks.registerHook(
+      new carve::csg::CarveTriangulator,
+      carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_BIT);
+  ASSERT_TRUE(parallel_csg.hooks.isThreadSafe(
+      carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_HOOK));
+  carve::mesh::MeshSet<3>* parallel =
+      parallel_csg.compute(a, b, carve::csg::CSG::UNION, nullptr,
+                           carve::csg::CSG::CLASSIFY_EDGE);
+
+  std::vector<tri_t> st = triangles(serial);
+  std::vector<tri_t> pt = triangles(parallel);
+  ASSERT_EQ(st.size(), pt.size());
+  for (size_t i = 0; i < st.size(); ++i) {
+    ASSERT_EQ(3U, st[i].size());
+  }
+  ASSERT_TRUE(st == pt);
+
+  delete serial;
+  delete parallel;
+  delete a;
+  delete b;
+}
+
+struct ThrowingTriangulator : public carve::csg::CarveTriangulator {
+  void processOutputFace(
+      std::vector<carve::mesh::MeshSet<3>::face_t*>& /* faces */,
+      const carve::mesh::MeshSet<3>::face_t* /* orig */,
+      bool /* flipped */) override {
+    CARVE_FAIL("output face rejected");
+  }
+};
+
+TEST(HookTest, ParallelHookThrows) {
+  carve::mesh::MeshSet<3>* a = makeCube(carve::math::Matrix::SCALE(+5, +5, .5));
+  carve::mesh::MeshSet<3>* b =
+      makeCube(carve::math::Matrix::ROT(.5, +1, +1, +1));
+
+  carve::csg::CSG csg;
+  csg.hooks.registerHook(new ThrowingTriangulator,
+                         carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_BIT);
+  ASSERT_TRUE(
+      csg.hooks.isThreadSafe(carve::csg::CSG::Hooks::PROCESS_OUTPUT_FACE_HOOK));
+
+  // the failure must reach the caller, rather than terminating the
+  // process by leaving the parallel loop.
+  EXPECT_THROW(csg.compute(a, b, carve::csg::CSG::UNION, nullptr,
+                           carve::csg::CSG::CLASSIFY_EDGE),
+               carve::exception);
+
+  delete a;
+  delete b;
+}
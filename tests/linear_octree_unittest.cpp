@@ -0,0 +1,142 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/linear_octree.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+typedef carve::geom::aabb<3> aabb_t;
+
+struct box_t {
+  aabb_t bbox;
+  aabb_t getAABB() const { return bbox; }
+};
+
+static std::vector<box_t> randomBoxes(std::mt19937& rng, size_t n,
+                                      double max_extent) {
+  std::uniform_real_distribution<double> pos(-10.0, 10.0);
+  std::uniform_real_distribution<double> ext(0.0, max_extent);
+  std::vector<box_t> boxes(n);
+  for (size_t i = 0; i < n; ++i) {
+    boxes[i].bbox =
+        aabb_t(carve::geom::VECTOR(pos(rng), pos(rng), pos(rng)),
+               carve::geom::VECTOR(ext(rng), ext(rng), ext(rng)));
+  }
+  return boxes;
+}
+
+TEST(LinearOctreeTest, RadixSort) {
+  std::mt19937 rng(1);
+  std::vector<std::pair<uint64_t, uint32_t> > v(200000);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i] = std::make_pair(((uint64_t)rng() << 32) | rng(), (uint32_t)i);
+  }
+  std::vector<std::pair<uint64_t, uint32_t> > ref(v);
+  std::stable_sort(ref.begin(), ref.end(),
+                   [](const std::pair<uint64_t, uint32_t>& a,
+                      const std::pair<uint64_t, uint32_t>& b) {
+                     return a.first < b.first;
+                   });
+  carve::geom::radix_sort(v);
+  ASSERT_EQ(ref, v);
+}
+
+TEST(LinearOctreeTest, BoxQueries) {
+  std::mt19937 rng(2);
+  std::vector<box_t> boxes = randomBoxes(rng, 5000, 1.0);
+  // a few large boxes, which live near the root.
+  std::vector<box_t> big = randomBoxes(rng, 20, 8.0);
+  boxes.insert(boxes.end(), big.begin(), big.end());
+
+  std::vector<const box_t*> ptrs;
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    ptrs.push_back(&boxes[i]);
+  }
+  carve::geom::LinearOctree<const box_t*> octree(ptrs.begin(), ptrs.end());
+  ASSERT_EQ(octree.size(), boxes.size());
+
+  std::vector<box_t> queries = randomBoxes(rng, 200, 3.0);
+  for (size_t q = 0; q < queries.size(); ++q) {
+    std::vector<const box_t*> expected, found;
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+      if (ptrs[i]->bbox.intersects(queries[q].bbox)) {
+        expected.push_back(ptrs[i]);
+      }
+    }
+    octree.search(queries[q].bbox, std::back_inserter(found));
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(expected, found);
+  }
+}
+
+TEST(LinearOctreeTest, PointAndSegmentQueries) {
+  std::mt19937 rng(3);
+  std::vector<box_t> boxes = randomBoxes(rng, 2000, 0.5);
+  std::vector<const box_t*> ptrs;
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    ptrs.push_back(&boxes[i]);
+  }
+  carve::geom::LinearOctree<const box_t*> octree(ptrs.begin(), ptrs.end());
+
+  std::uniform_real_distribution<double> pos(-11.0, 11.0);
+  for (size_t q = 0; q < 200; ++q) {
+    carve::geom::vector<3> a = carve::geom::VECTOR(pos(rng), pos(rng), pos(rng));
+    carve::geom::vector<3> b = carve::geom::VECTOR(pos(rng), pos(rng), pos(rng));
+    carve::geom::linesegment<3> l(a, b);
+
+    std::vector<const box_t*> expected, found;
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+      if (ptrs[i]->bbox.containsPoint(a)) {
+        expected.push_back(ptrs[i]);
+      }
+    }
+    octree.search(a, std::back_inserter(found));
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(expected, found);
+
+    expected.clear();
+    found.clear();
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+      if (ptrs[i]->bbox.intersects(l)) {
+        expected.push_back(ptrs[i]);
+      }
+    }
+    octree.search(l, std::back_inserter(found));
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(expected, found);
+  }
+}
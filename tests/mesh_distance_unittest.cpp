@@ -0,0 +1,128 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/input.hpp>
+#include <carve/matrix.hpp>
+#include <carve/mesh_distance.hpp>
+
+#include <memory>
+
+static carve::mesh::MeshSet<3>* makeCube(const carve::math::Matrix& transform) {
+  carve::input::PolyhedronData data;
+
+  data.addVertex(transform * carve::geom::VECTOR(+1.0, +1.0, +1.0));
+  data.addVertex(transform * carve::geom::VECTOR(-1.0, +1.0, +1.0));
+  data.addVertex(transform * carve::geom::VECTOR(-1.0, -1.0, +1.0));
+  data.addVertex(transform * carve::geom::VECTOR(+1.0, -1.0, +1.0));
+  data.addVertex(transform * carve::geom::VECTOR(+1.0, +1.0, -1.0));
+  data.addVertex(transform * carve::geom::VECTOR(-1.0, +1.0, -1.0));
+  data.addVertex(transform * carve::geom::VECTOR(-1.0, -1.0, -1.0));
+  data.addVertex(transform * carve::geom::VECTOR(+1.0, -1.0, -1.0));
+
+  data.addFace(0, 1, 2, 3);
+  data.addFace(7, 6, 5, 4);
+  data.addFace(0, 4, 5, 1);
+  data.addFace(1, 5, 6, 2);
+  data.addFace(2, 6, 7, 3);
+  data.addFace(3, 7, 4, 0);
+
+  return new carve::mesh::MeshSet<3>(data.points, data.getFaceCount(),
+                                     data.faceIndices);
+}
+
+TEST(MeshDistanceTest, ClosestPoint) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > cube(
+      makeCube(carve::math::Matrix::IDENT()));
+
+  carve::mesh::FaceProximity result;
+
+  // outside, facing the +x face.
+  ASSERT_TRUE(carve::mesh::closestPoint(
+      cube.get(), carve::geom::VECTOR(3.0, 0.5, 0.25), result));
+  EXPECT_DOUBLE_EQ(result.distance(), 2.0);
+  EXPECT_DOUBLE_EQ(result.point.x, 1.0);
+  EXPECT_DOUBLE_EQ(result.point.y, 0.5);
+  EXPECT_DOUBLE_EQ(result.point.z, 0.25);
+
+  // outside, nearest to a corner.
+  ASSERT_TRUE(carve::mesh::closestPoint(
+      cube.get(), carve::geom::VECTOR(2.0, 2.0, 2.0), result));
+  EXPECT_DOUBLE_EQ(result.distance2, 3.0);
+
+  // inside.
+  ASSERT_TRUE(carve::mesh::closestPoint(
+      cube.get(), carve::geom::VECTOR(0.0, 0.0, 0.75), result));
+  EXPECT_NEAR(result.distance(), 0.25, 1e-12);
+}
+
+TEST(MeshDistanceTest, NearestFaces) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > cube(
+      makeCube(carve::math::Matrix::IDENT()));
+
+  std::vector<carve::mesh::FaceProximity> result;
+  carve::mesh::nearestFaces(cube.get(), carve::geom::VECTOR(3.0, 0.0, 0.0), 3,
+                            result);
+
+  ASSERT_EQ(result.size(), 3U);
+  EXPECT_DOUBLE_EQ(result[0].distance(), 2.0);
+  EXPECT_LE(result[0].distance2, result[1].distance2);
+  EXPECT_LE(result[1].distance2, result[2].distance2);
+  EXPECT_NE(result[0].face, result[1].face);
+  EXPECT_NE(result[1].face, result[2].face);
+
+  carve::mesh::nearestFaces(cube.get(), carve::geom::VECTOR(3.0, 0.0, 0.0), 10,
+                            result);
+  EXPECT_EQ(result.size(), 6U);
+}
+
+TEST(MeshDistanceTest, MinimumDistance) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > a(
+      makeCube(carve::math::Matrix::IDENT()));
+  std::unique_ptr<carve::mesh::MeshSet<3> > b(
+      makeCube(carve::math::Matrix::TRANS(3.5, 0.5, 0.0)));
+  std::unique_ptr<carve::mesh::MeshSet<3> > c(makeCube(
+      carve::math::Matrix::TRANS(0.5, 0.5, 0.5) *
+      carve::math::Matrix::ROT(.5, 1.0, 1.0, 1.0)));
+
+  carve::mesh::MeshProximity result;
+
+  ASSERT_TRUE(carve::mesh::minimumDistance(a.get(), b.get(), result));
+  EXPECT_NEAR(result.distance(), 1.5, 1e-12);
+  EXPECT_NEAR(result.point_a.x, 1.0, 1e-12);
+  EXPECT_NEAR(result.point_b.x, 2.5, 1e-12);
+
+  ASSERT_TRUE(carve::mesh::minimumDistance(a.get(), c.get(), result));
+  EXPECT_EQ(result.distance2, 0.0);
+
+  EXPECT_TRUE(carve::mesh::withinDistance(a.get(), b.get(), 1.6));
+  EXPECT_FALSE(carve::mesh::withinDistance(a.get(), b.get(), 1.4));
+  EXPECT_TRUE(carve::mesh::withinDistance(a.get(), c.get(), 0.0));
+}
@@ -0,0 +1,199 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/input.hpp>
+#include <carve/matrix.hpp>
+#include <carve/mesh_simplify.hpp>
+
+#include "geometry.hpp"
+
+#include <map>
+#include <memory>
+
+// A triangulated n x n grid on the surface z = x * y, which is open
+// along its border.
+static carve::mesh::MeshSet<3>* makeSaddle(int n) {
+  carve::input::PolyhedronData data;
+
+  for (int i = 0; i <= n; ++i) {
+    for (int j = 0; j <= n; ++j) {
+      double x = 2.0 * i / n - 1.0;
+      double y = 2.0 * j / n - 1.0;
+      data.addVertex(carve::geom::VECTOR(x, y, x * y));
+    }
+  }
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      int a = i * (n + 1) + j;
+      int b = a + n + 1;
+      data.addFace(a, b, b + 1);
+      data.addFace(a, b + 1, a + 1);
+    }
+  }
+
+  return new carve::mesh::MeshSet<3>(data.points, data.getFaceCount(),
+                                     data.faceIndices);
+}
+
+static size_t countFaces(carve::mesh::MeshSet<3>* poly) {
+  size_t n = 0;
+  for (carve::mesh::MeshSet<3>::face_iter i = poly->faceBegin();
+       i != poly->faceEnd(); ++i) {
+    EXPECT_EQ(3U, (*i)->nVertices());
+    ++n;
+  }
+  return n;
+}
+
+TEST(MeshSimplifierTest, DecimateToFaceCount) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > poly(makeSphere(64, 32, true));
+  double volume = poly->meshes[0]->volume();
+
+  carve::mesh::MeshSimplifier simplifier;
+  size_t n_mods = simplifier.decimate(poly.get(), 500);
+
+  EXPECT_GT(n_mods, 0U);
+  size_t n_faces = countFaces(poly.get());
+  EXPECT_LE(n_faces, 500U);
+  EXPECT_GE(n_faces, 490U);
+
+  ASSERT_EQ(1U, poly->meshes.size());
+  EXPECT_TRUE(poly->meshes[0]->isClosed());
+  EXPECT_NEAR(volume, poly->meshes[0]->volume(), 0.02 * volume);
+
+  for (carve::mesh::MeshSet<3>::face_iter i = poly->faceBegin();
+       i != poly->faceEnd(); ++i) {
+    carve::mesh::MeshSet<3>::edge_t* e = (*i)->edge;
+    do {
+      EXPECT_NEAR(1.0, e->vert->v.length(), 0.02);
+      e = e->next;
+    } while (e != (*i)->edge);
+  }
+}
+
+TEST(MeshSimplifierTest, DecimateToErrorBound) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > poly(makeSphere(32, 16, true));
+  size_t n_faces = countFaces(poly.get());
+
+  carve::mesh::MeshSimplifier simplifier;
+  EXPECT_EQ(0U, simplifier.decimate(poly.get(), 0, 0.0));
+  EXPECT_EQ(n_faces, countFaces(poly.get()));
+
+  EXPECT_GT(simplifier.decimate(poly.get(), 0, 1e-4, true), 0U);
+  EXPECT_LT(countFaces(poly.get()), n_faces);
+  EXPECT_TRUE(poly->meshes[0]->isClosed());
+}
+
+TEST(MeshSimplifierTest, DecimatePreservesBoundary) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > poly(makeSaddle(20));
+
+  std::map<const carve::mesh::MeshSet<3>::vertex_t*,
+           carve::geom::vector<3> > boundary;
+  for (size_t i = 0; i < poly->meshes[0]->open_edges.size(); ++i) {
+    const carve::mesh::MeshSet<3>::vertex_t* v =
+        poly->meshes[0]->open_edges[i]->vert;
+    boundary[v] = v->v;
+  }
+  size_t n_open = poly->meshes[0]->open_edges.size();
+  ASSERT_EQ(80U, n_open);
+
+  carve::mesh::MeshSimplifier simplifier;
+  simplifier.decimate(poly.get(), 100);
+
+  EXPECT_LE(countFaces(poly.get()), 100U);
+  EXPECT_EQ(n_open, poly->meshes[0]->open_edges.size());
+  for (std::map<const carve::mesh::MeshSet<3>::vertex_t*,
+                carve::geom::vector<3> >::iterator i = boundary.begin();
+       i != boundary.end(); ++i) {
+    EXPECT_EQ((*i).second, (*i).first->v);
+  }
+
+  // the interior of a saddle is curved, so it cannot be flattened.
+  for (carve::mesh::MeshSet<3>::face_iter i = poly->faceBegin();
+       i != poly->faceEnd(); ++i) {
+    carve::mesh::MeshSet<3>::edge_t* e = (*i)->edge;
+    do {
+      const carve::geom::vector<3>& v = e->vert->v;
+      EXPECT_NEAR(v.x * v.y, v.z, 0.1);
+      e = e->next;
+    } while (e != (*i)->edge);
+  }
+}
+
+// The largest distance of a vertex from the unit sphere.
+static double sphereError(carve::mesh::MeshSet<3>* poly) {
+  double err = 0.0;
+  for (size_t i = 0; i < poly->vertex_storage.size(); ++i) {
+    err = std::max(err, fabs(poly->vertex_storage[i].v.length() - 1.0));
+  }
+  return err;
+}
+
+TEST(MeshSimplifierTest, DecimateBatched) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > serial(makeSphere(64, 32, true));
+  std::unique_ptr<carve::mesh::MeshSet<3> > batched(makeSphere(64, 32, true));
+  double volume = batched->meshes[0]->volume();
+
+  carve::mesh::MeshSimplifier simplifier;
+  simplifier.decimate(serial.get(), 500);
+  simplifier.batch_size = 64;
+  EXPECT_GT(simplifier.decimate(batched.get(), 500), 0U);
+
+  size_t n_faces = countFaces(batched.get());
+  EXPECT_LE(n_faces, 500U);
+  EXPECT_GE(n_faces, 490U);
+
+  ASSERT_EQ(1U, batched->meshes.size());
+  EXPECT_TRUE(batched->meshes[0]->isClosed());
+  EXPECT_NEAR(volume, batched->meshes[0]->volume(), 0.02 * volume);
+  EXPECT_LT(sphereError(batched.get()), 2.0 * sphereError(serial.get()));
+
+  std::unique_ptr<carve::mesh::MeshSet<3> > checked(makeSphere(32, 16, true));
+  EXPECT_GT(simplifier.decimate(checked.get(), 100, 1e-2, true), 0U);
+  EXPECT_LE(countFaces(checked.get()), 100U);
+  EXPECT_TRUE(checked->meshes[0]->isClosed());
+}
+
+TEST(MeshSimplifierTest, ImproveMeshBatched) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > poly(makeSphere(64, 32, true));
+  double volume = poly->meshes[0]->volume();
+
+  carve::mesh::MeshSimplifier simplifier;
+  simplifier.batch_size = 64;
+  EXPECT_GT(simplifier.improveMesh(poly.get(), 0.0, 1e-2, M_PI / 4), 0U);
+
+  EXPECT_TRUE(poly->meshes[0]->isClosed());
+  EXPECT_NEAR(volume, poly->meshes[0]->volume(), 1e-3 * volume);
+
+  // batching delays flips, but leaves none to make.
+  carve::mesh::MeshSimplifier serial;
+  EXPECT_EQ(0U, serial.improveMesh(poly.get(), 0.0, 1e-2, M_PI / 4));
+}
@@ -62,19 +62,19 @@ void triangulate(std::vector<carve::mesh::Vertex<3> >& vertices) {
   }
   faces[0] = new carve::mesh::Face<3>(vptr.begin(), vptr.end());
 
-  double a0 = area(faces[0]->edge, faces[0]->project);
+  double a0 = area(faces[0]->edge, faces[0]->projector());
 
   std::cerr << "AREA(LOOP): " << a0 << std::endl;
 
   std::vector<carve::mesh::Edge<3>*> triangles;
-  carve::mesh::triangulate(faces[0]->edge, faces[0]->project,
+  carve::mesh::triangulate(faces[0]->edge, faces[0]->projector(),
                            std::back_inserter(triangles));
   ASSERT_EQ(triangles.size(), vertices.size() - 2);
 
   double a1 = 0.0;
   for (size_t i = 0; i < triangles.size(); ++i) {
     ASSERT_EQ(triangles[i]->loopLen(), 3);
-    double a = area(triangles[i], faces[0]->project);
+    double a = area(triangles[i], faces[0]->projector());
     // std::cerr << triangles[i]->face << " " << triangles[i]->next->face << " "
     // << triangles[i]->next->next->face << std::endl;
     ASSERT_LE(a, 0.0);
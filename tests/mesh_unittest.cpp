@@ -348,3 +348,105 @@ TEST(MeshTest, MeshConstruction1) {
   dumpMeshes(mesh);
   delete mesh;
 }
+
+TEST(MeshTest, ReorderSpatially) {
+  std::vector<carve::mesh::Vertex<3> > vertices;
+  std::vector<carve::mesh::Face<3>*> faces;
+  obj2(vertices, faces);
+  std::vector<carve::mesh::Mesh<3>*> meshes;
+  carve::mesh::Mesh<3>::create(faces.begin(), faces.end(), meshes,
+                               carve::mesh::MeshOptions());
+  carve::mesh::MeshSet<3>* mesh = new carve::mesh::MeshSet<3>(vertices, meshes);
+
+  std::vector<double> volume;
+  std::vector<size_t> n_faces, n_closed;
+  for (size_t i = 0; i < mesh->meshes.size(); ++i) {
+    volume.push_back(mesh->meshes[i]->volume());
+    n_faces.push_back(mesh->meshes[i]->faces.size());
+    n_closed.push_back(mesh->meshes[i]->closed_edges.size());
+  }
+
+  mesh->reorderSpatially();
+
+  ASSERT_EQ(mesh->meshes.size(), volume.size());
+  for (size_t i = 0; i < mesh->meshes.size(); ++i) {
+    ASSERT_NEAR(mesh->meshes[i]->volume(), volume[i], 1e-10);
+    ASSERT_EQ(mesh->meshes[i]->faces.size(), n_faces[i]);
+    ASSERT_EQ(mesh->meshes[i]->closed_edges.size(), n_closed[i]);
+  }
+
+  const carve::mesh::Vertex<3>* vbegin = &mesh->vertex_storage.front();
+  const carve::mesh::Vertex<3>* vend = vbegin + mesh->vertex_storage.size();
+  for (carve::mesh::MeshSet<3>::face_iter i = mesh->faceBegin();
+       i != mesh->faceEnd(); ++i) {
+    carve::mesh::Edge<3>* e = (*i)->edge;
+    do {
+      ASSERT_TRUE(e->vert >= vbegin && e->vert < vend);
+      e = e->next;
+    } while (e != (*i)->edge);
+  }
+
+  carve::geom::morton_quantizer<3> quantizer(mesh->getAABB());
+  for (size_t i = 1; i < mesh->vertex_storage.size(); ++i) {
+    ASSERT_LE(quantizer(mesh->vertex_storage[i - 1].v),
+              quantizer(mesh->vertex_storage[i].v));
+  }
+
+  delete mesh;
+}
+
+// applies a matrix through the generic per-vertex transform path.
+struct generic_transformation {
+  carve::math::Matrix matrix;
+  generic_transformation(const carve::math::Matrix& m) : matrix(m) {}
+  carve::geom::vector<3> operator()(const carve::geom::vector<3>& v) const {
+    return matrix * v;
+  }
+};
+
+TEST(MeshTest, MatrixTransform) {
+  std::vector<carve::mesh::Vertex<3> > vertices;
+  std::vector<carve::mesh::Face<3>*> faces;
+  obj2(vertices, faces);
+  std::vector<carve::mesh::Mesh<3>*> meshes;
+  carve::mesh::Mesh<3>::create(faces.begin(), faces.end(), meshes,
+                               carve::mesh::MeshOptions());
+  carve::mesh::MeshSet<3>* mesh = new carve::mesh::MeshSet<3>(vertices, meshes);
+
+  carve::math::Matrix rigid =
+      carve::math::Matrix::TRANS(1.5, -2.0, 0.25) *
+      carve::math::Matrix::ROT(0.7, carve::geom::VECTOR(1.0, 2.0, -0.5));
+  carve::math::Matrix scale = carve::math::Matrix::SCALE(2.0, -1.0, 0.5);
+  ASSERT_TRUE(carve::math::isRigid(rigid));
+  ASSERT_FALSE(carve::math::isRigid(scale));
+
+  for (int pass = 0; pass < 2; ++pass) {
+    const carve::math::Matrix& m = pass ? scale : rigid;
+    carve::mesh::MeshSet<3>* a = mesh->clone();
+    carve::mesh::MeshSet<3>* b = mesh->clone();
+    a->transform(carve::math::matrix_transformation(m));
+    b->transform(generic_transformation(m));
+
+    ASSERT_EQ(a->vertex_storage.size(), b->vertex_storage.size());
+    for (size_t i = 0; i < a->vertex_storage.size(); ++i) {
+      ASSERT_EQ(a->vertex_storage[i].v, b->vertex_storage[i].v);
+    }
+
+    for (carve::mesh::MeshSet<3>::face_iter i = a->faceBegin(),
+                                            j = b->faceBegin();
+         i != a->faceEnd(); ++i, ++j) {
+      ASSERT_NEAR(carve::geom::distance((*i)->plane.N, (*j)->plane.N), 0.0,
+                  1e-10);
+      ASSERT_NEAR((*i)->plane.d, (*j)->plane.d, 1e-10);
+      ASSERT_EQ((*i)->projection, (*j)->projection);
+    }
+    for (size_t i = 0; i < a->meshes.size(); ++i) {
+      ASSERT_EQ(a->meshes[i]->isNegative(), b->meshes[i]->isNegative());
+    }
+
+    delete a;
+    delete b;
+  }
+
+  delete mesh;
+}
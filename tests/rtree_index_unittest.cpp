@@ -0,0 +1,121 @@
+// Copyright 2006-2015 Tobias Sargeant (tobias.sargeant@gmail.com).
+//
+// This file is part of the Carve CSG Library (http://carve-csg.com/)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#if defined(HAVE_CONFIG_H)
+#include <carve_config.h>
+#endif
+
+#include <carve/carve.hpp>
+#include <carve/input.hpp>
+#include <carve/matrix.hpp>
+#include <carve/rtree_index.hpp>
+
+#include "geometry.hpp"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+static std::string tempName() {
+  return std::string(::testing::TempDir()) + "rtree_index_unittest.idx";
+}
+
+static std::vector<carve::mesh::Face<3>*> sorted(
+    std::vector<carve::mesh::Face<3>*> v) {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+TEST(RTreeIndexTest, RoundTrip) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > sphere(makeSphere(24, 12));
+  std::unique_ptr<carve::mesh::face_rtree_t> tree(
+      carve::mesh::face_rtree_t::construct_STR(sphere->faceBegin(),
+                                               sphere->faceEnd(), 4, 4));
+
+  const std::string filename = tempName();
+  ASSERT_TRUE(
+      carve::mesh::FaceRTreeIndex::write(filename, sphere.get(), tree.get()));
+
+  carve::mesh::FaceRTreeIndex index;
+  ASSERT_TRUE(index.open(filename, sphere.get()));
+  ASSERT_TRUE(index.isOpen());
+
+  std::unique_ptr<carve::mesh::face_rtree_t> rebuilt(index.toRTree());
+  ASSERT_TRUE(rebuilt.get() != nullptr);
+
+  for (int i = 0; i < 20; ++i) {
+    double t = i / 20.0;
+    carve::geom::aabb<3> q(carve::geom::VECTOR(cos(7 * t), sin(5 * t), t - .5),
+                           carve::geom::VECTOR(0.2, 0.2, 0.2));
+    std::vector<carve::mesh::Face<3>*> a, b, c;
+    tree->search(q, std::back_inserter(a));
+    index.search(q, std::back_inserter(b));
+    rebuilt->search(q, std::back_inserter(c));
+    ASSERT_EQ(sorted(a), sorted(b));
+    ASSERT_EQ(sorted(a), sorted(c));
+  }
+
+  index.close();
+  ASSERT_FALSE(index.isOpen());
+  remove(filename.c_str());
+}
+
+TEST(RTreeIndexTest, RejectsStaleIndex) {
+  std::unique_ptr<carve::mesh::MeshSet<3> > sphere(makeSphere(16, 8));
+  const std::string filename = tempName();
+  ASSERT_TRUE(carve::mesh::FaceRTreeIndex::write(filename, sphere.get()));
+
+  carve::mesh::FaceRTreeIndex index;
+
+  // a different mesh.
+  std::unique_ptr<carve::mesh::MeshSet<3> > other(makeSphere(16, 9));
+  ASSERT_FALSE(index.open(filename, other.get()));
+
+  // the same topology, with a vertex moved.
+  std::unique_ptr<carve::mesh::MeshSet<3> > moved(sphere->clone());
+  moved->vertex_storage[3].v.x += 1e-3;
+  ASSERT_FALSE(index.open(filename, moved.get()));
+  ASSERT_FALSE(index.isOpen());
+
+  ASSERT_TRUE(index.open(filename, sphere.get()));
+  index.close();
+
+  // a truncated file.
+  {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    out.write(content.data(), content.size() - 4);
+  }
+  ASSERT_FALSE(index.open(filename, sphere.get()));
+
+  ASSERT_FALSE(index.open(filename + ".missing", sphere.get()));
+  remove(filename.c_str());
+}
@@ -31,4 +31,43 @@
 #include <carve/carve.hpp>
 #include <carve/geom.hpp>
 
-TEST(TriPtDistTest, TriPtDistTest1) {}
+static const carve::geom::tri<3> unit_tri(carve::geom::VECTOR(0, 0, 0),
+                                          carve::geom::VECTOR(1, 0, 0),
+                                          carve::geom::VECTOR(0, 1, 0));
+
+TEST(TriPtDistTest, TriPtDistTest1) {
+  // closest point within the triangle interior.
+  carve::geom::vector<3> p = carve::geom::VECTOR(.25, .25, 2);
+  carve::geom::vector<3> c = carve::geom::closestPoint(unit_tri, p);
+  EXPECT_DOUBLE_EQ(c.x, .25);
+  EXPECT_DOUBLE_EQ(c.y, .25);
+  EXPECT_DOUBLE_EQ(c.z, 0);
+  EXPECT_DOUBLE_EQ(carve::geom::distance(unit_tri, p), 2.0);
+}
+
+TEST(TriPtDistTest, TriPtDistVertex) {
+  carve::geom::vector<3> p = carve::geom::VECTOR(-1, -1, 0);
+  carve::geom::vector<3> c = carve::geom::closestPoint(unit_tri, p);
+  EXPECT_DOUBLE_EQ(c.x, 0);
+  EXPECT_DOUBLE_EQ(c.y, 0);
+  EXPECT_DOUBLE_EQ(carve::geom::distance2(unit_tri, p), 2.0);
+}
+
+TEST(TriPtDistTest, TriPtDistEdge) {
+  carve::geom::vector<3> p = carve::geom::VECTOR(1, 1, 0);
+  carve::geom::vector<3> c = carve::geom::closestPoint(unit_tri, p);
+  EXPECT_DOUBLE_EQ(c.x, .5);
+  EXPECT_DOUBLE_EQ(c.y, .5);
+  EXPECT_DOUBLE_EQ(carve::geom::distance2(unit_tri, p), .5);
+}
+
+TEST(TriPtDistTest, SegmentSegmentDistance) {
+  carve::geom::linesegment<3> a(carve::geom::VECTOR(-1, 0, 0),
+                                carve::geom::VECTOR(1, 0, 0));
+  carve::geom::linesegment<3> b(carve::geom::VECTOR(0, -1, 1),
+                                carve::geom::VECTOR(0, 1, 1));
+  carve::geom::linesegment<3> c(carve::geom::VECTOR(2, 0, 0),
+                                carve::geom::VECTOR(3, 0, 0));
+  EXPECT_DOUBLE_EQ(carve::geom::distance(a, b), 1.0);
+  EXPECT_DOUBLE_EQ(carve::geom::distance(a, c), 1.0);
+}
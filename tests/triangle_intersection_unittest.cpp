@@ -77,3 +77,39 @@ TEST(TriangleIntersectionTest, Test2D) {
     }
   }
 }
+
+TEST(TriangleIntersectionTest, Packet3D) {
+  typedef carve::geom::vector<3> v3;
+
+  // triangles on a small integer lattice, so that shared vertices,
+  // shared edges and coplanar pairs occur often.
+  srand(1);
+  std::vector<v3> lattice;
+  for (int i = 0; i < 27; ++i) {
+    lattice.push_back(carve::geom::VECTOR(i % 3, (i / 3) % 3, i / 9));
+  }
+
+  for (int trial = 0; trial < 50; ++trial) {
+    v3 tri_a[3];
+    for (int k = 0; k < 3; ++k) {
+      tri_a[k] = lattice[rand() % lattice.size()];
+    }
+
+    carve::geom::triangle_packet packet;
+    for (int j = 0; j < 23; ++j) {
+      packet.push_back(lattice[rand() % lattice.size()],
+                       lattice[rand() % lattice.size()],
+                       lattice[rand() % lattice.size()]);
+    }
+
+    std::vector<carve::geom::TriangleIntType> result(packet.size());
+    carve::geom::triangle_intersection_exact(tri_a, packet, &result[0]);
+
+    for (size_t j = 0; j < packet.size(); ++j) {
+      v3 tri_b[3];
+      packet.get(j, tri_b);
+      EXPECT_EQ(carve::geom::triangle_intersection_exact(tri_a, tri_b),
+                result[j]);
+    }
+  }
+}
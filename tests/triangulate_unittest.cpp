@@ -32,6 +32,27 @@
 #include <carve/geom.hpp>
 #include <carve/triangulator.hpp>
 
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <set>
+
+// count heap allocations, so that tests can check that a reused
+// Triangulator does not allocate.
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+  ++allocations;
+  void* p = malloc(size ? size : 1);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
 TEST(Triangulate, Test2) {
   std::vector<carve::geom::vector<2> > poly;
   std::vector<carve::triangulate::tri_idx> result;
@@ -63,3 +84,346 @@ TEST(Triangulate, Test1) {
 
   carve::triangulate::triangulate(poly, result);
 }
+
+static std::vector<carve::geom::vector<2> > comb(int teeth) {
+  std::vector<carve::geom::vector<2> > poly;
+  for (int i = 0; i < teeth; ++i) {
+    poly.push_back(carve::geom::VECTOR(i * 2.0, 0.0));
+    poly.push_back(carve::geom::VECTOR(i * 2.0 + 1.0, 0.0));
+    poly.push_back(carve::geom::VECTOR(i * 2.0 + 1.0, -10.0));
+    poly.push_back(carve::geom::VECTOR(i * 2.0 + 2.0, -10.0));
+  }
+  poly.push_back(carve::geom::VECTOR(teeth * 2.0, 1.0));
+  poly.push_back(carve::geom::VECTOR(0.0, 1.0));
+  return poly;
+}
+
+// check that the triangles are consistently oriented (optionally
+// allowing for slivers) and cover an area of the given sign and
+// magnitude.
+static void checkCover(const std::vector<carve::geom::vector<2> >& points,
+                       const std::vector<carve::triangulate::tri_idx>& result,
+                       double expected_area, bool allow_slivers = false) {
+  double area = 0.0;
+  for (size_t i = 0; i < result.size(); ++i) {
+    std::vector<carve::geom::vector<2> > tri;
+    tri.push_back(points[result[i].a]);
+    tri.push_back(points[result[i].b]);
+    tri.push_back(points[result[i].c]);
+    double a = carve::geom2d::signedArea(tri);
+    if (allow_slivers) {
+      EXPECT_GT(a * expected_area, -1e-9);
+    } else {
+      EXPECT_GT(a * expected_area, 0.0);
+    }
+    area += a;
+  }
+  EXPECT_NEAR(expected_area, area, 1e-6);
+}
+
+TEST(Triangulate, LargeComb) {
+  // large enough that ear clipping uses the reflex vertex grid.
+  std::vector<carve::geom::vector<2> > poly = comb(500);
+  std::vector<carve::triangulate::tri_idx> result;
+
+  carve::triangulate::triangulate(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+}
+
+// the sweep itself, rather than triangulate(), which would hide a
+// fallback to ear clipping.
+static void sweep(const std::vector<carve::geom::vector<2> >& poly,
+                  std::vector<carve::triangulate::tri_idx>& result) {
+  std::vector<std::vector<carve::geom::vector<2> > > loops(1, poly);
+  ASSERT_TRUE(carve::triangulate::detail::sweepTriangulate(loops, result));
+}
+
+TEST(Triangulate, SweepComb) {
+  std::vector<carve::geom::vector<2> > poly = comb(500);
+  std::vector<carve::triangulate::tri_idx> result;
+
+  sweep(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+}
+
+TEST(Triangulate, SweepClockwise) {
+  // triangles follow the orientation of the input loop.
+  std::vector<carve::geom::vector<2> > poly = comb(20);
+  std::reverse(poly.begin(), poly.end());
+  std::vector<carve::triangulate::tri_idx> result;
+
+  sweep(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+}
+
+static std::vector<carve::geom::vector<2> > circle(int n) {
+  std::vector<carve::geom::vector<2> > poly;
+  for (int i = 0; i < n; ++i) {
+    double a = 2.0 * M_PI * i / n;
+    poly.push_back(carve::geom::VECTOR(cos(a), sin(a)));
+  }
+  return poly;
+}
+
+// a y-monotone polygon whose two chains zig-zag, so that half of its
+// vertices are reflex.
+static std::vector<carve::geom::vector<2> > zigzag(int n) {
+  std::vector<carve::geom::vector<2> > poly;
+  for (int i = 0; i <= n; ++i) {
+    poly.push_back(carve::geom::VECTOR(2.0 + (i & 1), -i));
+  }
+  for (int i = n; i >= 0; --i) {
+    poly.push_back(carve::geom::VECTOR(-2.0 - (i & 1), -i));
+  }
+  return poly;
+}
+
+TEST(Triangulate, Convex) {
+  std::vector<carve::geom::vector<2> > poly = circle(100000);
+  std::vector<carve::triangulate::tri_idx> result;
+
+  carve::triangulate::triangulate(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+
+  std::reverse(poly.begin(), poly.end());
+  carve::triangulate::triangulate(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+}
+
+TEST(Triangulate, Monotone) {
+  std::vector<carve::geom::vector<2> > poly = zigzag(50000);
+  std::vector<carve::triangulate::tri_idx> result;
+
+  carve::triangulate::triangulate(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+
+  std::reverse(poly.begin(), poly.end());
+  carve::triangulate::triangulate(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+}
+
+TEST(Triangulate, ConvexCollinear) {
+  // a square with extra vertices along its edges is not strictly
+  // convex, and is handled as a monotone polygon instead.
+  std::vector<carve::geom::vector<2> > poly;
+  for (int i = 0; i < 4; ++i) {
+    poly.push_back(carve::geom::VECTOR(i, 0.0));
+  }
+  for (int i = 0; i < 4; ++i) {
+    poly.push_back(carve::geom::VECTOR(4.0, i));
+  }
+  for (int i = 4; i > 0; --i) {
+    poly.push_back(carve::geom::VECTOR(i, 4.0));
+  }
+  for (int i = 4; i > 0; --i) {
+    poly.push_back(carve::geom::VECTOR(0.0, i));
+  }
+  std::vector<carve::triangulate::tri_idx> result;
+
+  carve::triangulate::triangulate(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+  for (size_t i = 0; i < result.size(); ++i) {
+    EXPECT_NE(0.0, carve::geom2d::orient2d(poly[result[i].a],
+                                           poly[result[i].b],
+                                           poly[result[i].c]));
+  }
+}
+
+// a plate with a k by k grid of hexagonal holes.
+static std::vector<std::vector<carve::geom::vector<2> > > plate(int k) {
+  std::vector<std::vector<carve::geom::vector<2> > > poly(1);
+  poly[0].push_back(carve::geom::VECTOR(0.0, 0.0));
+  poly[0].push_back(carve::geom::VECTOR(k * 3.0 + 1.0, 0.0));
+  poly[0].push_back(carve::geom::VECTOR(k * 3.0 + 1.0, k * 3.0 + 1.0));
+  poly[0].push_back(carve::geom::VECTOR(0.0, k * 3.0 + 1.0));
+  for (int i = 0; i < k; ++i) {
+    for (int j = 0; j < k; ++j) {
+      std::vector<carve::geom::vector<2> > hole;
+      for (int t = 0; t < 6; ++t) {
+        double a = -t * M_PI / 3.0;
+        hole.push_back(carve::geom::VECTOR(i * 3.0 + 2.0 + cos(a),
+                                           j * 3.0 + 2.0 + sin(a)));
+      }
+      poly.push_back(hole);
+    }
+  }
+  return poly;
+}
+
+TEST(Triangulate, Holes) {
+  std::vector<std::vector<carve::geom::vector<2> > > poly = plate(6);
+
+  std::vector<carve::geom::vector<2> > points;
+  double expected_area = 0.0;
+  for (size_t i = 0; i < poly.size(); ++i) {
+    points.insert(points.end(), poly[i].begin(), poly[i].end());
+    expected_area += carve::geom2d::signedArea(poly[i]);
+  }
+
+  // the holes of a row share horizontal lines, along which the sweep
+  // may leave zero area triangles.
+  std::vector<carve::triangulate::tri_idx> result;
+  ASSERT_TRUE(carve::triangulate::detail::sweepTriangulate(poly, result));
+  ASSERT_EQ(points.size() + 2 * poly.size() - 4, result.size());
+  checkCover(points, result, expected_area, true);
+
+  carve::triangulate::triangulate(poly, result,
+                                  carve::triangulate::EAR_CLIPPING);
+  ASSERT_EQ(points.size() + 2 * poly.size() - 4, result.size());
+  checkCover(points, result, expected_area);
+}
+
+TEST(Triangulate, IncorporateHoles) {
+  std::vector<std::vector<carve::geom::vector<2> > > poly = plate(8);
+
+  // the sweep itself, rather than incorporateHolesIntoPolygon(), which
+  // would hide a fallback to the incremental search.
+  std::vector<std::pair<size_t, size_t> > loop;
+  std::vector<size_t> holes;
+  for (size_t i = 0; i < poly[0].size(); ++i) {
+    loop.push_back(std::make_pair((size_t)0, i));
+  }
+  for (size_t i = 1; i < poly.size(); ++i) {
+    holes.push_back(i);
+  }
+  ASSERT_TRUE(
+      carve::triangulate::detail::sweepIncorporateHoles(poly, loop, holes));
+
+  // every vertex appears, and each bridge adds two.
+  std::set<std::pair<size_t, size_t> > seen(loop.begin(), loop.end());
+  size_t n = 0;
+  double expected_area = 0.0;
+  for (size_t i = 0; i < poly.size(); ++i) {
+    n += poly[i].size();
+    expected_area += carve::geom2d::signedArea(poly[i]);
+  }
+  ASSERT_EQ(n, seen.size());
+  ASSERT_EQ(n + 2 * (poly.size() - 1), loop.size());
+
+  // the bridged loop must still be triangulable as a simple polygon.
+  std::vector<carve::geom::vector<2> > points;
+  for (size_t i = 0; i < loop.size(); ++i) {
+    points.push_back(poly[loop[i].first][loop[i].second]);
+  }
+  std::vector<carve::triangulate::tri_idx> result;
+  carve::triangulate::triangulate(points, result);
+
+  ASSERT_EQ(points.size() - 2, result.size());
+  checkCover(points, result, expected_area);
+}
+
+static std::vector<std::vector<carve::geom::vector<2> > > testPolygons() {
+  std::vector<std::vector<carve::geom::vector<2> > > polys;
+  polys.push_back(comb(500));
+  polys.push_back(circle(1000));
+  polys.push_back(zigzag(500));
+  polys.push_back(comb(3));
+  polys.push_back(circle(5));
+  return polys;
+}
+
+TEST(Triangulate, ReuseTriangulator) {
+  std::vector<std::vector<carve::geom::vector<2> > > polys = testPolygons();
+  carve::triangulate::TriangulationMethod methods[] = {
+      carve::triangulate::EAR_CLIPPING, carve::triangulate::MONOTONE_SWEEP};
+
+  carve::triangulate::Triangulator triangulator;
+  for (size_t m = 0; m < 2; ++m) {
+    for (size_t i = 0; i < polys.size(); ++i) {
+      std::vector<carve::triangulate::tri_idx> expected, result;
+      carve::triangulate::triangulate(polys[i], expected, methods[m]);
+      triangulator.triangulate(polys[i], result, methods[m]);
+
+      ASSERT_EQ(expected.size(), result.size());
+      for (size_t j = 0; j < result.size(); ++j) {
+        EXPECT_EQ(expected[j].a, result[j].a);
+        EXPECT_EQ(expected[j].b, result[j].b);
+        EXPECT_EQ(expected[j].c, result[j].c);
+      }
+    }
+  }
+}
+
+TEST(Triangulate, TriangulatorSteadyState) {
+  std::vector<std::vector<carve::geom::vector<2> > > polys = testPolygons();
+  carve::triangulate::Triangulator triangulator;
+  std::vector<carve::triangulate::tri_idx> result;
+
+  for (size_t i = 0; i < polys.size(); ++i) {
+    triangulator.triangulate(polys[i], result);
+  }
+
+  size_t before = allocations;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    triangulator.triangulate(polys[i], result);
+  }
+  EXPECT_EQ(before, allocations);
+
+  checkCover(polys.back(), result, carve::geom2d::signedArea(polys.back()));
+}
+
+TEST(Triangulate, TriangleDoesNotAllocate) {
+  std::vector<carve::geom::vector<2> > poly;
+  poly.push_back(carve::geom::VECTOR(0.0, 0.0));
+  poly.push_back(carve::geom::VECTOR(1.0, 0.0));
+  poly.push_back(carve::geom::VECTOR(0.0, 1.0));
+  std::vector<carve::triangulate::tri_idx> result;
+  result.reserve(1);
+
+  size_t before = allocations;
+  carve::triangulate::triangulate(poly, result);
+  EXPECT_EQ(before, allocations);
+  ASSERT_EQ(1U, result.size());
+}
+
+TEST(Triangulate, Improve) {
+  // improving a fan should leave no edge whose flip would shorten it.
+  std::vector<carve::geom::vector<2> > poly = circle(200);
+  std::vector<carve::triangulate::tri_idx> result;
+  for (unsigned i = 1; i + 1 < poly.size(); ++i) {
+    result.push_back(carve::triangulate::tri_idx(0, i, i + 1));
+  }
+
+  carve::triangulate::improve(poly, result);
+
+  ASSERT_EQ(poly.size() - 2, result.size());
+  checkCover(poly, result, carve::geom2d::signedArea(poly));
+
+  std::map<std::pair<unsigned, unsigned>, unsigned> opposite;
+  for (size_t i = 0; i < result.size(); ++i) {
+    for (unsigned j = 0; j < 3; ++j) {
+      std::pair<unsigned, unsigned> e(result[i].v[j], result[i].v[(j + 1) % 3]);
+      ASSERT_EQ(0U, opposite.count(e));
+      opposite[e] = result[i].v[(j + 2) % 3];
+    }
+  }
+  for (std::map<std::pair<unsigned, unsigned>, unsigned>::iterator i =
+           opposite.begin();
+       i != opposite.end(); ++i) {
+    std::pair<unsigned, unsigned> rev(i->first.second, i->first.first);
+    if (!opposite.count(rev)) {
+      continue;
+    }
+    double edge = carve::geom::distance(poly[i->first.first],
+                                        poly[i->first.second]);
+    double diagonal =
+        carve::geom::distance(poly[i->second], poly[opposite[rev]]);
+    EXPECT_LE(edge, diagonal);
+  }
+}